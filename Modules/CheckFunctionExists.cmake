@@ -54,6 +54,26 @@ way the check is run:
 
 include_guard(GLOBAL)
 
+macro(__CHECK_FUNCTION_EXISTS_REPORT _CFE_FUNCTION _CFE_VARIABLE _CFE_QUIET)
+  if(${_CFE_VARIABLE})
+    set(${_CFE_VARIABLE} 1 CACHE INTERNAL "Have function ${_CFE_FUNCTION}")
+    if(NOT "${_CFE_QUIET}")
+      message(CHECK_PASS "found")
+    endif()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the function ${_CFE_FUNCTION} exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT "${_CFE_QUIET}")
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${_CFE_VARIABLE} "" CACHE INTERNAL "Have function ${_CFE_FUNCTION}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the function ${_CFE_FUNCTION} exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endmacro()
+
 macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
   if(NOT DEFINED "${VARIABLE}" OR "x${${VARIABLE}}" STREQUAL "x${VARIABLE}")
     set(MACRO_CHECK_FUNCTION_DEFINITIONS
@@ -89,6 +109,7 @@ macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
       message(FATAL_ERROR "CHECK_FUNCTION_EXISTS needs either C or CXX language enabled")
     endif()
 
+    set(CMAKE_TRY_COMPILE_BATCH_DEFER 1)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${_cfe_source}
@@ -98,24 +119,16 @@ macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
       CMAKE_FLAGS -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_FUNCTION_DEFINITIONS}
       "${CHECK_FUNCTION_EXISTS_ADD_INCLUDES}"
       OUTPUT_VARIABLE OUTPUT)
+    unset(CMAKE_TRY_COMPILE_BATCH_DEFER)
     unset(_cfe_source)
 
-    if(${VARIABLE})
-      set(${VARIABLE} 1 CACHE INTERNAL "Have function ${FUNCTION}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the function ${FUNCTION} exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
+    # A try_compile_batch() defers the result to the end of the batch.
+    if(DEFINED ${VARIABLE})
+      __CHECK_FUNCTION_EXISTS_REPORT("${FUNCTION}" ${VARIABLE} "${CMAKE_REQUIRED_QUIET}")
+    elseif(CMAKE_REQUIRED_QUIET)
+      try_compile_batch(DEFER CALL __CHECK_FUNCTION_EXISTS_REPORT "${FUNCTION}" ${VARIABLE} 1)
     else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have function ${FUNCTION}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the function ${FUNCTION} exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
+      try_compile_batch(DEFER MOVE_CHECK CALL __CHECK_FUNCTION_EXISTS_REPORT "${FUNCTION}" ${VARIABLE} "")
     endif()
   endif()
 endmacro()
@@ -45,6 +45,28 @@ using the ``CXX`` language.
 
 include_guard(GLOBAL)
 
+macro(__CHECK_INCLUDE_FILE_REPORT _CIF_INCLUDE _CIF_VARIABLE _CIF_QUIET)
+  if(${_CIF_VARIABLE})
+    if(NOT "${_CIF_QUIET}")
+      message(CHECK_PASS "found")
+    endif()
+    set(${_CIF_VARIABLE} 1 CACHE INTERNAL "Have include ${_CIF_INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the include file ${_CIF_INCLUDE} "
+      "exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT "${_CIF_QUIET}")
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${_CIF_VARIABLE} "" CACHE INTERNAL "Have include ${_CIF_INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the include file ${_CIF_INCLUDE} "
+      "exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endmacro()
+
 macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
   if(NOT DEFINED "${VARIABLE}")
     if(CMAKE_REQUIRED_INCLUDES)
@@ -92,6 +114,7 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       unset(_CIF_CMP0075)
     endif()
 
+    set(CMAKE_TRY_COMPILE_BATCH_DEFER 1)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFile.c
@@ -102,6 +125,7 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_INCLUDE_FILE_FLAGS}
       "${CHECK_INCLUDE_FILE_C_INCLUDE_DIRS}"
       OUTPUT_VARIABLE OUTPUT)
+    unset(CMAKE_TRY_COMPILE_BATCH_DEFER)
     unset(_CIF_LINK_OPTIONS)
     unset(_CIF_LINK_LIBRARIES)
 
@@ -109,24 +133,13 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       set(CMAKE_C_FLAGS ${CMAKE_C_FLAGS_SAVE})
     endif()
 
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the include file ${INCLUDE} "
-        "exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
+    # A try_compile_batch() defers the result to the end of the batch.
+    if(DEFINED ${VARIABLE})
+      __CHECK_INCLUDE_FILE_REPORT("${INCLUDE}" ${VARIABLE} "${CMAKE_REQUIRED_QUIET}")
+    elseif(CMAKE_REQUIRED_QUIET)
+      try_compile_batch(DEFER CALL __CHECK_INCLUDE_FILE_REPORT "${INCLUDE}" ${VARIABLE} 1)
     else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the include file ${INCLUDE} "
-        "exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
+      try_compile_batch(DEFER MOVE_CHECK CALL __CHECK_INCLUDE_FILE_REPORT "${INCLUDE}" ${VARIABLE} "")
     endif()
   endif()
 endmacro()
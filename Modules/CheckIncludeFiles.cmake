@@ -50,6 +50,28 @@ to check for a single header file in ``C`` or ``CXX`` languages.
 
 include_guard(GLOBAL)
 
+macro(__CHECK_INCLUDE_FILES_REPORT _CIF_INCLUDE _CIF_VARIABLE _CIF_QUIET _CIF_SOURCE)
+  if(${_CIF_VARIABLE})
+    if(NOT "${_CIF_QUIET}")
+      message(CHECK_PASS "found")
+    endif()
+    set(${_CIF_VARIABLE} 1 CACHE INTERNAL "Have include ${_CIF_INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if files ${_CIF_INCLUDE} "
+      "exist passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT "${_CIF_QUIET}")
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${_CIF_VARIABLE} "" CACHE INTERNAL "Have includes ${_CIF_INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if files ${_CIF_INCLUDE} "
+      "exist failed with the following output:\n"
+      "${OUTPUT}\nSource:\n${_CIF_SOURCE}\n")
+  endif()
+endmacro()
+
 macro(CHECK_INCLUDE_FILES INCLUDE VARIABLE)
   if(NOT DEFINED "${VARIABLE}")
     set(CMAKE_CONFIGURABLE_FILE_CONTENT "/* */\n")
@@ -135,6 +157,7 @@ macro(CHECK_INCLUDE_FILES INCLUDE VARIABLE)
     if(NOT CMAKE_REQUIRED_QUIET)
       message(CHECK_START "Looking for ${_description}")
     endif()
+    set(CMAKE_TRY_COMPILE_BATCH_DEFER 1)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${src}
@@ -145,26 +168,19 @@ macro(CHECK_INCLUDE_FILES INCLUDE VARIABLE)
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_INCLUDE_FILES_FLAGS}
       "${CHECK_INCLUDE_FILES_INCLUDE_DIRS}"
       OUTPUT_VARIABLE OUTPUT)
+    unset(CMAKE_TRY_COMPILE_BATCH_DEFER)
     unset(_CIF_LINK_OPTIONS)
     unset(_CIF_LINK_LIBRARIES)
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if files ${INCLUDE} "
-        "exist passed with the following output:\n"
-        "${OUTPUT}\n\n")
+    # A try_compile_batch() defers the result to the end of the batch.
+    if(DEFINED ${VARIABLE})
+      __CHECK_INCLUDE_FILES_REPORT("${INCLUDE}" ${VARIABLE} "${CMAKE_REQUIRED_QUIET}"
+        "${CMAKE_CONFIGURABLE_FILE_CONTENT}")
+    elseif(CMAKE_REQUIRED_QUIET)
+      try_compile_batch(DEFER CALL __CHECK_INCLUDE_FILES_REPORT
+        "${INCLUDE}" ${VARIABLE} 1 "${CMAKE_CONFIGURABLE_FILE_CONTENT}")
     else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have includes ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if files ${INCLUDE} "
-        "exist failed with the following output:\n"
-        "${OUTPUT}\nSource:\n${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
+      try_compile_batch(DEFER MOVE_CHECK CALL __CHECK_INCLUDE_FILES_REPORT
+        "${INCLUDE}" ${VARIABLE} "" "${CMAKE_CONFIGURABLE_FILE_CONTENT}")
     endif()
   endif()
 endmacro()
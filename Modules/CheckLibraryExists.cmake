@@ -42,6 +42,28 @@ the way the check is run:
 
 include_guard(GLOBAL)
 
+macro(__CHECK_LIBRARY_EXISTS_REPORT _CLE_LIBRARY _CLE_FUNCTION _CLE_VARIABLE _CLE_QUIET)
+  if(${_CLE_VARIABLE})
+    if(NOT "${_CLE_QUIET}")
+      message(CHECK_PASS "found")
+    endif()
+    set(${_CLE_VARIABLE} 1 CACHE INTERNAL "Have library ${_CLE_LIBRARY}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the function ${_CLE_FUNCTION} exists in the ${_CLE_LIBRARY} "
+      "passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT "${_CLE_QUIET}")
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${_CLE_VARIABLE} "" CACHE INTERNAL "Have library ${_CLE_LIBRARY}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the function ${_CLE_FUNCTION} exists in the ${_CLE_LIBRARY} "
+      "failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endmacro()
+
 macro(CHECK_LIBRARY_EXISTS LIBRARY FUNCTION LOCATION VARIABLE)
   if(NOT DEFINED "${VARIABLE}")
     set(MACRO_CHECK_LIBRARY_EXISTS_DEFINITION
@@ -69,6 +91,7 @@ macro(CHECK_LIBRARY_EXISTS LIBRARY FUNCTION LOCATION VARIABLE)
       message(FATAL_ERROR "CHECK_FUNCTION_EXISTS needs either C or CXX language enabled")
     endif()
 
+    set(CMAKE_TRY_COMPILE_BATCH_DEFER 1)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${_cle_source}
@@ -79,26 +102,19 @@ macro(CHECK_LIBRARY_EXISTS LIBRARY FUNCTION LOCATION VARIABLE)
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_LIBRARY_EXISTS_DEFINITION}
       -DLINK_DIRECTORIES:STRING=${LOCATION}
       OUTPUT_VARIABLE OUTPUT)
+    unset(CMAKE_TRY_COMPILE_BATCH_DEFER)
     unset(_cle_source)
 
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have library ${LIBRARY}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the function ${FUNCTION} exists in the ${LIBRARY} "
-        "passed with the following output:\n"
-        "${OUTPUT}\n\n")
+    # A try_compile_batch() defers the result to the end of the batch.
+    if(DEFINED ${VARIABLE})
+      __CHECK_LIBRARY_EXISTS_REPORT("${LIBRARY}" "${FUNCTION}" ${VARIABLE}
+        "${CMAKE_REQUIRED_QUIET}")
+    elseif(CMAKE_REQUIRED_QUIET)
+      try_compile_batch(DEFER CALL __CHECK_LIBRARY_EXISTS_REPORT
+        "${LIBRARY}" "${FUNCTION}" ${VARIABLE} 1)
     else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have library ${LIBRARY}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the function ${FUNCTION} exists in the ${LIBRARY} "
-        "failed with the following output:\n"
-        "${OUTPUT}\n\n")
+      try_compile_batch(DEFER MOVE_CHECK CALL __CHECK_LIBRARY_EXISTS_REPORT
+        "${LIBRARY}" "${FUNCTION}" ${VARIABLE} "")
     endif()
   endif()
 endmacro()
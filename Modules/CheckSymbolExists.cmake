@@ -75,6 +75,31 @@ macro(CHECK_SYMBOL_EXISTS SYMBOL FILES VARIABLE)
   endif()
 endmacro()
 
+macro(__CHECK_SYMBOL_EXISTS_REPORT _CSE_SYMBOL _CSE_VARIABLE _CSE_QUIET
+    _CSE_SOURCEFILE _CSE_SOURCE)
+  if(${_CSE_VARIABLE})
+    if(NOT "${_CSE_QUIET}")
+      message(CHECK_PASS "found")
+    endif()
+    set(${_CSE_VARIABLE} 1 CACHE INTERNAL "Have symbol ${_CSE_SYMBOL}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the ${_CSE_SYMBOL} "
+      "exist passed with the following output:\n"
+      "${OUTPUT}\nFile ${_CSE_SOURCEFILE}:\n"
+      "${_CSE_SOURCE}\n")
+  else()
+    if(NOT "${_CSE_QUIET}")
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${_CSE_VARIABLE} "" CACHE INTERNAL "Have symbol ${_CSE_SYMBOL}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the ${_CSE_SYMBOL} "
+      "exist failed with the following output:\n"
+      "${OUTPUT}\nFile ${_CSE_SOURCEFILE}:\n"
+      "${_CSE_SOURCE}\n")
+  endif()
+endmacro()
+
 macro(__CHECK_SYMBOL_EXISTS_IMPL SOURCEFILE SYMBOL FILES VARIABLE)
   if(NOT DEFINED "${VARIABLE}" OR "x${${VARIABLE}}" STREQUAL "x${VARIABLE}")
     set(CMAKE_CONFIGURABLE_FILE_CONTENT "/* */\n")
@@ -130,6 +155,7 @@ int main(int argc, char** argv)
     if(NOT CMAKE_REQUIRED_QUIET)
       message(CHECK_START "Looking for ${SYMBOL}")
     endif()
+    set(CMAKE_TRY_COMPILE_BATCH_DEFER 1)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       "${SOURCEFILE}"
@@ -140,26 +166,19 @@ int main(int argc, char** argv)
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_SYMBOL_EXISTS_FLAGS}
       "${CMAKE_SYMBOL_EXISTS_INCLUDES}"
       OUTPUT_VARIABLE OUTPUT)
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have symbol ${SYMBOL}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the ${SYMBOL} "
-        "exist passed with the following output:\n"
-        "${OUTPUT}\nFile ${SOURCEFILE}:\n"
-        "${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
+    unset(CMAKE_TRY_COMPILE_BATCH_DEFER)
+    # A try_compile_batch() defers the result to the end of the batch.
+    if(DEFINED ${VARIABLE})
+      __CHECK_SYMBOL_EXISTS_REPORT("${SYMBOL}" ${VARIABLE} "${CMAKE_REQUIRED_QUIET}"
+        "${SOURCEFILE}" "${CMAKE_CONFIGURABLE_FILE_CONTENT}")
+    elseif(CMAKE_REQUIRED_QUIET)
+      try_compile_batch(DEFER CALL __CHECK_SYMBOL_EXISTS_REPORT
+        "${SYMBOL}" ${VARIABLE} 1
+        "${SOURCEFILE}" "${CMAKE_CONFIGURABLE_FILE_CONTENT}")
     else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have symbol ${SYMBOL}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the ${SYMBOL} "
-        "exist failed with the following output:\n"
-        "${OUTPUT}\nFile ${SOURCEFILE}:\n"
-        "${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
+      try_compile_batch(DEFER MOVE_CHECK CALL __CHECK_SYMBOL_EXISTS_REPORT
+        "${SYMBOL}" ${VARIABLE} ""
+        "${SOURCEFILE}" "${CMAKE_CONFIGURABLE_FILE_CONTENT}")
     endif()
     unset(CMAKE_CONFIGURABLE_FILE_CONTENT)
   endif()
@@ -7,6 +7,33 @@ cmake_policy(PUSH)
 cmake_policy(SET CMP0054 NEW) # if() quoted variables not dereferenced
 cmake_policy(SET CMP0057 NEW) # if() supports IN_LIST
 
+# Report the result of a check.  A try_compile_batch() may call this at
+# the end of the batch, so the result must replace the variable that
+# try_compile() set in the calling scope.
+function(_CMAKE_CHECK_SOURCE_COMPILES_REPORT _lang_textual _var _quiet _source)
+  if(${_var})
+    set(${_var} 1 CACHE INTERNAL "Test ${_var}")
+    if(NOT _quiet)
+      message(CHECK_PASS "Success")
+    endif()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Performing ${_lang_textual} SOURCE FILE Test ${_var} succeeded with the following output:\n"
+      "${_CHECK_SOURCE_COMPILES_OUTPUT}\n"
+      "Source file was:\n${_source}\n")
+  else()
+    if(NOT _quiet)
+      message(CHECK_FAIL "Failed")
+    endif()
+    set(${_var} "" CACHE INTERNAL "Test ${_var}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Performing ${_lang_textual} SOURCE FILE Test ${_var} failed with the following output:\n"
+      "${_CHECK_SOURCE_COMPILES_OUTPUT}\n"
+      "Source file was:\n${_source}\n")
+  endif()
+  unset(${_var} PARENT_SCOPE)
+  unset(_CHECK_SOURCE_COMPILES_OUTPUT PARENT_SCOPE)
+endfunction()
+
 function(CMAKE_CHECK_SOURCE_COMPILES _lang _source _var)
   if(NOT DEFINED "${_var}")
 
@@ -86,6 +113,10 @@ function(CMAKE_CHECK_SOURCE_COMPILES _lang _source _var)
     if(NOT CMAKE_REQUIRED_QUIET)
       message(CHECK_START "Performing Test ${_var}")
     endif()
+    # The output must be matched right away with a FAIL_REGEX.
+    if(NOT _FAIL_REGEX)
+      set(CMAKE_TRY_COMPILE_BATCH_DEFER 1)
+    endif()
     try_compile(${_var}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/src.${_SRC_EXT}
@@ -94,32 +125,24 @@ function(CMAKE_CHECK_SOURCE_COMPILES _lang _source _var)
       ${CHECK_${LANG}_SOURCE_COMPILES_ADD_LIBRARIES}
       CMAKE_FLAGS -DCOMPILE_DEFINITIONS:STRING=${CMAKE_REQUIRED_FLAGS}
       "${CHECK_${LANG}_SOURCE_COMPILES_ADD_INCLUDES}"
-      OUTPUT_VARIABLE OUTPUT)
+      OUTPUT_VARIABLE _CHECK_SOURCE_COMPILES_OUTPUT)
 
     foreach(_regex ${_FAIL_REGEX})
-      if("${OUTPUT}" MATCHES "${_regex}")
+      if("${_CHECK_SOURCE_COMPILES_OUTPUT}" MATCHES "${_regex}")
         set(${_var} 0)
       endif()
     endforeach()
 
-    if(${_var})
-      set(${_var} 1 CACHE INTERNAL "Test ${_var}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "Success")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Performing ${_lang_textual} SOURCE FILE Test ${_var} succeeded with the following output:\n"
-        "${OUTPUT}\n"
-        "Source file was:\n${_source}\n")
+    # A try_compile_batch() defers the result to the end of the batch.
+    if(DEFINED ${_var})
+      _cmake_check_source_compiles_report("${_lang_textual}" ${_var}
+        "${CMAKE_REQUIRED_QUIET}" "${_source}")
+    elseif(CMAKE_REQUIRED_QUIET)
+      try_compile_batch(DEFER CALL _cmake_check_source_compiles_report
+        "${_lang_textual}" ${_var} 1 "${_source}")
     else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "Failed")
-      endif()
-      set(${_var} "" CACHE INTERNAL "Test ${_var}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Performing ${_lang_textual} SOURCE FILE Test ${_var} failed with the following output:\n"
-        "${OUTPUT}\n"
-        "Source file was:\n${_source}\n")
+      try_compile_batch(DEFER MOVE_CHECK CALL _cmake_check_source_compiles_report
+        "${_lang_textual}" ${_var} "" "${_source}")
     endif()
   endif()
 endfunction()
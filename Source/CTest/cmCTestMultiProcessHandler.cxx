@@ -132,11 +132,28 @@ void cmCTestMultiProcessHandler::RunTests()
 #endif
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
 
+  // Predict how long the run takes when recorded costs are available.
+  bool const predict = this->ParallelLevel > 1 &&
+    this->DefaultEstimatedCost > 0 &&
+    this->CTest->GetScheduleType() != "Random";
+  double const predicted = predict ? this->PredictMakespan() : 0;
+  auto const startTime = std::chrono::steady_clock::now();
+
   uv_loop_init(&this->Loop);
   this->StartNextTests();
   uv_run(&this->Loop, UV_RUN_DEFAULT);
   uv_loop_close(&this->Loop);
 
+  if (predict) {
+    cmDuration const actual = std::chrono::steady_clock::now() - startTime;
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                       "Predicted test time: "
+                         << std::fixed << std::setprecision(2) << predicted
+                         << " sec, actual test time: " << actual.count()
+                         << " sec" << std::endl,
+                       this->Quiet);
+  }
+
   if (!this->StopTimePassed && !this->CheckStopOnFailure()) {
     assert(this->Completed == this->Total);
     assert(this->Tests.empty());
@@ -257,7 +274,8 @@ bool cmCTestMultiProcessHandler::AllocateResources(int index)
   }
 
   std::map<std::string, std::vector<cmCTestBinPackerAllocation>> allocations;
-  if (!this->TryAllocateResources(index, allocations)) {
+  if (!this->TryAllocateResources(index, this->ResourceAllocator,
+                                  allocations)) {
     return false;
   }
 
@@ -278,7 +296,7 @@ bool cmCTestMultiProcessHandler::AllocateResources(int index)
 }
 
 bool cmCTestMultiProcessHandler::TryAllocateResources(
-  int index,
+  int index, cmCTestResourceAllocator const& allocator,
   std::map<std::string, std::vector<cmCTestBinPackerAllocation>>& allocations,
   std::map<std::string, ResourceAllocationError>* errors)
 {
@@ -296,7 +314,7 @@ bool cmCTestMultiProcessHandler::TryAllocateResources(
   }
 
   bool result = true;
-  auto const& availableResources = this->ResourceAllocator.GetResources();
+  auto const& availableResources = allocator.GetResources();
   for (auto& it : allocations) {
     if (!availableResources.count(it.first)) {
       if (errors) {
@@ -361,7 +379,7 @@ void cmCTestMultiProcessHandler::CheckResourcesAvailable()
     for (auto test : this->SortedTests) {
       std::map<std::string, std::vector<cmCTestBinPackerAllocation>>
         allocations;
-      this->TryAllocateResources(test, allocations,
+      this->TryAllocateResources(test, this->ResourceAllocator, allocations,
                                  &this->ResourceAllocationErrors[test]);
     }
   }
@@ -801,11 +819,7 @@ void cmCTestMultiProcessHandler::CreateTestCostList()
 
 void cmCTestMultiProcessHandler::CreateParallelTestCostList()
 {
-  TestSet alreadySortedTests;
-
-  std::list<TestSet> priorityStack;
-  priorityStack.emplace_back();
-  TestSet& topLevel = priorityStack.back();
+  TestList remainingTests;
 
   // In parallel test runs add previously failed tests to the front
   // of the cost list and queue other tests for further sorting
@@ -813,48 +827,198 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
     if (cm::contains(this->LastTestsFailed, this->Properties[t.first]->Name)) {
       // If the test failed last time, it should be run first.
       this->SortedTests.push_back(t.first);
-      alreadySortedTests.insert(t.first);
     } else {
-      topLevel.insert(t.first);
+      remainingTests.push_back(t.first);
     }
   }
 
-  // In parallel test runs repeatedly move dependencies of the tests on
-  // the current dependency level to the next level until no
-  // further dependencies exist.
-  while (!priorityStack.back().empty()) {
-    TestSet& previousSet = priorityStack.back();
-    priorityStack.emplace_back();
-    TestSet& currentSet = priorityStack.back();
+  // Tests without a recorded cost are assumed to take as long as the
+  // average test that has one.
+  double totalCost = 0;
+  std::size_t costCount = 0;
+  for (auto const& t : this->Tests) {
+    if (this->Properties[t.first]->Cost > 0) {
+      totalCost += static_cast<double>(this->Properties[t.first]->Cost);
+      ++costCount;
+    }
+  }
+  this->DefaultEstimatedCost =
+    costCount > 0 ? totalCost / static_cast<double>(costCount) : 0;
 
-    for (auto const& i : previousSet) {
-      TestSet const& dependencies = this->Tests[i];
-      currentSet.insert(dependencies.begin(), dependencies.end());
+  // Rank each test by the longest chain of estimated costs from its start
+  // to the end of the test run through the tests that depend on it.  The
+  // number of tests in that chain breaks ties so that dependencies still
+  // go first when no costs are known.
+  std::map<int, TestSet> dependents;
+  for (auto const& t : this->Tests) {
+    for (int dep : t.second) {
+      dependents[dep].insert(t.first);
     }
+  }
+  std::map<int, TestPriority> priorities;
+  for (auto const& t : this->Tests) {
+    this->ComputeTestPriority(t.first, dependents, priorities);
+  }
+
+  std::stable_sort(
+    remainingTests.begin(), remainingTests.end(), [&](int a, int b) {
+      TestPriority const& pa = priorities[a];
+      TestPriority const& pb = priorities[b];
+      if (pa.CriticalPath != pb.CriticalPath) {
+        return pa.CriticalPath > pb.CriticalPath;
+      }
+      if (pa.Depth != pb.Depth) {
+        return pa.Depth > pb.Depth;
+      }
+      return this->Properties[a]->Cost > this->Properties[b]->Cost;
+    });
+  cm::append(this->SortedTests, remainingTests);
+}
 
-    for (auto const& i : currentSet) {
-      previousSet.erase(i);
+cmCTestMultiProcessHandler::TestPriority const&
+cmCTestMultiProcessHandler::ComputeTestPriority(
+  int test, std::map<int, TestSet> const& dependents,
+  std::map<int, TestPriority>& priorities)
+{
+  auto it = priorities.find(test);
+  if (it != priorities.end()) {
+    return it->second;
+  }
+
+  TestPriority priority;
+  auto d = dependents.find(test);
+  if (d != dependents.end()) {
+    for (int dependent : d->second) {
+      TestPriority const& p =
+        this->ComputeTestPriority(dependent, dependents, priorities);
+      priority.CriticalPath = std::max(priority.CriticalPath, p.CriticalPath);
+      priority.Depth = std::max(priority.Depth, p.Depth);
     }
   }
+  priority.CriticalPath += this->GetEstimatedCost(test);
+  ++priority.Depth;
+  return priorities[test] = priority;
+}
+
+double cmCTestMultiProcessHandler::GetEstimatedCost(int test)
+{
+  float cost = this->Properties[test]->Cost;
+  if (cost > 0) {
+    return static_cast<double>(cost);
+  }
+  // A negative cost only asks for the test to be run late.
+  return cost < 0 ? 0 : this->DefaultEstimatedCost;
+}
 
-  // Remove the empty dependency level
-  priorityStack.pop_back();
+double cmCTestMultiProcessHandler::PredictMakespan()
+{
+  // Replay the scheduling done by StartNextTests using the estimated
+  // costs.  Test load limits and processor affinity are not modeled.
+  std::map<int, std::size_t> order;
+  for (std::size_t i = 0; i < this->SortedTests.size(); ++i) {
+    order[this->SortedTests[i]] = i;
+  }
+  std::map<int, TestSet> dependents;
+  std::map<int, std::size_t> pendingDepends;
+  std::set<std::size_t> ready;
+  for (auto const& t : this->Tests) {
+    std::size_t count = 0;
+    for (int dep : t.second) {
+      if (cm::contains(this->Tests, dep)) {
+        dependents[dep].insert(t.first);
+        ++count;
+      }
+    }
+    pendingDepends[t.first] = count;
+    if (count == 0) {
+      ready.insert(order[t.first]);
+    }
+  }
 
-  // Reverse iterate over the different dependency levels (deepest first).
-  // Sort tests within each level by COST and append them to the cost list.
-  for (TestSet const& currentSet : cmReverseRange(priorityStack)) {
-    TestList sortedCopy;
-    cm::append(sortedCopy, currentSet);
-    std::stable_sort(sortedCopy.begin(), sortedCopy.end(),
-                     TestComparator(this));
+  cmCTestResourceAllocator allocator = this->ResourceAllocator;
+  std::map<int, std::map<std::string, std::vector<cmCTestBinPackerAllocation>>>
+    allocations;
+  std::set<std::string> lockedResources;
+  std::multimap<double, int> running;
+  std::size_t processorsUsed = 0;
+  bool serialTestRunning = false;
+  double now = 0;
+
+  while (!ready.empty() || !running.empty()) {
+    for (auto it = ready.begin();
+         it != ready.end() && !serialTestRunning &&
+         processorsUsed < this->ParallelLevel;) {
+      int test = this->SortedTests[*it];
+      auto const& properties = *this->Properties[test];
+      std::size_t processors = this->GetProcessorsUsed(test);
+      bool canStart = processors <= this->ParallelLevel - processorsUsed &&
+        !(properties.RunSerial && !running.empty());
+      for (std::string const& r : properties.LockedResources) {
+        if (cm::contains(lockedResources, r)) {
+          canStart = false;
+        }
+      }
+      // A test with unsatisfiable resource requirements fails at once.
+      double cost = this->GetEstimatedCost(test);
+      auto errors = this->ResourceAllocationErrors.find(test);
+      if (errors != this->ResourceAllocationErrors.end() &&
+          !errors->second.empty()) {
+        cost = 0;
+      } else if (canStart && this->TestHandler->UseResourceSpec) {
+        auto& testAllocations = allocations[test];
+        canStart =
+          this->TryAllocateResources(test, allocator, testAllocations);
+        if (canStart) {
+          for (auto const& a : testAllocations) {
+            for (auto const& alloc : a.second) {
+              allocator.AllocateResource(a.first, alloc.Id,
+                                         alloc.SlotsNeeded);
+            }
+          }
+        }
+      }
+      if (!canStart) {
+        ++it;
+        continue;
+      }
+      lockedResources.insert(properties.LockedResources.begin(),
+                             properties.LockedResources.end());
+      serialTestRunning = properties.RunSerial;
+      processorsUsed += processors;
+      running.emplace(now + cost, test);
+      it = ready.erase(it);
+    }
 
-    for (auto const& j : sortedCopy) {
-      if (!cm::contains(alreadySortedTests, j)) {
-        this->SortedTests.push_back(j);
-        alreadySortedTests.insert(j);
+    if (running.empty()) {
+      // Nothing can ever start, so the real run could not either.
+      break;
+    }
+    auto next = running.begin();
+    now = next->first;
+    int test = next->second;
+    running.erase(next);
+
+    auto const& properties = *this->Properties[test];
+    for (std::string const& r : properties.LockedResources) {
+      lockedResources.erase(r);
+    }
+    if (properties.RunSerial) {
+      serialTestRunning = false;
+    }
+    processorsUsed -= this->GetProcessorsUsed(test);
+    for (auto const& a : allocations[test]) {
+      for (auto const& alloc : a.second) {
+        allocator.DeallocateResource(a.first, alloc.Id, alloc.SlotsNeeded);
+      }
+    }
+    allocations.erase(test);
+    for (int dependent : dependents[test]) {
+      if (--pendingDepends[dependent] == 0) {
+        ready.insert(order[dependent]);
       }
     }
   }
+  return now;
 }
 
 void cmCTestMultiProcessHandler::GetAllTestDependencies(int test,
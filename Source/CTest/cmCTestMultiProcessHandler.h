@@ -120,6 +120,22 @@ protected:
 
   void CreateParallelTestCostList();
 
+  struct TestPriority
+  {
+    // Longest estimated time from the start of the test to the end of the
+    // run through the tests that depend on it
+    double CriticalPath = 0;
+    // Number of tests in the longest chain of tests depending on it
+    size_t Depth = 0;
+  };
+  TestPriority const& ComputeTestPriority(
+    int test, std::map<int, TestSet> const& dependents,
+    std::map<int, TestPriority>& priorities);
+  // Return the estimated duration of a test in seconds
+  double GetEstimatedCost(int test);
+  // Simulate the run of the remaining tests and return its duration
+  double PredictMakespan();
+
   // Removes the checkpoint file
   void MarkFinished();
   void EraseTest(int index);
@@ -152,7 +168,7 @@ protected:
 
   bool AllocateResources(int index);
   bool TryAllocateResources(
-    int index,
+    int index, cmCTestResourceAllocator const& allocator,
     std::map<std::string, std::vector<cmCTestBinPackerAllocation>>&
       allocations,
     std::map<std::string, ResourceAllocationError>* errors = nullptr);
@@ -187,6 +203,7 @@ protected:
   cmCTestResourceAllocator ResourceAllocator;
   std::vector<cmCTestTestHandler::cmCTestTestResult>* TestResults;
   size_t ParallelLevel; // max number of process that can be run at once
+  double DefaultEstimatedCost = 0;
   unsigned long TestLoad;
   unsigned long FakeLoadForTesting;
   uv_loop_t Loop;
@@ -0,0 +1,112 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmCTestOutputMatcher.h"
+
+void cmCTestOutputMatcher::Reset(RegexList* regexes)
+{
+  this->Regexes = regexes;
+  this->Entries.clear();
+  this->NeedWindow = false;
+  this->WindowAtStart = true;
+  this->Window.clear();
+  if (!regexes) {
+    return;
+  }
+  this->Entries.resize(regexes->size());
+  for (std::size_t i = 0; i < regexes->size(); ++i) {
+    this->Entries[i].Flags = Classify((*regexes)[i].second);
+    if (this->Entries[i].Flags) {
+      this->NeedWindow = true;
+    }
+  }
+}
+
+int cmCTestOutputMatcher::Classify(std::string const& pattern)
+{
+  // Find out conservatively whether the expression could match a newline
+  // or depends on where the output starts or ends.
+  int flags = 0;
+  std::string::size_type const n = pattern.size();
+  for (std::string::size_type i = 0; i < n; ++i) {
+    unsigned char c = static_cast<unsigned char>(pattern[i]);
+    if (c == '\\' && i + 1 < n) {
+      c = static_cast<unsigned char>(pattern[++i]);
+    } else if (c == '.') {
+      flags |= SpansLines;
+    } else if (c == '^') {
+      flags |= AnchoredStart;
+    } else if (c == '$') {
+      flags |= AnchoredEnd;
+    } else if (c == '[') {
+      // A negated bracket expression matches a newline.  A leading ']'
+      // is part of the set.
+      if (i + 1 < n && pattern[i + 1] == '^') {
+        flags |= SpansLines;
+        ++i;
+      }
+      if (i + 1 < n && pattern[i + 1] == ']') {
+        ++i;
+      }
+      while (i + 1 < n && pattern[i + 1] != ']') {
+        if (static_cast<unsigned char>(pattern[++i]) <= '\n') {
+          flags |= SpansLines;
+        }
+      }
+      ++i;
+      continue;
+    }
+    // Control characters up to and including the newline may be matched
+    // literally or begin a range that contains the newline.
+    if (c <= '\n') {
+      flags |= SpansLines;
+    }
+  }
+  return flags;
+}
+
+void cmCTestOutputMatcher::Feed(std::string const& line)
+{
+  if (!this->Regexes) {
+    return;
+  }
+
+  if (this->NeedWindow) {
+    if (this->Window.size() > WindowSize) {
+      this->Window.erase(0, this->Window.size() - WindowSize);
+      this->WindowAtStart = false;
+    }
+    this->Window += line;
+    this->Window += '\n';
+  }
+
+  for (std::size_t i = 0; i < this->Entries.size(); ++i) {
+    Entry& entry = this->Entries[i];
+    cmsys::RegularExpression& regex = (*this->Regexes)[i].first;
+    if (!entry.Flags) {
+      // The match cannot contain a newline, so it lies within one line.
+      if (!entry.Matched) {
+        entry.Matched = regex.find(line);
+      }
+    } else if ((entry.Flags & AnchoredStart) && !this->WindowAtStart) {
+      if (entry.Flags & AnchoredEnd) {
+        entry.Matched = false;
+      }
+    } else if (entry.Flags & AnchoredEnd) {
+      // Only a match at the current end of the output counts.
+      entry.Matched = regex.find(this->Window);
+    } else if (!entry.Matched) {
+      entry.Matched = regex.find(this->Window);
+    }
+  }
+}
+
+cmCTestOutputMatcher::RegexList::value_type const*
+cmCTestOutputMatcher::GetFirstMatch() const
+{
+  for (std::size_t i = 0; i < this->Entries.size(); ++i) {
+    if (this->Entries[i].Matched) {
+      return &(*this->Regexes)[i];
+    }
+  }
+  return nullptr;
+}
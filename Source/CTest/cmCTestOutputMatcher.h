@@ -0,0 +1,66 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cmsys/RegularExpression.hxx"
+
+/** \class cmCTestOutputMatcher
+ * \brief Matches regular expressions against test output as it arrives.
+ *
+ * This is used for TIMEOUT_AFTER_MATCH, which must be checked while
+ * the test runs.  Other expressions are matched against the whole
+ * output when the test ends.
+ *
+ * Output is fed one line at a time.  An expression that cannot match a
+ * newline is matched against each new line alone.  Any other expression
+ * is matched against a sliding window holding the new line and up to
+ * WindowSize bytes of output before it, so a match spanning lines is
+ * found if it fits in the window.  An expression anchored with '^' can
+ * match only while the window still starts at the beginning of the
+ * output, and an expression anchored with '$' reports only whether it
+ * matches at the current end of the output.
+ */
+class cmCTestOutputMatcher
+{
+public:
+  using RegexList =
+    std::vector<std::pair<cmsys::RegularExpression, std::string>>;
+
+  static std::size_t const WindowSize = 4096;
+
+  /** Start matching the given expressions against new output.  */
+  void Reset(RegexList* regexes);
+
+  /** Match the expressions against one more line of output.  */
+  void Feed(std::string const& line);
+
+  /** Return the first expression, in list order, that matched.  */
+  RegexList::value_type const* GetFirstMatch() const;
+
+private:
+  enum Flags
+  {
+    SpansLines = 1,
+    AnchoredStart = 2,
+    AnchoredEnd = 4
+  };
+  struct Entry
+  {
+    int Flags = 0;
+    bool Matched = false;
+  };
+  static int Classify(std::string const& pattern);
+
+  RegexList* Regexes = nullptr;
+  std::vector<Entry> Entries;
+  bool NeedWindow = false;
+  bool WindowAtStart = true;
+  std::string Window;
+};
@@ -2,12 +2,14 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCTestRunTest.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef> // IWYU pragma: keep
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <iomanip>
+#include <ios>
 #include <ratio>
 #include <sstream>
 #include <utility>
@@ -36,32 +38,118 @@ cmCTestRunTest::cmCTestRunTest(cmCTestMultiProcessHandler& multiHandler)
   this->TestResult.Properties = nullptr;
 }
 
+namespace {
+// Call the given function with consecutive chunks of a spilled output file.
+template <typename F>
+void ReadSpilledOutput(std::string const& path, std::size_t length, F f)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  char buffer[64 * 1024];
+  while (fin && length > 0) {
+    fin.read(buffer, static_cast<std::streamsize>(
+                       std::min<std::size_t>(sizeof(buffer), length)));
+    auto const n = static_cast<std::size_t>(fin.gcount());
+    if (n == 0) {
+      break;
+    }
+    f(std::string(buffer, n));
+    length -= n;
+  }
+}
+}
+
 void cmCTestRunTest::CheckOutput(std::string const& line)
 {
   cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
              this->GetIndex() << ": " << line << std::endl);
-  this->ProcessOutput += line;
-  this->ProcessOutput += "\n";
+
+  // Match the line as it arrives instead of searching all output
+  // collected so far again.
+  this->TimeoutMatcher.Feed(line);
+  if (line.find("CTEST_FULL_OUTPUT") != std::string::npos) {
+    this->SawFullOutputRequest = true;
+  }
+
+  // Keep output beyond the in-memory limit in a temporary file.  MemCheck
+  // parses the whole output, so it is always kept in memory.
+  std::size_t const limit = static_cast<std::size_t>(
+    this->TestHandler->CustomMaximumInMemoryTestOutputSize);
+  if (limit > 0 && !this->TestHandler->MemCheck &&
+      this->SpilledOutputPath.empty() &&
+      this->ProcessOutput.size() + line.size() + 1 > limit) {
+    std::string const dir =
+      cmStrCat(this->CTest->GetBinaryDir(), "/Testing/Temporary");
+    this->SpilledOutputPath =
+      cmStrCat(dir, "/TestOutput_", this->Index, ".tmp");
+    cmSystemTools::MakeDirectory(dir);
+    auto spill = cm::make_unique<cmsys::ofstream>(
+      this->SpilledOutputPath.c_str(),
+      std::ios::out | std::ios::binary | std::ios::trunc);
+    if (*spill) {
+      this->SpilledOutput = std::move(spill);
+    }
+  }
+  if (this->SpilledOutput) {
+    *this->SpilledOutput << line << '\n';
+  } else {
+    this->ProcessOutput += line;
+    this->ProcessOutput += "\n";
+  }
 
   // Check for TIMEOUT_AFTER_MATCH property.
-  if (!this->TestProperties->TimeoutRegularExpressions.empty()) {
-    for (auto& reg : this->TestProperties->TimeoutRegularExpressions) {
-      if (reg.first.find(this->ProcessOutput)) {
-        cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                   this->GetIndex()
-                     << ": "
-                     << "Test timeout changed to "
-                     << std::chrono::duration_cast<std::chrono::seconds>(
-                          this->TestProperties->AlternateTimeout)
-                          .count()
-                     << std::endl);
-        this->TestProcess->ResetStartTime();
-        this->TestProcess->ChangeTimeout(
-          this->TestProperties->AlternateTimeout);
-        this->TestProperties->TimeoutRegularExpressions.clear();
-        break;
-      }
+  if (this->TimeoutMatcher.GetFirstMatch()) {
+    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+               this->GetIndex()
+                 << ": "
+                 << "Test timeout changed to "
+                 << std::chrono::duration_cast<std::chrono::seconds>(
+                      this->TestProperties->AlternateTimeout)
+                      .count()
+                 << std::endl);
+    this->TestProcess->ResetStartTime();
+    this->TestProcess->ChangeTimeout(this->TestProperties->AlternateTimeout);
+    this->TestProperties->TimeoutRegularExpressions.clear();
+    this->TimeoutMatcher.Reset(nullptr);
+  }
+}
+
+void cmCTestRunTest::ResetOutput()
+{
+  this->ProcessOutput.clear();
+  this->ClearSpilledOutput();
+  this->SawFullOutputRequest = false;
+  this->TimeoutMatcher.Reset(&this->TestProperties->TimeoutRegularExpressions);
+}
+
+void cmCTestRunTest::LoadSpilledOutput(size_t length)
+{
+  if (!this->SpilledOutput) {
+    return;
+  }
+  this->SpilledOutput->flush();
+
+  // Load everything if the whole output is kept.  Otherwise load just
+  // enough for the truncation to find a character boundary and to know
+  // that more output follows.
+  std::size_t want = static_cast<std::size_t>(-1);
+  if (!this->SawFullOutputRequest && length > 0) {
+    if (length < this->ProcessOutput.size()) {
+      return;
     }
+    want = length - this->ProcessOutput.size() + 4;
+  }
+  ReadSpilledOutput(this->SpilledOutputPath, want,
+                    [this](std::string const& chunk) {
+                      this->ProcessOutput += chunk;
+                    });
+}
+
+void cmCTestRunTest::ClearSpilledOutput()
+{
+  this->SpilledOutput.reset();
+  if (!this->SpilledOutputPath.empty()) {
+    cmSystemTools::RemoveFile(this->SpilledOutputPath);
+    this->SpilledOutputPath.clear();
   }
 }
 
@@ -80,11 +168,27 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   bool forceSkip = false;
   bool skipped = false;
   bool outputTestErrorsToConsole = false;
+  // Match the expressions against the whole output, including any part
+  // that was written to the temporary file.
+  std::string const* matchOutput = &this->ProcessOutput;
+  std::string wholeOutput;
+  if (this->SpilledOutput && this->FailedDependencies.empty() &&
+      (!this->TestProperties->RequiredRegularExpressions.empty() ||
+       !this->TestProperties->ErrorRegularExpressions.empty() ||
+       !this->TestProperties->SkipRegularExpressions.empty())) {
+    this->SpilledOutput->flush();
+    wholeOutput = this->ProcessOutput;
+    ReadSpilledOutput(this->SpilledOutputPath, static_cast<std::size_t>(-1),
+                      [&wholeOutput](std::string const& chunk) {
+                        wholeOutput += chunk;
+                      });
+    matchOutput = &wholeOutput;
+  }
   if (!this->TestProperties->RequiredRegularExpressions.empty() &&
       this->FailedDependencies.empty()) {
     bool found = false;
     for (auto& pass : this->TestProperties->RequiredRegularExpressions) {
-      if (pass.first.find(this->ProcessOutput)) {
+      if (pass.first.find(*matchOutput)) {
         found = true;
         reason = cmStrCat("Required regular expression found. Regex=[",
                           pass.second, ']');
@@ -104,7 +208,7 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   if (!this->TestProperties->ErrorRegularExpressions.empty() &&
       this->FailedDependencies.empty()) {
     for (auto& fail : this->TestProperties->ErrorRegularExpressions) {
-      if (fail.first.find(this->ProcessOutput)) {
+      if (fail.first.find(*matchOutput)) {
         reason = cmStrCat("Error regular expression found in output. Regex=[",
                           fail.second, ']');
         forceFail = true;
@@ -115,7 +219,7 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   if (!this->TestProperties->SkipRegularExpressions.empty() &&
       this->FailedDependencies.empty()) {
     for (auto& skip : this->TestProperties->SkipRegularExpressions) {
-      if (skip.first.find(this->ProcessOutput)) {
+      if (skip.first.find(*matchOutput)) {
         reason = cmStrCat("Skip regular expression found in output. Regex=[",
                           skip.second, ']');
         forceSkip = true;
@@ -222,7 +326,18 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   }
 
   if (outputTestErrorsToConsole) {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, this->ProcessOutput << std::endl);
+    if (this->SpilledOutput) {
+      this->SpilledOutput->flush();
+      cmCTestLog(this->CTest, HANDLER_OUTPUT, this->ProcessOutput);
+      ReadSpilledOutput(this->SpilledOutputPath, static_cast<std::size_t>(-1),
+                        [this](std::string const& chunk) {
+                          cmCTestLog(this->CTest, HANDLER_OUTPUT, chunk);
+                        });
+      cmCTestLog(this->CTest, HANDLER_OUTPUT, std::endl);
+    } else {
+      cmCTestLog(this->CTest, HANDLER_OUTPUT,
+                 this->ProcessOutput << std::endl);
+    }
   }
 
   if (this->TestHandler->LogFile) {
@@ -234,13 +349,14 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   // if this is doing MemCheck then all the output needs to be put into
   // Output since that is what is parsed by cmCTestMemCheckHandler
   if (!this->TestHandler->MemCheck && started) {
-    this->TestHandler->CleanTestOutput(
-      this->ProcessOutput,
-      static_cast<size_t>(
-        this->TestResult.Status == cmCTestTestHandler::COMPLETED
-          ? this->TestHandler->CustomMaximumPassedTestOutputSize
-          : this->TestHandler->CustomMaximumFailedTestOutputSize));
-  }
+    size_t const length = static_cast<size_t>(
+      this->TestResult.Status == cmCTestTestHandler::COMPLETED
+        ? this->TestHandler->CustomMaximumPassedTestOutputSize
+        : this->TestHandler->CustomMaximumFailedTestOutputSize);
+    this->LoadSpilledOutput(length);
+    this->TestHandler->CleanTestOutput(this->ProcessOutput, length);
+  }
+  this->ClearSpilledOutput();
   this->TestResult.Reason = reason;
   if (this->TestHandler->LogFile) {
     bool pass = true;
@@ -418,7 +534,7 @@ void cmCTestRunTest::StartFailure(std::string const& output,
                  << this->TestProperties->Name << std::endl);
   }
 
-  this->ProcessOutput.clear();
+  this->ResetOutput();
   if (!output.empty()) {
     *this->TestHandler->LogFile << output << std::endl;
     cmCTestLog(this->CTest, ERROR_MESSAGE, output << std::endl);
@@ -491,7 +607,7 @@ bool cmCTestRunTest::StartTest(size_t completed, size_t total)
     cmCTestLog(this->CTest, HANDLER_TEST_PROGRESS_OUTPUT, testName);
   }
 
-  this->ProcessOutput.clear();
+  this->ResetOutput();
 
   this->TestResult.Properties = this->TestProperties;
   this->TestResult.ExecutionTime = cmDuration::zero();
@@ -865,8 +981,15 @@ void cmCTestRunTest::WriteLogOutputTop(size_t completed, size_t total)
     << "Output:" << std::endl
     << "----------------------------------------------------------"
     << std::endl;
-  *this->TestHandler->LogFile << this->ProcessOutput << "<end of output>"
-                              << std::endl;
+  *this->TestHandler->LogFile << this->ProcessOutput;
+  if (this->SpilledOutput) {
+    this->SpilledOutput->flush();
+    ReadSpilledOutput(this->SpilledOutputPath, static_cast<std::size_t>(-1),
+                      [this](std::string const& chunk) {
+                        *this->TestHandler->LogFile << chunk;
+                      });
+  }
+  *this->TestHandler->LogFile << "<end of output>" << std::endl;
 
   if (!this->CTest->GetTestProgressOutput()) {
     cmCTestLog(this->CTest, HANDLER_OUTPUT, outputStream.str());
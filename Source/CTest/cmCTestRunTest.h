@@ -12,8 +12,11 @@
 
 #include <stddef.h>
 
+#include "cmsys/FStream.hxx"
+
 #include "cmCTest.h"
 #include "cmCTestMultiProcessHandler.h"
+#include "cmCTestOutputMatcher.h"
 #include "cmCTestTestHandler.h"
 #include "cmDuration.h"
 #include "cmProcess.h"
@@ -115,6 +118,11 @@ private:
                    std::vector<std::string>* environment,
                    std::vector<size_t>* affinity);
   void WriteLogOutputTop(size_t completed, size_t total);
+  // Start collecting and matching the output of a new run
+  void ResetOutput();
+  // Bring back spilled output needed for the test result
+  void LoadSpilledOutput(size_t length);
+  void ClearSpilledOutput();
   // Run post processing of the process output for MemCheck
   void MemCheckPostProcess();
 
@@ -130,6 +138,11 @@ private:
   cmCTest* CTest;
   std::unique_ptr<cmProcess> TestProcess;
   std::string ProcessOutput;
+  // Output beyond the in-memory limit is written to a temporary file
+  std::unique_ptr<cmsys::ofstream> SpilledOutput;
+  std::string SpilledOutputPath;
+  bool SawFullOutputRequest = false;
+  cmCTestOutputMatcher TimeoutMatcher;
   // The test results
   cmCTestTestHandler::cmCTestTestResult TestResult;
   cmCTestMultiProcessHandler& MultiTestHandler;
@@ -296,6 +296,7 @@ cmCTestTestHandler::cmCTestTestHandler()
 
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->CustomMaximumInMemoryTestOutputSize = 64 * 1024 * 1024;
 
   this->MemCheck = false;
 
@@ -324,6 +325,7 @@ void cmCTestTestHandler::Initialize()
   this->CustomPostTest.clear();
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->CustomMaximumInMemoryTestOutputSize = 64 * 1024 * 1024;
 
   this->TestsToRun.clear();
 
@@ -359,6 +361,9 @@ void cmCTestTestHandler::PopulateCustomVectors(cmMakefile* mf)
   this->CTest->PopulateCustomInteger(
     mf, "CTEST_CUSTOM_MAXIMUM_FAILED_TEST_OUTPUT_SIZE",
     this->CustomMaximumFailedTestOutputSize);
+  this->CTest->PopulateCustomInteger(
+    mf, "CTEST_CUSTOM_MAXIMUM_IN_MEMORY_TEST_OUTPUT_SIZE",
+    this->CustomMaximumInMemoryTestOutputSize);
 }
 
 int cmCTestTestHandler::PreProcessHandler()
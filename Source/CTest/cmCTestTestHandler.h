@@ -251,6 +251,7 @@ protected:
   bool MemCheck;
   int CustomMaximumPassedTestOutputSize;
   int CustomMaximumFailedTestOutputSize;
+  int CustomMaximumInMemoryTestOutputSize;
   int MaxIndex;
 
 public:
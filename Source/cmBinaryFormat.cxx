@@ -0,0 +1,181 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmBinaryFormat.h"
+
+#include <ios>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmCryptoHash.h"
+#include "cmFileTime.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+void cmBinaryWriter::U32(std::uint32_t v)
+{
+  for (int i = 0; i < 4; ++i) {
+    this->U8(static_cast<unsigned char>((v >> (8 * i)) & 0xff));
+  }
+}
+
+void cmBinaryWriter::U64(std::uint64_t v)
+{
+  for (int i = 0; i < 8; ++i) {
+    this->U8(static_cast<unsigned char>((v >> (8 * i)) & 0xff));
+  }
+}
+
+void cmBinaryWriter::String(cm::string_view s)
+{
+  this->U32(static_cast<std::uint32_t>(s.size()));
+  this->Bytes(s);
+}
+
+bool cmBinaryReader::Magic(cm::string_view magic)
+{
+  if (this->Data.substr(0, magic.size()) != magic) {
+    return false;
+  }
+  this->Data.remove_prefix(magic.size());
+  return true;
+}
+
+bool cmBinaryReader::U8(unsigned char& v)
+{
+  if (this->Data.empty()) {
+    return false;
+  }
+  v = static_cast<unsigned char>(this->Data[0]);
+  this->Data.remove_prefix(1);
+  return true;
+}
+
+bool cmBinaryReader::U32(std::uint32_t& v)
+{
+  if (this->Data.size() < 4) {
+    return false;
+  }
+  v = 0;
+  for (int i = 0; i < 4; ++i) {
+    v |= static_cast<std::uint32_t>(static_cast<unsigned char>(this->Data[i]))
+      << (8 * i);
+  }
+  this->Data.remove_prefix(4);
+  return true;
+}
+
+bool cmBinaryReader::U64(std::uint64_t& v)
+{
+  if (this->Data.size() < 8) {
+    return false;
+  }
+  v = 0;
+  for (int i = 0; i < 8; ++i) {
+    v |= static_cast<std::uint64_t>(static_cast<unsigned char>(this->Data[i]))
+      << (8 * i);
+  }
+  this->Data.remove_prefix(8);
+  return true;
+}
+
+bool cmBinaryReader::I64(long long& v)
+{
+  std::uint64_t u;
+  if (!this->U64(u)) {
+    return false;
+  }
+  v = static_cast<long long>(u);
+  return true;
+}
+
+bool cmBinaryReader::String(cm::string_view& s)
+{
+  cm::string_view const rest = this->Data;
+  std::uint32_t n;
+  if (!this->U32(n) || !this->Bytes(n, s)) {
+    this->Data = rest;
+    return false;
+  }
+  return true;
+}
+
+bool cmBinaryReader::String(std::string& s)
+{
+  cm::string_view view;
+  if (!this->String(view)) {
+    return false;
+  }
+  s.assign(view.data(), view.size());
+  return true;
+}
+
+bool cmBinaryReader::Bytes(std::size_t n, cm::string_view& s)
+{
+  if (n > this->Data.size()) {
+    return false;
+  }
+  s = this->Data.substr(0, n);
+  this->Data.remove_prefix(n);
+  return true;
+}
+
+bool cmBinaryFileStamp::Load(std::string const& path, bool withHash)
+{
+  cmFileTime mtime;
+  unsigned long long size;
+  if (!mtime.Load(path, size)) {
+    return false;
+  }
+  this->MTime = mtime.GetTime();
+  this->Size = static_cast<long long>(size);
+  if (withHash) {
+    this->Hash = cmSystemTools::ComputeFileHash(path, cmCryptoHash::AlgoMD5);
+    if (this->Hash.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool cmBinaryFileStamp::Matches(std::string const& path) const
+{
+  cmBinaryFileStamp current;
+  return current.Load(path, false) && current.Size == this->Size &&
+    current.MTime == this->MTime && current.Load(path, true) &&
+    current.Hash == this->Hash;
+}
+
+void cmBinaryFileStamp::Write(cmBinaryWriter& w) const
+{
+  w.I64(this->Size);
+  w.I64(this->MTime);
+  w.String(this->Hash);
+}
+
+bool cmBinaryFileStamp::Read(cmBinaryReader& r)
+{
+  return r.I64(this->Size) && r.I64(this->MTime) && r.String(this->Hash);
+}
+
+bool cmStoreBinaryFile(std::string const& path, std::string const& data)
+{
+  std::string const tmpPath = cmStrCat(path, ".tmp");
+  {
+    cmsys::ofstream fout(tmpPath.c_str(),
+                         std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!fout) {
+      return false;
+    }
+    fout.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!fout) {
+      fout.close();
+      cmSystemTools::RemoveFile(tmpPath);
+      return false;
+    }
+  }
+  if (!cmSystemTools::RenameFile(tmpPath, path)) {
+    cmSystemTools::RemoveFile(tmpPath);
+    return false;
+  }
+  return true;
+}
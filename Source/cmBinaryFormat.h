@@ -0,0 +1,90 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <cm/string_view>
+
+/** \class cmBinaryWriter
+ * \brief Encodes values in the little-endian layout of cmBinaryReader.
+ *
+ * Strings are written as a 32-bit length followed by their bytes.
+ */
+class cmBinaryWriter
+{
+public:
+  void U8(unsigned char v) { this->Data += static_cast<char>(v); }
+  void U32(std::uint32_t v);
+  void U64(std::uint64_t v);
+  void I64(long long v) { this->U64(static_cast<std::uint64_t>(v)); }
+  void String(cm::string_view s);
+  void Bytes(cm::string_view s) { this->Data.append(s.data(), s.size()); }
+
+  std::string Data;
+};
+
+/** \class cmBinaryReader
+ * \brief Decodes values written by cmBinaryWriter from a buffer.
+ *
+ * Each method returns false without consuming anything if the rest of
+ * the buffer is too short.  Strings are returned as views of the buffer.
+ */
+class cmBinaryReader
+{
+public:
+  cmBinaryReader(cm::string_view data)
+    : Data(data)
+  {
+  }
+
+  /** Consume the given magic bytes.  Return false if they differ.  */
+  bool Magic(cm::string_view magic);
+
+  bool U8(unsigned char& v);
+  bool U32(std::uint32_t& v);
+  bool U64(std::uint64_t& v);
+  bool I64(long long& v);
+  bool String(cm::string_view& s);
+  bool String(std::string& s);
+  bool Bytes(std::size_t n, cm::string_view& s);
+
+  bool AtEnd() const { return this->Data.empty(); }
+
+private:
+  cm::string_view Data;
+};
+
+/** \class cmBinaryFileStamp
+ * \brief Size, modification time, and content hash of a file.
+ *
+ * Binary files derived from a text file record its stamp so that they
+ * are used only while the text file is unchanged.
+ */
+struct cmBinaryFileStamp
+{
+  long long Size = 0;
+  long long MTime = 0;
+  std::string Hash;
+
+  /** Load the stamp of the given file.  The hash is computed only if
+      requested.  */
+  bool Load(std::string const& path, bool withHash);
+
+  /** Whether the given file still has this stamp.  Compare the cheap
+      properties first and hash the content only if they all match.  */
+  bool Matches(std::string const& path) const;
+
+  void Write(cmBinaryWriter& w) const;
+  bool Read(cmBinaryReader& r);
+};
+
+/**
+ * Write the data to a temporary file and move it into place, so that a
+ * concurrent or interrupted run never observes a partially written file.
+ */
+bool cmStoreBinaryFile(std::string const& path, std::string const& data);
@@ -0,0 +1,131 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmCacheBinaryFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+#include <cm/string_view>
+
+#include "cmBinaryFormat.h"
+#include "cmMappedFile.h"
+
+namespace {
+// Bump the version whenever the file layout changes.
+char const kMagic[4] = { 'C', 'M', 'C', 'B' };
+std::uint32_t const kVersion = 1;
+}
+
+bool cmCacheBinaryFile::Load(std::string const& binaryFile,
+                             std::string const& cacheFile,
+                             std::vector<Entry>& entries)
+{
+  cmMappedFile file;
+  if (!file.Open(binaryFile)) {
+    return false;
+  }
+  cmBinaryReader r(file.View());
+
+  // Validate against the text file.
+  std::uint32_t version;
+  cmBinaryFileStamp recorded;
+  if (!r.Magic(cm::string_view(kMagic, sizeof(kMagic))) || !r.U32(version) ||
+      version != kVersion || !recorded.Read(r) ||
+      !recorded.Matches(cacheFile)) {
+    return false;
+  }
+
+  std::uint32_t stringCount;
+  // Each string takes at least its length field.
+  if (!r.U32(stringCount) || stringCount > file.Size() / 4) {
+    return false;
+  }
+  std::vector<cm::string_view> strings;
+  strings.reserve(stringCount);
+  for (std::uint32_t i = 0; i < stringCount; ++i) {
+    cm::string_view s;
+    if (!r.String(s)) {
+      return false;
+    }
+    strings.push_back(s);
+  }
+
+  // Decode into a temporary so a truncated file leaves no partial result.
+  std::uint32_t entryCount;
+  if (!r.U32(entryCount) || entryCount > file.Size() / 13) {
+    return false;
+  }
+  std::vector<Entry> loaded;
+  loaded.reserve(entryCount);
+  for (std::uint32_t i = 0; i < entryCount; ++i) {
+    std::uint32_t key;
+    unsigned char type;
+    std::uint32_t value;
+    std::uint32_t help;
+    if (!r.U32(key) || key >= stringCount || !r.U8(type) ||
+        type > cmStateEnums::UNINITIALIZED || !r.U32(value) ||
+        value >= stringCount || !r.U32(help) || help >= stringCount) {
+      return false;
+    }
+    loaded.emplace_back();
+    Entry& e = loaded.back();
+    e.Key = std::string(strings[key]);
+    e.Value = std::string(strings[value]);
+    e.HelpString = std::string(strings[help]);
+    e.Type = static_cast<cmStateEnums::CacheEntryType>(type);
+  }
+  if (!r.AtEnd()) {
+    return false;
+  }
+
+  entries = std::move(loaded);
+  return true;
+}
+
+void cmCacheBinaryFile::Store(std::string const& binaryFile,
+                              std::string const& cacheFile,
+                              std::vector<Entry> const& entries)
+{
+  cmBinaryFileStamp stamp;
+  if (!stamp.Load(cacheFile, true)) {
+    return;
+  }
+
+  // Intern the strings.  Help strings and values repeat a lot.
+  std::unordered_map<std::string, std::uint32_t> index;
+  std::vector<std::string const*> strings;
+  auto intern = [&index, &strings](std::string const& s) -> std::uint32_t {
+    auto i = index.emplace(s, static_cast<std::uint32_t>(strings.size()));
+    if (i.second) {
+      strings.push_back(&i.first->first);
+    }
+    return i.first->second;
+  };
+  std::vector<std::uint32_t> records;
+  records.reserve(entries.size() * 3);
+  for (Entry const& e : entries) {
+    records.push_back(intern(e.Key));
+    records.push_back(intern(e.Value));
+    records.push_back(intern(e.HelpString));
+  }
+
+  cmBinaryWriter w;
+  w.Bytes(cm::string_view(kMagic, sizeof(kMagic)));
+  w.U32(kVersion);
+  stamp.Write(w);
+  w.U32(static_cast<std::uint32_t>(strings.size()));
+  for (std::string const* s : strings) {
+    w.String(*s);
+  }
+  w.U32(static_cast<std::uint32_t>(entries.size()));
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    w.U32(records[3 * i]);
+    w.U8(static_cast<unsigned char>(entries[i].Type));
+    w.U32(records[3 * i + 1]);
+    w.U32(records[3 * i + 2]);
+  }
+
+  cmStoreBinaryFile(binaryFile, w.Data);
+}
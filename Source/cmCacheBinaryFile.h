@@ -0,0 +1,45 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+#include "cmStateTypes.h"
+
+/** \class cmCacheBinaryFile
+ * \brief Binary copy of the entries parsed from a CMakeCache.txt file.
+ *
+ * The entries are stored with their strings interned in a table so that
+ * loading them needs no parsing.  The file is memory-mapped when loaded
+ * and used only when the size, modification time, and content hash of
+ * the CMakeCache.txt file match the values recorded when it was stored,
+ * so the text file remains authoritative.
+ */
+class cmCacheBinaryFile
+{
+public:
+  struct Entry
+  {
+    std::string Key;
+    std::string Value;
+    std::string HelpString;
+    cmStateEnums::CacheEntryType Type = cmStateEnums::UNINITIALIZED;
+  };
+
+  /**
+   * @brief Loads the entries stored for the given cache file.
+   * @return true if the binary file is valid for the cache file
+   */
+  static bool Load(std::string const& binaryFile, std::string const& cacheFile,
+                   std::vector<Entry>& entries);
+
+  /**
+   * @brief Stores the entries parsed from the given cache file.
+   */
+  static void Store(std::string const& binaryFile,
+                    std::string const& cacheFile,
+                    std::vector<Entry> const& entries);
+};
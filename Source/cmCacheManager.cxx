@@ -7,10 +7,12 @@
 #include <cstring>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "cmsys/FStream.hxx"
 #include "cmsys/Glob.hxx"
 
+#include "cmCacheBinaryFile.h"
 #include "cmGeneratedFileStream.h"
 #include "cmMessageType.h"
 #include "cmMessenger.h"
@@ -42,78 +44,42 @@ bool cmCacheManager::LoadCache(const std::string& path, bool internal,
     return false;
   }
 
-  cmsys::ifstream fin(cacheFile.c_str());
-  if (!fin) {
+  // Store the entries for the next run only if this is our own cache.
+  std::vector<cmCacheBinaryFile::Entry> entries;
+  if (!cmCacheManager::ReadCacheEntries(path, internal, entries)) {
     return false;
   }
-  const char* realbuffer;
-  std::string buffer;
-  std::string entryKey;
-  unsigned int lineno = 0;
-  while (fin) {
-    // Format is key:type=value
-    std::string helpString;
+
+  for (cmCacheBinaryFile::Entry& entry : entries) {
     CacheEntry e;
-    cmSystemTools::GetLineFromStream(fin, buffer);
-    lineno++;
-    realbuffer = buffer.c_str();
-    while (*realbuffer != '0' &&
-           (*realbuffer == ' ' || *realbuffer == '\t' || *realbuffer == '\r' ||
-            *realbuffer == '\n')) {
-      if (*realbuffer == '\n') {
-        lineno++;
-      }
-      realbuffer++;
-    }
-    // skip blank lines and comment lines
-    if (realbuffer[0] == '#' || realbuffer[0] == 0) {
-      continue;
-    }
-    while (realbuffer[0] == '/' && realbuffer[1] == '/') {
-      if ((realbuffer[2] == '\\') && (realbuffer[3] == 'n')) {
-        helpString += '\n';
-        helpString += &realbuffer[4];
-      } else {
-        helpString += &realbuffer[2];
-      }
-      cmSystemTools::GetLineFromStream(fin, buffer);
-      lineno++;
-      realbuffer = buffer.c_str();
-      if (!fin) {
-        continue;
-      }
-    }
-    e.SetProperty("HELPSTRING", helpString.c_str());
-    if (cmState::ParseCacheEntry(realbuffer, entryKey, e.Value, e.Type)) {
-      if (excludes.find(entryKey) == excludes.end()) {
-        // Load internal values if internal is set.
-        // If the entry is not internal to the cache being loaded
-        // or if it is in the list of internal entries to be
-        // imported, load it.
-        if (internal || (e.Type != cmStateEnums::INTERNAL) ||
-            (includes.find(entryKey) != includes.end())) {
-          // If we are loading the cache from another project,
-          // make all loaded entries internal so that it is
-          // not visible in the gui
-          if (!internal) {
-            e.Type = cmStateEnums::INTERNAL;
-            helpString = cmStrCat("DO NOT EDIT, ", entryKey,
-                                  " loaded from external file.  "
-                                  "To change this value edit this file: ",
-                                  path, "/CMakeCache.txt");
-            e.SetProperty("HELPSTRING", helpString.c_str());
-          }
-          if (!this->ReadPropertyEntry(entryKey, e)) {
-            e.Initialized = true;
-            this->Cache[entryKey] = e;
-          }
+    e.SetProperty("HELPSTRING", entry.HelpString.c_str());
+    e.Value = std::move(entry.Value);
+    e.Type = entry.Type;
+    std::string const& entryKey = entry.Key;
+    if (excludes.find(entryKey) == excludes.end()) {
+      // Load internal values if internal is set.
+      // If the entry is not internal to the cache being loaded
+      // or if it is in the list of internal entries to be
+      // imported, load it.
+      if (internal || (e.Type != cmStateEnums::INTERNAL) ||
+          (includes.find(entryKey) != includes.end())) {
+        // If we are loading the cache from another project,
+        // make all loaded entries internal so that it is
+        // not visible in the gui
+        if (!internal) {
+          e.Type = cmStateEnums::INTERNAL;
+          std::string helpString =
+            cmStrCat("DO NOT EDIT, ", entryKey,
+                     " loaded from external file.  "
+                     "To change this value edit this file: ",
+                     path, "/CMakeCache.txt");
+          e.SetProperty("HELPSTRING", helpString.c_str());
+        }
+        if (!this->ReadPropertyEntry(entryKey, e)) {
+          e.Initialized = true;
+          this->Cache[entryKey] = e;
         }
       }
-    } else {
-      std::ostringstream error;
-      error << "Parse error in cache file " << cacheFile << " on line "
-            << lineno << ". Offending entry: " << realbuffer;
-      cmSystemTools::Error(error.str());
     }
   }
   this->CacheMajorVersion = 0;
@@ -166,6 +132,86 @@ bool cmCacheManager::LoadCache(const std::string& path, bool internal,
   return true;
 }
 
+bool cmCacheManager::ReadCacheEntries(
+  const std::string& path, bool store,
+  std::vector<cmCacheBinaryFile::Entry>& entries)
+{
+  // Use the binary copy of the entries if it is up to date.  Otherwise
+  // parse the text file, and optionally store its entries.
+  std::string const cacheFile = cmStrCat(path, "/CMakeCache.txt");
+  std::string const binaryFile =
+    cmStrCat(path, "/CMakeFiles/CMakeCache.bin");
+  if (cmCacheBinaryFile::Load(binaryFile, cacheFile, entries)) {
+    return true;
+  }
+  bool parseError = false;
+  if (!cmCacheManager::ReadCacheFile(cacheFile, entries, parseError)) {
+    return false;
+  }
+  if (store && !parseError) {
+    cmCacheBinaryFile::Store(binaryFile, cacheFile, entries);
+  }
+  return true;
+}
+
+bool cmCacheManager::ReadCacheFile(
+  const std::string& cacheFile, std::vector<cmCacheBinaryFile::Entry>& entries,
+  bool& parseError)
+{
+  cmsys::ifstream fin(cacheFile.c_str());
+  if (!fin) {
+    return false;
+  }
+  const char* realbuffer;
+  std::string buffer;
+  unsigned int lineno = 0;
+  while (fin) {
+    // Format is key:type=value
+    std::string helpString;
+    cmCacheBinaryFile::Entry e;
+    cmSystemTools::GetLineFromStream(fin, buffer);
+    lineno++;
+    realbuffer = buffer.c_str();
+    while (*realbuffer != '0' &&
+           (*realbuffer == ' ' || *realbuffer == '\t' || *realbuffer == '\r' ||
+            *realbuffer == '\n')) {
+      if (*realbuffer == '\n') {
+        lineno++;
+      }
+      realbuffer++;
+    }
+    // skip blank lines and comment lines
+    if (realbuffer[0] == '#' || realbuffer[0] == 0) {
+      continue;
+    }
+    while (realbuffer[0] == '/' && realbuffer[1] == '/') {
+      if ((realbuffer[2] == '\\') && (realbuffer[3] == 'n')) {
+        helpString += '\n';
+        helpString += &realbuffer[4];
+      } else {
+        helpString += &realbuffer[2];
+      }
+      cmSystemTools::GetLineFromStream(fin, buffer);
+      lineno++;
+      realbuffer = buffer.c_str();
+      if (!fin) {
+        continue;
+      }
+    }
+    if (cmState::ParseCacheEntry(realbuffer, e.Key, e.Value, e.Type)) {
+      e.HelpString = std::move(helpString);
+      entries.push_back(std::move(e));
+    } else {
+      std::ostringstream error;
+      error << "Parse error in cache file " << cacheFile << " on line "
+            << lineno << ". Offending entry: " << realbuffer;
+      cmSystemTools::Error(error.str());
+      parseError = true;
+    }
+  }
+  return true;
+}
+
 const char* cmCacheManager::PersistentProperties[] = { "ADVANCED", "MODIFIED",
                                                        "STRINGS" };
 
@@ -350,6 +396,11 @@ bool cmCacheManager::SaveCache(const std::string& path, cmMessenger* messenger)
   }
   checkCache << "# This file is generated by cmake for dependency checking "
                 "of the CMakeCache.txt file\n";
+
+  // Store the binary copy now so that the next run need not parse the
+  // text file.  It is still valid if the text file did not change.
+  std::vector<cmCacheBinaryFile::Entry> entries;
+  cmCacheManager::ReadCacheEntries(path, true, entries);
   return true;
 }
 
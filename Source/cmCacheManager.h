@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "cmCacheBinaryFile.h"
 #include "cmProperty.h"
 #include "cmPropertyMap.h"
 #include "cmStateTypes.h"
@@ -201,6 +202,16 @@ private:
   static void OutputValueNoNewlines(std::ostream& fout,
                                     std::string const& value);
 
+  //! Read the entries of the CMakeCache.txt file in a directory through
+  //! its binary copy, and optionally store the copy if it is out of date
+  static bool ReadCacheEntries(const std::string& path, bool store,
+                               std::vector<cmCacheBinaryFile::Entry>& entries);
+
+  //! Parse the entries of a CMakeCache.txt file
+  static bool ReadCacheFile(const std::string& cacheFile,
+                            std::vector<cmCacheBinaryFile::Entry>& entries,
+                            bool& parseError);
+
   static const char* PersistentProperties[];
   bool ReadPropertyEntry(const std::string& key, const CacheEntry& e);
   void WritePropertyEntries(std::ostream& os, const std::string& entryKey,
@@ -55,6 +55,35 @@ static std::string const keyVERSION_GREATER_EQUAL = "VERSION_GREATER_EQUAL";
 static std::string const keyVERSION_LESS = "VERSION_LESS";
 static std::string const keyVERSION_LESS_EQUAL = "VERSION_LESS_EQUAL";
 
+// Parse a number as sscanf with "%lg" does.  Plain decimal numbers are
+// converted by strtod directly, which gives the same value without the
+// overhead of sscanf.  Everything else, such as hexadecimal, infinity
+// and NaN spellings, or trailing text, still goes through sscanf
+// because runtime libraries differ in what strtod accepts.
+static bool cmConditionParseNumber(std::string const& str, double& value)
+{
+  char const* c = str.c_str();
+  if (*c == '-' || *c == '+') {
+    ++c;
+  }
+  bool digits = false;
+  bool point = false;
+  for (; *c; ++c) {
+    if (*c >= '0' && *c <= '9') {
+      digits = true;
+    } else if (*c == '.' && !point) {
+      point = true;
+    } else {
+      break;
+    }
+  }
+  if (digits && *c == '\0') {
+    value = std::strtod(str.c_str(), nullptr);
+    return true;
+  }
+  return std::sscanf(str.c_str(), "%lg", &value) == 1;
+}
+
 cmConditionEvaluator::cmConditionEvaluator(cmMakefile& makefile,
                                            cmListFileBacktrace bt)
   : Makefile(makefile)
@@ -583,8 +612,8 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
         double lhs;
         double rhs;
         bool result;
-        if (sscanf(def->c_str(), "%lg", &lhs) != 1 ||
-            sscanf(def2->c_str(), "%lg", &rhs) != 1) {
+        if (!cmConditionParseNumber(*def, lhs) ||
+            !cmConditionParseNumber(*def2, rhs)) {
           result = false;
         } else if (*(argP1) == keyLESS) {
           result = (lhs < rhs);
@@ -4,15 +4,22 @@
 
 #include <cstdio>
 #include <cstring>
+#include <ios>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <utility>
 
+#include <cm/memory>
+#include <cm/string_view>
 #include <cmext/string_view>
 
 #include "cmsys/Directory.hxx"
+#include "cmsys/FStream.hxx"
 
+#include "cmCryptoHash.h"
 #include "cmExportTryCompileFileGenerator.h"
+#include "cmFileTime.h"
 #include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
@@ -20,12 +27,17 @@
 #include "cmPolicies.h"
 #include "cmProperty.h"
 #include "cmState.h"
+#include "cmStateSnapshot.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmTarget.h"
 #include "cmVersion.h"
 #include "cmake.h"
 
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmTryCompileBatch.h"
+#endif
+
 namespace {
 class LanguageStandardState
 {
@@ -217,6 +229,7 @@ std::string const kCMAKE_POSITION_INDEPENDENT_CODE =
 std::string const kCMAKE_SYSROOT = "CMAKE_SYSROOT";
 std::string const kCMAKE_SYSROOT_COMPILE = "CMAKE_SYSROOT_COMPILE";
 std::string const kCMAKE_SYSROOT_LINK = "CMAKE_SYSROOT_LINK";
+std::string const kCMAKE_TRY_COMPILE_CACHE_DIR = "CMAKE_TRY_COMPILE_CACHE_DIR";
 std::string const kCMAKE_TRY_COMPILE_OSX_ARCHITECTURES =
   "CMAKE_TRY_COMPILE_OSX_ARCHITECTURES";
 std::string const kCMAKE_TRY_COMPILE_PLATFORM_VARIABLES =
@@ -229,6 +242,208 @@ std::set<std::string> const ghs_platform_vars{
   "GHS_OS_ROOT",         "GHS_OS_DIR",         "GHS_BSP_NAME",
   "GHS_OS_DIR_OPTION"
 };
+
+/** Results of source file signature try_compile calls, stored in a
+    directory under a hash of everything that goes into the test project.
+    The paths of the binary directory and the random target name are
+    replaced by placeholders so that entries are shared across build
+    trees.  */
+class ResultCache
+{
+public:
+  ResultCache(std::string dir, std::string binaryDirectory,
+              std::string targetName)
+    : Dir(std::move(dir))
+    , BinaryDirectory(std::move(binaryDirectory))
+    , TargetName(std::move(targetName))
+  {
+  }
+
+  void ComputeKey(cmMakefile* mf, std::set<std::string> const& langs,
+                  std::vector<std::string> const& sources,
+                  std::vector<std::string> const& files,
+                  std::vector<std::string> const& cmakeFlags);
+
+  bool Load(int& res, std::string& output) const;
+  void Store(int res, std::string const& output,
+             std::string const& outputFile) const;
+
+private:
+  std::string Normalize(std::string s) const
+  {
+    cmSystemTools::ReplaceString(s, this->BinaryDirectory, "<BINARY_DIR>");
+    cmSystemTools::ReplaceString(s, this->TargetName, "<TARGET_NAME>");
+    return s;
+  }
+  std::string Restore(std::string s) const
+  {
+    cmSystemTools::ReplaceString(s, "<BINARY_DIR>", this->BinaryDirectory);
+    cmSystemTools::ReplaceString(s, "<TARGET_NAME>", this->TargetName);
+    return s;
+  }
+
+  std::string Dir;
+  std::string BinaryDirectory;
+  std::string TargetName;
+  std::string Entry;
+};
+
+bool ReadWholeFile(std::string const& path, std::string& content)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::ostringstream ss;
+  ss << fin.rdbuf();
+  content = ss.str();
+  return true;
+}
+
+bool WriteWholeFile(std::string const& path, std::string const& content)
+{
+  cmsys::ofstream fout(path.c_str(), std::ios::out | std::ios::binary);
+  fout << content;
+  return static_cast<bool>(fout);
+}
+
+void ResultCache::ComputeKey(cmMakefile* mf,
+                             std::set<std::string> const& langs,
+                             std::vector<std::string> const& sources,
+                             std::vector<std::string> const& files,
+                             std::vector<std::string> const& cmakeFlags)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](cm::string_view label, cm::string_view value) {
+    hasher.Append(label);
+    hasher.Append("=");
+    hasher.Append(std::to_string(value.size()));
+    hasher.Append(":");
+    hasher.Append(value);
+    hasher.Append("\n");
+  };
+  auto appendFile = [&](cm::string_view label, std::string const& path,
+                        bool normalize) {
+    std::string content;
+    ReadWholeFile(path, content);
+    append(label, normalize ? this->Normalize(path) : path);
+    append("content", normalize ? this->Normalize(content) : content);
+  };
+
+  append("cmake", cmVersion::GetCMakeVersion());
+  append("generator", mf->GetGlobalGenerator()->GetName());
+  for (char const* var :
+       { "CMAKE_GENERATOR_PLATFORM", "CMAKE_GENERATOR_TOOLSET",
+         "CMAKE_TRY_COMPILE_CONFIGURATION", "CMAKE_SYSROOT",
+         "CMAKE_SYSROOT_COMPILE", "CMAKE_SYSROOT_LINK",
+         "CMAKE_OSX_SYSROOT" }) {
+    append(var, mf->GetSafeDefinition(var));
+  }
+  if (cmProp toolchain = mf->GetDefinition("CMAKE_TOOLCHAIN_FILE")) {
+    appendFile("toolchain", *toolchain, false);
+  }
+
+  // Identify the compilers.  Include the size and time of the compiler
+  // file to notice an update in place.
+  for (std::string const& lang : langs) {
+    for (char const* suffix :
+         { "_COMPILER", "_COMPILER_ID", "_COMPILER_VERSION",
+           "_COMPILER_TARGET", "_COMPILER_ARG1",
+           "_COMPILER_EXTERNAL_TOOLCHAIN", "_SIMULATE_ID" }) {
+      std::string const var = cmStrCat("CMAKE_", lang, suffix);
+      append(var, mf->GetSafeDefinition(var));
+    }
+    std::string const compiler =
+      mf->GetSafeDefinition(cmStrCat("CMAKE_", lang, "_COMPILER"));
+    cmFileTime mtime;
+    if (!compiler.empty() && mtime.Load(compiler)) {
+      append("compiler-stamp",
+             cmStrCat(cmSystemTools::FileLength(compiler), ' ',
+                      mtime.GetTime()));
+    }
+  }
+
+  for (std::string const& file : files) {
+    appendFile("file", file, true);
+  }
+  for (std::string const& source : sources) {
+    appendFile("source", source, true);
+  }
+  for (std::string const& flag : cmakeFlags) {
+    append("flag", this->Normalize(flag));
+  }
+
+  this->Entry = cmStrCat(this->Dir, '/', hasher.FinalizeHex());
+}
+
+bool ResultCache::Load(int& res, std::string& output) const
+{
+  std::string result;
+  if (!ReadWholeFile(cmStrCat(this->Entry, "/result.txt"), result) ||
+      !ReadWholeFile(cmStrCat(this->Entry, "/output.txt"), output)) {
+    return false;
+  }
+  long value;
+  if (!cmStrToLong(result, &value)) {
+    return false;
+  }
+  std::string outputFile;
+  if (ReadWholeFile(cmStrCat(this->Entry, "/output-file.txt"), outputFile) &&
+      !cmSystemTools::CopyFileAlways(cmStrCat(this->Entry, "/output-file"),
+                                     this->Restore(outputFile))) {
+    return false;
+  }
+  res = static_cast<int>(value);
+  output = this->Restore(std::move(output));
+  return true;
+}
+
+void ResultCache::Store(int res, std::string const& output,
+                        std::string const& outputFile) const
+{
+  // Fill a temporary directory and move it into place so that concurrent
+  // runs sharing the cache never observe a partial entry.
+  std::string const tmp =
+    cmStrCat(this->Entry, ".tmp", cmSystemTools::RandomSeed() & 0xFFFFF);
+  if (!cmSystemTools::MakeDirectory(tmp)) {
+    return;
+  }
+  bool ok =
+    WriteWholeFile(cmStrCat(tmp, "/result.txt"), std::to_string(res)) &&
+    WriteWholeFile(cmStrCat(tmp, "/output.txt"), this->Normalize(output));
+  if (ok && res == 0 && !outputFile.empty()) {
+    ok = cmSystemTools::CopyFileAlways(outputFile,
+                                       cmStrCat(tmp, "/output-file")) &&
+      WriteWholeFile(cmStrCat(tmp, "/output-file.txt"),
+                     this->Normalize(outputFile));
+  }
+  if (!ok || !cmSystemTools::RenameFile(tmp, this->Entry)) {
+    cmSystemTools::RemoveADirectory(tmp);
+  }
+}
+
+#if !defined(CMAKE_BOOTSTRAP)
+// Whether the current command runs in a function or macro.  The check
+// commands of modules are functions and macros that use the result of
+// try_compile right away.
+bool InFunctionOrMacro(cmMakefile const* mf)
+{
+  for (cmStateSnapshot snapshot = mf->GetStateSnapshot();
+       snapshot.IsValid(); snapshot = snapshot.GetCallStackParent()) {
+    switch (snapshot.GetType()) {
+      case cmStateEnums::FunctionCallType:
+      case cmStateEnums::MacroCallType:
+        return true;
+      case cmStateEnums::BuildsystemDirectoryType:
+        return false;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+#endif
 }
 
 int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
@@ -236,6 +451,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
 {
   this->BinaryDirectory = argv[1];
   this->OutputFile.clear();
+  this->Deferred = false;
   // which signature were we called with ?
   this->SrcFileSignature = true;
 
@@ -284,6 +500,8 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   bool didCopyFileError = false;
   bool useSources = argv[2] == "SOURCES";
   std::vector<std::string> sources;
+  std::set<std::string> testLangs;
+  std::vector<std::string> generatedFiles;
 
   enum Doing
   {
@@ -437,10 +655,29 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     }
   }
 
+  // Queue the build of a source file signature call in the batch started
+  // by try_compile_batch(BEGIN), if any.  Calls whose result is needed
+  // right away, such as those of try_run, are never deferred.  Functions
+  // and macros opt in when they handle the result in a deferred call.
+  cmTryCompileBatch* batch = nullptr;
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->SrcFileSignature && !isTryRun && cmakeInternal.empty() &&
+      (!InFunctionOrMacro(this->Makefile) ||
+       this->Makefile->IsOn("CMAKE_TRY_COMPILE_BATCH_DEFER"))) {
+    batch = this->Makefile->GetTryCompileBatch();
+  }
+#endif
+  std::string const sharedBinaryDirectory =
+    this->BinaryDirectory + "/CMakeFiles/CMakeTmp";
+
   // compute the binary dir when TRY_COMPILE is called with a src file
   // signature
-  if (this->SrcFileSignature) {
-    this->BinaryDirectory += "/CMakeFiles/CMakeTmp";
+  if (batch) {
+#if !defined(CMAKE_BOOTSTRAP)
+    this->BinaryDirectory = batch->NextBinaryDirectory(this->BinaryDirectory);
+#endif
+  } else if (this->SrcFileSignature) {
+    this->BinaryDirectory = sharedBinaryDirectory;
   } else {
     // only valid for srcfile signatures
     if (!compileDefs.empty()) {
@@ -480,9 +717,21 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       sources.push_back(argv[2]);
     }
 
+    // A later check may overwrite a source it writes to the shared
+    // directory before a deferred build runs, so build a copy of it.
+    if (batch) {
+      for (std::string& si : sources) {
+        if (cmSystemTools::IsSubDirectory(si, sharedBinaryDirectory)) {
+          std::string copy = cmStrCat(this->BinaryDirectory, '/',
+                                      cmSystemTools::GetFilenameName(si));
+          cmSystemTools::CopyFileAlways(si, copy);
+          si = std::move(copy);
+        }
+      }
+    }
+
     // Detect languages to enable.
     cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
-    std::set<std::string> testLangs;
     for (std::string const& si : sources) {
       std::string ext = cmSystemTools::GetFilenameLastExtension(si);
       std::string lang = gg->GetLanguageFromExtension(ext.c_str());
@@ -692,6 +941,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       }
       fprintf(fout, "\ninclude(\"${CMAKE_CURRENT_LIST_DIR}/%s\")\n\n",
               fname.c_str());
+      generatedFiles.push_back(this->BinaryDirectory + fname);
     }
 
     // Forward a set of variables to the inner project cache.
@@ -913,6 +1163,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
               libsToLink.c_str());
     }
     fclose(fout);
+    generatedFiles.push_back(outFileName);
     projectName = "CMAKE_TRY_COMPILE";
   }
 
@@ -926,57 +1177,129 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     }
   }
 
-  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
-  cmSystemTools::ResetErrorOccuredFlag();
-  std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(
-    sourceDirectory, this->BinaryDirectory, projectName, targetName,
-    this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL, &cmakeFlags,
-    output);
-  if (erroroc) {
-    cmSystemTools::SetErrorOccured();
+  // Look for the result of an identical test project in the cache.
+  std::shared_ptr<ResultCache> resultCache;
+  if (this->SrcFileSignature &&
+      !this->Makefile->GetCMakeInstance()->GetDebugTryCompile()) {
+    std::string cacheDir =
+      this->Makefile->GetSafeDefinition(kCMAKE_TRY_COMPILE_CACHE_DIR);
+    if (cacheDir.empty()) {
+      cmSystemTools::GetEnv(kCMAKE_TRY_COMPILE_CACHE_DIR, cacheDir);
+    }
+    if (!cacheDir.empty()) {
+      cacheDir = cmSystemTools::CollapseFullPath(
+        cacheDir, this->Makefile->GetHomeOutputDirectory());
+      if (cmSystemTools::MakeDirectory(cacheDir)) {
+        resultCache = std::make_shared<ResultCache>(
+          std::move(cacheDir), this->BinaryDirectory, targetName);
+        resultCache->ComputeKey(this->Makefile, testLangs, sources,
+                                generatedFiles, cmakeFlags);
+      }
+    }
   }
 
-  // set the result var to the return value to indicate success or failure
-  this->Makefile->AddCacheDefinition(argv[0], (res == 0 ? "TRUE" : "FALSE"),
-                                     "Result of TRY_COMPILE",
-                                     cmStateEnums::INTERNAL);
+  // Everything that depends on the result of the build.  It does not
+  // refer to this command so that it can also finish a deferred build.
+  std::string const resultVariable = argv[0];
+  cmMakefile* const mf = this->Makefile;
+  bool const srcFileSignature = this->SrcFileSignature;
+  std::string const binaryDirectory = this->BinaryDirectory;
+  auto handleResult = [resultVariable, mf, srcFileSignature, binaryDirectory,
+                       targetName, targetType, outputVariable, copyFile,
+                       copyFileError, resultCache](
+                        int res, std::string const& output, bool cacheable,
+                        std::string& outputFile,
+                        std::string& findErrorMessage) -> int {
+    // set the result var to the return value to indicate success or failure
+    mf->AddCacheDefinition(resultVariable, (res == 0 ? "TRUE" : "FALSE"),
+                           "Result of TRY_COMPILE", cmStateEnums::INTERNAL);
+
+    if (!outputVariable.empty()) {
+      mf->AddDefinition(outputVariable, output);
+    }
 
-  if (!outputVariable.empty()) {
-    this->Makefile->AddDefinition(outputVariable, output);
-  }
+    if (srcFileSignature) {
+      std::string copyFileErrorMessage;
+      findErrorMessage.clear();
+      outputFile = cmCoreTryCompile::FindOutputFile(
+        mf, binaryDirectory, targetName, targetType, findErrorMessage);
+      // A failure may be caused by a header or library that is installed
+      // later, which the cache key does not cover, so keep only successes.
+      if (resultCache && cacheable && res == 0) {
+        resultCache->Store(res, output, outputFile);
+      }
 
-  if (this->SrcFileSignature) {
-    std::string copyFileErrorMessage;
-    this->FindOutputFile(targetName, targetType);
-
-    if ((res == 0) && !copyFile.empty()) {
-      if (this->OutputFile.empty() ||
-          !cmSystemTools::CopyFileAlways(this->OutputFile, copyFile)) {
-        std::ostringstream emsg;
-        /* clang-format off */
-        emsg << "Cannot copy output executable\n"
-             << "  '" << this->OutputFile << "'\n"
-             << "to destination specified by COPY_FILE:\n"
-             << "  '" << copyFile << "'\n";
-        /* clang-format on */
-        if (!this->FindErrorMessage.empty()) {
-          emsg << this->FindErrorMessage;
-        }
-        if (copyFileError.empty()) {
-          this->Makefile->IssueMessage(MessageType::FATAL_ERROR, emsg.str());
-          return -1;
+      if ((res == 0) && !copyFile.empty()) {
+        if (outputFile.empty() ||
+            !cmSystemTools::CopyFileAlways(outputFile, copyFile)) {
+          std::ostringstream emsg;
+          /* clang-format off */
+          emsg << "Cannot copy output executable\n"
+               << "  '" << outputFile << "'\n"
+               << "to destination specified by COPY_FILE:\n"
+               << "  '" << copyFile << "'\n";
+          /* clang-format on */
+          if (!findErrorMessage.empty()) {
+            emsg << findErrorMessage;
+          }
+          if (copyFileError.empty()) {
+            mf->IssueMessage(MessageType::FATAL_ERROR, emsg.str());
+            return -1;
+          }
+          copyFileErrorMessage = emsg.str();
         }
-        copyFileErrorMessage = emsg.str();
+      }
+
+      if (!copyFileError.empty()) {
+        mf->AddDefinition(copyFileError, copyFileErrorMessage);
       }
     }
+    return res;
+  };
 
-    if (!copyFileError.empty()) {
-      this->Makefile->AddDefinition(copyFileError, copyFileErrorMessage);
+  std::string output;
+  int res;
+  bool const cached = resultCache && resultCache->Load(res, output);
+#if !defined(CMAKE_BOOTSTRAP)
+  // In a batch, report reused results at the end too, in call order.
+  if (batch) {
+    auto finish = [handleResult](int result, std::string const& out,
+                                 bool clean) {
+      std::string outputFile;
+      std::string findErrorMessage;
+      handleResult(result, out, clean, outputFile, findErrorMessage);
+    };
+    if (cached) {
+      batch->AddResult(this->BinaryDirectory, res, std::move(output),
+                       std::move(finish));
+    } else {
+      batch->Add(sourceDirectory, this->BinaryDirectory, projectName,
+                 targetName, cmakeFlags, std::move(finish));
+    }
+    this->Deferred = true;
+    return 0;
+  }
+#endif
+  bool cacheable = false;
+  if (!cached) {
+    bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+    cmSystemTools::ResetErrorOccuredFlag();
+    // actually do the try compile now that everything is setup
+    res = this->Makefile->TryCompile(
+      sourceDirectory, this->BinaryDirectory, projectName, targetName,
+      this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL, &cmakeFlags,
+      output);
+    // Errors reported while configuring the test project are not part of
+    // the result, so do not cache it.
+    cacheable = !cmSystemTools::GetErrorOccuredFlag() &&
+      !cmSystemTools::GetFatalErrorOccured();
+    if (erroroc) {
+      cmSystemTools::SetErrorOccured();
     }
   }
-  return res;
+
+  return handleResult(res, output, cacheable, this->OutputFile,
+                      this->FindErrorMessage);
 }
 
 void cmCoreTryCompile::CleanupFiles(std::string const& binDir)
@@ -1037,19 +1360,25 @@ void cmCoreTryCompile::FindOutputFile(const std::string& targetName,
                                       cmStateEnums::TargetType targetType)
 {
   this->FindErrorMessage.clear();
-  this->OutputFile.clear();
+  this->OutputFile =
+    FindOutputFile(this->Makefile, this->BinaryDirectory, targetName,
+                   targetType, this->FindErrorMessage);
+}
+
+std::string cmCoreTryCompile::FindOutputFile(
+  cmMakefile* mf, std::string const& binaryDirectory,
+  std::string const& targetName, cmStateEnums::TargetType targetType,
+  std::string& errorMessage)
+{
   std::string tmpOutputFile = "/";
   if (targetType == cmStateEnums::EXECUTABLE) {
     tmpOutputFile += targetName;
-    tmpOutputFile +=
-      this->Makefile->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
+    tmpOutputFile += mf->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
   } else // if (targetType == cmStateEnums::STATIC_LIBRARY)
   {
-    tmpOutputFile +=
-      this->Makefile->GetSafeDefinition("CMAKE_STATIC_LIBRARY_PREFIX");
+    tmpOutputFile += mf->GetSafeDefinition("CMAKE_STATIC_LIBRARY_PREFIX");
     tmpOutputFile += targetName;
-    tmpOutputFile +=
-      this->Makefile->GetSafeDefinition("CMAKE_STATIC_LIBRARY_SUFFIX");
+    tmpOutputFile += mf->GetSafeDefinition("CMAKE_STATIC_LIBRARY_SUFFIX");
   }
 
   // a list of directories where to search for the compilation result
@@ -1057,8 +1386,7 @@ void cmCoreTryCompile::FindOutputFile(const std::string& targetName,
   std::vector<std::string> searchDirs;
   searchDirs.emplace_back();
 
-  cmProp config =
-    this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+  cmProp config = mf->GetDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
   // if a config was specified try that first
   if (cmNonempty(config)) {
     std::string tmp = cmStrCat('/', *config);
@@ -1078,16 +1406,16 @@ void cmCoreTryCompile::FindOutputFile(const std::string& targetName,
   searchDirs.emplace_back("/Development");
 
   for (std::string const& sdir : searchDirs) {
-    std::string command = cmStrCat(this->BinaryDirectory, sdir, tmpOutputFile);
+    std::string command = cmStrCat(binaryDirectory, sdir, tmpOutputFile);
     if (cmSystemTools::FileExists(command)) {
-      this->OutputFile = cmSystemTools::CollapseFullPath(command);
-      return;
+      return cmSystemTools::CollapseFullPath(command);
     }
   }
 
   std::ostringstream emsg;
   emsg << "Unable to find the executable at any of:\n";
-  emsg << cmWrap("  " + this->BinaryDirectory, searchDirs, tmpOutputFile, "\n")
+  emsg << cmWrap("  " + binaryDirectory, searchDirs, tmpOutputFile, "\n")
        << "\n";
-  this->FindErrorMessage = emsg.str();
+  errorMessage = emsg.str();
+  return std::string();
 }
@@ -10,6 +10,8 @@
 #include "cmCommand.h"
 #include "cmStateTypes.h"
 
+class cmMakefile;
+
 /** \class cmCoreTryCompile
  * \brief Base class for cmTryCompileCommand and cmTryRunCommand
  *
@@ -42,8 +44,20 @@ protected:
   void FindOutputFile(const std::string& targetName,
                       cmStateEnums::TargetType targetType);
 
+  /**
+   * Return the file created by the test project in the given binary
+   * directory, or an empty string and the reason in errorMessage.
+   */
+  static std::string FindOutputFile(cmMakefile* mf,
+                                    std::string const& binaryDirectory,
+                                    std::string const& targetName,
+                                    cmStateEnums::TargetType targetType,
+                                    std::string& errorMessage);
+
   std::string BinaryDirectory;
   std::string OutputFile;
   std::string FindErrorMessage;
   bool SrcFileSignature = false;
+  // The build was queued in a try_compile_batch and the batch cleans up
+  bool Deferred = false;
 };
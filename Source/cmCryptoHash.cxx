@@ -2,6 +2,10 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCryptoHash.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 #include <cm/memory>
 
 #include <cm3p/kwiml/int.h>
@@ -20,7 +24,143 @@ static unsigned int const cmCryptoHashAlgoToId[] = {
   RHASH_SHA3_224, //
   RHASH_SHA3_256, //
   RHASH_SHA3_384, //
-  RHASH_SHA3_512
+  RHASH_SHA3_512, //
+  0               // AlgoXXH64 is implemented below
+};
+
+namespace {
+
+// The XXH64 algorithm by Yann Collet, see
+// https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+std::uint64_t const XXH64Prime1 = 0x9E3779B185EBCA87ULL;
+std::uint64_t const XXH64Prime2 = 0xC2B2AE3D27D4EB4FULL;
+std::uint64_t const XXH64Prime3 = 0x165667B19E3779F9ULL;
+std::uint64_t const XXH64Prime4 = 0x85EBCA77C2B2AE63ULL;
+std::uint64_t const XXH64Prime5 = 0x27D4EB2F165667C5ULL;
+
+std::uint64_t XXH64RotateLeft(std::uint64_t value, int bits)
+{
+  return (value << bits) | (value >> (64 - bits));
+}
+
+std::uint64_t XXH64Read64(unsigned char const* p)
+{
+  return static_cast<std::uint64_t>(p[0]) |
+    (static_cast<std::uint64_t>(p[1]) << 8) |
+    (static_cast<std::uint64_t>(p[2]) << 16) |
+    (static_cast<std::uint64_t>(p[3]) << 24) |
+    (static_cast<std::uint64_t>(p[4]) << 32) |
+    (static_cast<std::uint64_t>(p[5]) << 40) |
+    (static_cast<std::uint64_t>(p[6]) << 48) |
+    (static_cast<std::uint64_t>(p[7]) << 56);
+}
+
+std::uint64_t XXH64Read32(unsigned char const* p)
+{
+  return static_cast<std::uint64_t>(p[0]) |
+    (static_cast<std::uint64_t>(p[1]) << 8) |
+    (static_cast<std::uint64_t>(p[2]) << 16) |
+    (static_cast<std::uint64_t>(p[3]) << 24);
+}
+
+std::uint64_t XXH64Round(std::uint64_t acc, std::uint64_t input)
+{
+  acc += input * XXH64Prime2;
+  return XXH64RotateLeft(acc, 31) * XXH64Prime1;
+}
+
+std::uint64_t XXH64MergeRound(std::uint64_t acc, std::uint64_t value)
+{
+  acc ^= XXH64Round(0, value);
+  return acc * XXH64Prime1 + XXH64Prime4;
+}
+
+} // anonymous namespace
+
+struct cmCryptoHash::XXH64State
+{
+  std::uint64_t Acc[4];
+  std::uint64_t TotalLength;
+  unsigned char Stripe[32];
+  std::size_t StripeSize;
+
+  void Reset()
+  {
+    this->Acc[0] = XXH64Prime1 + XXH64Prime2;
+    this->Acc[1] = XXH64Prime2;
+    this->Acc[2] = 0;
+    this->Acc[3] = 0 - XXH64Prime1;
+    this->TotalLength = 0;
+    this->StripeSize = 0;
+  }
+
+  void Consume(unsigned char const* stripe)
+  {
+    for (int i = 0; i < 4; ++i) {
+      this->Acc[i] = XXH64Round(this->Acc[i], XXH64Read64(stripe + i * 8));
+    }
+  }
+
+  void Update(unsigned char const* p, std::size_t size)
+  {
+    this->TotalLength += size;
+    if (this->StripeSize > 0) {
+      std::size_t const fill = std::min(size, 32 - this->StripeSize);
+      std::memcpy(this->Stripe + this->StripeSize, p, fill);
+      this->StripeSize += fill;
+      p += fill;
+      size -= fill;
+      if (this->StripeSize < 32) {
+        return;
+      }
+      this->Consume(this->Stripe);
+      this->StripeSize = 0;
+    }
+    for (; size >= 32; p += 32, size -= 32) {
+      this->Consume(p);
+    }
+    std::memcpy(this->Stripe, p, size);
+    this->StripeSize = size;
+  }
+
+  std::uint64_t Digest() const
+  {
+    std::uint64_t h;
+    if (this->TotalLength >= 32) {
+      h = XXH64RotateLeft(this->Acc[0], 1) +
+        XXH64RotateLeft(this->Acc[1], 7) + XXH64RotateLeft(this->Acc[2], 12) +
+        XXH64RotateLeft(this->Acc[3], 18);
+      for (std::uint64_t acc : this->Acc) {
+        h = XXH64MergeRound(h, acc);
+      }
+    } else {
+      h = XXH64Prime5;
+    }
+    h += this->TotalLength;
+
+    unsigned char const* p = this->Stripe;
+    unsigned char const* const end = this->Stripe + this->StripeSize;
+    for (; end - p >= 8; p += 8) {
+      h ^= XXH64Round(0, XXH64Read64(p));
+      h = XXH64RotateLeft(h, 27) * XXH64Prime1 + XXH64Prime4;
+    }
+    if (end - p >= 4) {
+      h ^= XXH64Read32(p) * XXH64Prime1;
+      h = XXH64RotateLeft(h, 23) * XXH64Prime2 + XXH64Prime3;
+      p += 4;
+    }
+    for (; p != end; ++p) {
+      h ^= static_cast<std::uint64_t>(*p) * XXH64Prime5;
+      h = XXH64RotateLeft(h, 11) * XXH64Prime1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH64Prime2;
+    h ^= h >> 29;
+    h *= XXH64Prime3;
+    h ^= h >> 32;
+    return h;
+  }
 };
 
 static int cmCryptoHash_rhash_library_initialized;
@@ -36,13 +176,21 @@ static rhash cmCryptoHash_rhash_init(unsigned int id)
 
 cmCryptoHash::cmCryptoHash(Algo algo)
   : Id(cmCryptoHashAlgoToId[algo])
-  , CTX(cmCryptoHash_rhash_init(this->Id))
+  , CTX(nullptr)
 {
+  if (algo == AlgoXXH64) {
+    this->XXH64 = cm::make_unique<XXH64State>();
+    this->XXH64->Reset();
+  } else {
+    this->CTX = cmCryptoHash_rhash_init(this->Id);
+  }
 }
 
 cmCryptoHash::~cmCryptoHash()
 {
-  rhash_free(this->CTX);
+  if (this->CTX) {
+    rhash_free(this->CTX);
+  }
 }
 
 std::unique_ptr<cmCryptoHash> cmCryptoHash::New(cm::string_view algo)
@@ -166,21 +314,38 @@ std::string cmCryptoHash::HashFile(const std::string& file)
 
 void cmCryptoHash::Initialize()
 {
+  if (this->XXH64) {
+    this->XXH64->Reset();
+    return;
+  }
   rhash_reset(this->CTX);
 }
 
 void cmCryptoHash::Append(void const* buf, size_t sz)
 {
+  if (this->XXH64) {
+    this->XXH64->Update(static_cast<unsigned char const*>(buf), sz);
+    return;
+  }
   rhash_update(this->CTX, buf, sz);
 }
 
 void cmCryptoHash::Append(cm::string_view input)
 {
-  rhash_update(this->CTX, input.data(), input.size());
+  this->Append(input.data(), input.size());
 }
 
 std::vector<unsigned char> cmCryptoHash::Finalize()
 {
+  if (this->XXH64) {
+    // Use the canonical big-endian representation.
+    std::uint64_t const digest = this->XXH64->Digest();
+    std::vector<unsigned char> hash(8, 0);
+    for (int i = 0; i < 8; ++i) {
+      hash[i] = static_cast<unsigned char>(digest >> (56 - i * 8));
+    }
+    return hash;
+  }
   std::vector<unsigned char> hash(rhash_get_digest_size(this->Id), 0);
   rhash_final(this->CTX, &hash[0]);
   return hash;
@@ -13,6 +13,9 @@
 
 /**
  * @brief Abstract base class for cryptographic hash generators
+ *
+ * AlgoXXH64 is a fast non-cryptographic hash to detect changed content.
+ * It is not available by name through New().
  */
 class cmCryptoHash
 {
@@ -28,7 +31,8 @@ public:
     AlgoSHA3_224,
     AlgoSHA3_256,
     AlgoSHA3_384,
-    AlgoSHA3_512
+    AlgoSHA3_512,
+    AlgoXXH64
   };
 
   cmCryptoHash(Algo algo);
@@ -81,6 +85,9 @@ public:
   std::string FinalizeHex();
 
 private:
+  struct XXH64State;
+
   unsigned int Id;
   struct rhash_context* CTX;
+  std::unique_ptr<XXH64State> XXH64;
 };
@@ -9,15 +9,53 @@
 
 #include <cm/string_view>
 
+#include "cmPlainList.h"
+
 cmDefinitions::Def cmDefinitions::NoDef;
 
-cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
+cmDefinitions::Def const& cmDefinitions::GetInternal(Key const& key,
                                                      StackIter begin,
                                                      StackIter end, bool raise)
 {
   assert(begin != end);
+  if (!raise) {
+    {
+      auto it = begin->Map.find(key);
+      if (it != begin->Map.end()) {
+        return it->second;
+      }
+    }
+    if (!begin->Lookups.empty()) {
+      auto it = begin->Lookups.find(key);
+      if (it != begin->Lookups.end()) {
+        return it->second;
+      }
+    }
+    // Search the parent scopes.  They do not change while this scope
+    // exists (raising a definition localizes it here first), so remember
+    // what was found far away.
+    std::size_t depth = 0;
+    Def const* def = &cmDefinitions::NoDef;
+    StackIter it = begin;
+    for (++it; it != end; ++it, ++depth) {
+      if (!it->Map.empty()) {
+        auto i = it->Map.find(key);
+        if (i != it->Map.end()) {
+          def = &i->second;
+          break;
+        }
+      }
+    }
+    if (depth < cmDefinitions::LookupDepth) {
+      return *def;
+    }
+    // The key may borrow the name.
+    return begin->Lookups
+      .emplace(Key(cm::String(key.Name.view()), key.Hash), *def)
+      .first->second;
+  }
   {
-    auto it = begin->Map.find(cm::String::borrow(key));
+    auto it = begin->Map.find(key);
     if (it != begin->Map.end()) {
       return it->second;
     }
@@ -28,30 +66,45 @@ cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
     return cmDefinitions::NoDef;
   }
   Def const& def = cmDefinitions::GetInternal(key, it, end, raise);
-  if (!raise) {
-    return def;
-  }
-  return begin->Map.emplace(key, def).first->second;
+  // The key may borrow the name.
+  return begin->Map.emplace(Key(cm::String(key.Name.view()), key.Hash), def)
+    .first->second;
 }
 
 const std::string* cmDefinitions::Get(const std::string& key, StackIter begin,
                                       StackIter end)
 {
-  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
+  Def const& def = cmDefinitions::GetInternal(
+    Key(cm::String::borrow(key)), begin, end, false);
   return def.Value ? def.Value.str_if_stable() : nullptr;
 }
 
+cmPlainList const* cmDefinitions::GetList(const std::string& key,
+                                          StackIter begin, StackIter end)
+{
+  Def const& def = cmDefinitions::GetInternal(
+    Key(cm::String::borrow(key)), begin, end, false);
+  if (!def.Value) {
+    return nullptr;
+  }
+  if (!def.List) {
+    def.List = std::make_shared<cmPlainList>(def.Value.view());
+  }
+  return def.List->IsPlain() ? def.List.get() : nullptr;
+}
+
 void cmDefinitions::Raise(const std::string& key, StackIter begin,
                           StackIter end)
 {
-  cmDefinitions::GetInternal(key, begin, end, true);
+  cmDefinitions::GetInternal(Key(cm::String::borrow(key)), begin, end, true);
 }
 
 bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
                            StackIter end)
 {
+  Key const k(cm::String::borrow(key));
   for (StackIter it = begin; it != end; ++it) {
-    if (it->Map.find(cm::String::borrow(key)) != it->Map.end()) {
+    if (!it->Map.empty() && it->Map.find(k) != it->Map.end()) {
       return true;
     }
   }
@@ -67,11 +120,11 @@ cmDefinitions cmDefinitions::MakeClosure(StackIter begin, StackIter end)
     for (auto const& mi : it->Map) {
       // Use this key if it is not already set or unset.
       if (closure.Map.find(mi.first) == closure.Map.end() &&
-          undefined.find(mi.first.view()) == undefined.end()) {
+          undefined.find(mi.first.Name.view()) == undefined.end()) {
         if (mi.second.Value) {
           closure.Map.insert(mi);
         } else {
-          undefined.emplace(mi.first.view());
+          undefined.emplace(mi.first.Name.view());
         }
       }
     }
@@ -89,8 +142,8 @@ std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
     defined.reserve(defined.size() + it->Map.size());
     for (auto const& mi : it->Map) {
       // Use this key if it is not already set or unset.
-      if (bound.emplace(mi.first.view()).second && mi.second.Value) {
-        defined.push_back(*mi.first.str_if_stable());
+      if (bound.emplace(mi.first.Name.view()).second && mi.second.Value) {
+        defined.push_back(*mi.first.Name.str_if_stable());
       }
     }
   }
@@ -100,10 +153,34 @@ std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
 
 void cmDefinitions::Set(const std::string& key, cm::string_view value)
 {
-  this->Map[key] = Def(value);
+  this->Map[cm::String(key)] = Def(value);
+}
+
+void cmDefinitions::Append(const std::string& key, cm::string_view current,
+                           cm::string_view suffix)
+{
+  auto it = this->Map.find(Key(cm::String::borrow(key)));
+  if (it == this->Map.end() || !it->second.Value) {
+    std::string value;
+    value.reserve(current.size() + suffix.size());
+    value.append(current.data(), current.size());
+    value.append(suffix.data(), suffix.size());
+    this->Map[cm::String(key)] = Def(value);
+    return;
+  }
+
+  // Extend the value and its elements in place unless they are shared
+  // with other scopes.
+  Def& def = it->second;
+  def.Value += suffix;
+  if (def.List && def.List.use_count() == 1) {
+    def.List->Append(def.Value.view());
+  } else {
+    def.List.reset();
+  }
 }
 
 void cmDefinitions::Unset(const std::string& key)
 {
-  this->Map[key] = Def();
+  this->Map[cm::String(key)] = Def();
 }
@@ -4,9 +4,12 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <cm/string_view>
@@ -14,12 +17,15 @@
 #include "cmLinkedTree.h"
 #include "cmString.hxx"
 
+class cmPlainList;
+
 /** \class cmDefinitions
  * \brief Store a scope of variable definitions for CMake language.
  *
  * This stores the state of variable definitions (set or unset) for
  * one scope.  Sets are always local.  Gets search parent scopes
- * transitively and save results locally.
+ * transitively, hashing the variable name only once, and save results
+ * found far away locally.
  */
 class cmDefinitions
 {
@@ -31,6 +37,10 @@ public:
   static const std::string* Get(const std::string& key, StackIter begin,
                                 StackIter end);
 
+  /** Return the elements of a value that is a plain list, or nullptr.  */
+  static cmPlainList const* GetList(const std::string& key, StackIter begin,
+                                    StackIter end);
+
   static void Raise(const std::string& key, StackIter begin, StackIter end);
 
   static bool HasKey(const std::string& key, StackIter begin, StackIter end);
@@ -44,6 +54,13 @@ public:
   /** Set a value associated with a key.  */
   void Set(const std::string& key, cm::string_view value);
 
+  /**
+   * Append a suffix to the value associated with a key.  If the key has
+   * no local definition it is set to the current value with the suffix.
+   */
+  void Append(const std::string& key, cm::string_view current,
+              cm::string_view suffix);
+
   /** Unset a definition.  */
   void Unset(const std::string& key);
 
@@ -58,11 +75,44 @@ private:
     {
     }
     cm::String Value;
+    /** Elements of Value, split on first use as a list.  */
+    mutable std::shared_ptr<cmPlainList> List;
   };
   static Def NoDef;
 
-  std::unordered_map<cm::String, Def> Map;
+  /** Variable name with its hash, computed once for lookups in all
+      scopes.  */
+  struct Key
+  {
+    Key(cm::String name)
+      : Name(std::move(name))
+      , Hash(std::hash<cm::String>()(this->Name))
+    {
+    }
+    Key(cm::String name, std::size_t hash)
+      : Name(std::move(name))
+      , Hash(hash)
+    {
+    }
+    bool operator==(Key const& other) const
+    {
+      return this->Hash == other.Hash && this->Name == other.Name;
+    }
+    cm::String Name;
+    std::size_t Hash;
+  };
+  struct KeyHash
+  {
+    std::size_t operator()(Key const& key) const { return key.Hash; }
+  };
+
+  std::unordered_map<Key, Def, KeyHash> Map;
+
+  /** Definitions found in parent scopes at least LookupDepth scopes
+      away, or not found at all.  */
+  std::unordered_map<Key, Def, KeyHash> Lookups;
+  static std::size_t const LookupDepth = 3;
 
-  static Def const& GetInternal(const std::string& key, StackIter begin,
+  static Def const& GetInternal(Key const& key, StackIter begin,
                                 StackIter end, bool raise);
 };
@@ -2,14 +2,16 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmDependsC.h"
 
+#include <cstdint>
+#include <cstring>
 #include <utility>
 
-#include "cmsys/FStream.hxx"
-
+#include "cmBinaryFormat.h"
 #include "cmFileTime.h"
 #include "cmGlobalUnixMakefileGenerator3.h"
 #include "cmLocalUnixMakefileGenerator3.h"
 #include "cmMakefile.h"
+#include "cmMappedFile.h"
 #include "cmProperty.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
@@ -22,6 +24,66 @@
 #define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
 #define INCLUDE_REGEX_TRANSFORM_MARKER "#IncludeRegexTransform: "
 
+namespace {
+// Bump the version whenever the layout of the cache file changes.
+char const kCacheMagic[4] = { 'C', 'M', 'I', 'C' };
+std::uint32_t const kCacheVersion = 1;
+
+// Return false for content with a byte order mark of an encoding that
+// the scanner does not implement.  Skip a UTF-8 byte order mark.
+bool SkipBOM(cm::string_view& content)
+{
+  if (cmHasLiteralPrefix(content, "\xEF\xBB\xBF")) {
+    content.remove_prefix(3);
+    return true;
+  }
+  return !cmHasLiteralPrefix(content, "\xFE\xFF") &&
+    !cmHasLiteralPrefix(content, "\xFF\xFE") &&
+    content.substr(0, 4) != cm::string_view("\0\0\xFE\xFF", 4);
+}
+
+// Parse a line that matches INCLUDE_REGEX_LINE without the overhead of
+// the regular expression.  Most lines are rejected by their first
+// character that is not a blank.
+bool ParseIncludeLine(char const* p, char const* end, cm::string_view& name,
+                      bool& quoted)
+{
+  auto skipBlanks = [&p, end]() {
+    while (p != end && (*p == ' ' || *p == '\t')) {
+      ++p;
+    }
+  };
+  skipBlanks();
+  if (p == end || (*p != '#' && *p != '%')) {
+    return false;
+  }
+  ++p;
+  skipBlanks();
+  cm::string_view const directive(p, end - p);
+  if (cmHasLiteralPrefix(directive, "include")) {
+    p += 7;
+  } else if (cmHasLiteralPrefix(directive, "import")) {
+    p += 6;
+  } else {
+    return false;
+  }
+  skipBlanks();
+  if (p == end || (*p != '<' && *p != '"')) {
+    return false;
+  }
+  char const* const first = ++p;
+  while (p != end && *p != '"' && *p != '>') {
+    ++p;
+  }
+  if (p == end || p == first) {
+    return false;
+  }
+  name = cm::string_view(first, p - first);
+  quoted = *p == '"';
+  return true;
+}
+}
+
 cmDependsC::cmDependsC() = default;
 
 cmDependsC::cmDependsC(cmLocalUnixMakefileGenerator3* lg,
@@ -118,7 +180,7 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
       this->Encountered.insert(src);
     }
 
-    std::set<std::string> scanned;
+    std::unordered_set<std::string> scanned;
     while (!this->Unscanned.empty()) {
       // Get the next file to scan.
       UnscannedEntry current = this->Unscanned.front();
@@ -185,23 +247,27 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
           }
         } else {
 
-          // Try to scan the file.  Just leave it out if we cannot find
-          // it.
-          cmsys::ifstream fin(fullName.c_str());
-          if (fin) {
-            cmsys::FStream::BOM bom = cmsys::FStream::ReadBOM(fin);
-            if (bom == cmsys::FStream::BOM_None ||
-                bom == cmsys::FStream::BOM_UTF8) {
-              // Add this file as a dependency.
-              dependencies.insert(fullName);
-
-              // Scan this file for new dependencies.  Pass the directory
-              // containing the file to handle double-quote includes.
-              std::string dir = cmSystemTools::GetFilenamePath(fullName);
-              this->Scan(fin, dir, fullName);
-            } else {
-              // Skip file with encoding we do not implement.
-            }
+          // Try to scan the file.  Just leave it out if we cannot read
+          // it.  Record its time and size before reading so that a later
+          // change is detected.
+          cmFileTime fileTime;
+          unsigned long long fileSize = 0;
+          cmMappedFile file;
+          bool readable = fileTime.Load(fullName, fileSize);
+          if (readable && fileSize > 0) {
+            readable = file.Open(fullName);
+          }
+          cm::string_view content = file.View();
+          if (readable && SkipBOM(content)) {
+            // Add this file as a dependency.
+            dependencies.insert(fullName);
+
+            // Scan this file for new dependencies.  Pass the directory
+            // containing the file to handle double-quote includes.
+            std::string dir = cmSystemTools::GetFilenamePath(fullName);
+            cmIncludeLines& lines = this->Scan(content, dir, fullName);
+            lines.Time = fileTime.GetTime();
+            lines.Size = fileSize;
           }
         }
       }
@@ -247,65 +313,59 @@ void cmDependsC::ReadCacheFile()
   if (this->CacheFileName.empty()) {
     return;
   }
-  cmsys::ifstream fin(this->CacheFileName.c_str());
-  if (!fin) {
+  cmMappedFile file;
+  if (!file.Open(this->CacheFileName)) {
+    return;
+  }
+  cmBinaryReader in(file.View());
+  std::uint32_t version;
+  if (!in.Magic(cm::string_view(kCacheMagic, sizeof(kCacheMagic))) ||
+      !in.U32(version) || version != kCacheVersion) {
     return;
   }
 
-  std::string line;
-  cmIncludeLines* cacheEntry = nullptr;
-  bool haveFileName = false;
-
-  cmFileTime cacheFileTime;
-  bool const cacheFileTimeGood = cacheFileTime.Load(this->CacheFileName);
-  while (cmSystemTools::GetLineFromStream(fin, line)) {
-    if (line.empty()) {
-      cacheEntry = nullptr;
-      haveFileName = false;
-      continue;
+  // The cached results are valid only for the same regular expressions.
+  for (std::string const* regex :
+       { &this->IncludeRegexLineString, &this->IncludeRegexScanString,
+         &this->IncludeRegexComplainString,
+         &this->IncludeRegexTransformString }) {
+    cm::string_view s;
+    if (!in.String(s) || s != *regex) {
+      return;
     }
-    // the first line after an empty line is the name of the parsed file
-    if (!haveFileName) {
-      haveFileName = true;
-
-      cmFileTime fileTime;
-      bool const res = cacheFileTimeGood && fileTime.Load(line);
-      bool const newer = res && cacheFileTime.Newer(fileTime);
+  }
 
-      if (res && newer) // cache is newer than the parsed file
-      {
-        cacheEntry = &this->FileCache[line];
-      }
-      // file doesn't exist, check that the regular expressions
-      // haven't changed
-      else if (!res) {
-        if (cmHasLiteralPrefix(line, INCLUDE_REGEX_LINE_MARKER)) {
-          if (line != this->IncludeRegexLineString) {
-            return;
-          }
-        } else if (cmHasLiteralPrefix(line, INCLUDE_REGEX_SCAN_MARKER)) {
-          if (line != this->IncludeRegexScanString) {
-            return;
-          }
-        } else if (cmHasLiteralPrefix(line, INCLUDE_REGEX_COMPLAIN_MARKER)) {
-          if (line != this->IncludeRegexComplainString) {
-            return;
-          }
-        } else if (cmHasLiteralPrefix(line, INCLUDE_REGEX_TRANSFORM_MARKER)) {
-          if (line != this->IncludeRegexTransformString) {
-            return;
-          }
-        }
+  // Use the results for files that did not change since they were
+  // scanned.
+  cmFileTime fileTime;
+  unsigned long long fileSize;
+  while (!in.AtEnd()) {
+    cm::string_view fileName;
+    long long time;
+    std::uint64_t size;
+    std::uint32_t count;
+    if (!in.String(fileName) || !in.I64(time) || !in.U64(size) ||
+        !in.U32(count)) {
+      return;
+    }
+    cmIncludeLines lines;
+    lines.Time = static_cast<cmFileTime::TimeType>(time);
+    lines.Size = size;
+    for (std::uint32_t i = 0; i < count; ++i) {
+      cm::string_view name;
+      cm::string_view quotedLocation;
+      if (!in.String(name) || !in.String(quotedLocation)) {
+        return;
       }
-    } else if (cacheEntry != nullptr) {
       UnscannedEntry entry;
-      entry.FileName = line;
-      if (cmSystemTools::GetLineFromStream(fin, line)) {
-        if (line != "-") {
-          entry.QuotedLocation = line;
-        }
-        cacheEntry->UnscannedEntries.push_back(std::move(entry));
-      }
+      entry.FileName = std::string(name);
+      entry.QuotedLocation = std::string(quotedLocation);
+      lines.UnscannedEntries.push_back(std::move(entry));
+    }
+    std::string path(fileName);
+    if (fileTime.Load(path, fileSize) && fileTime.GetTime() == lines.Time &&
+        fileSize == lines.Size) {
+      this->FileCache[std::move(path)] = std::move(lines);
     }
   }
 }
@@ -315,81 +375,110 @@ void cmDependsC::WriteCacheFile() const
   if (this->CacheFileName.empty()) {
     return;
   }
-  cmsys::ofstream cacheOut(this->CacheFileName.c_str());
-  if (!cacheOut) {
-    return;
-  }
 
-  cacheOut << this->IncludeRegexLineString << "\n\n";
-  cacheOut << this->IncludeRegexScanString << "\n\n";
-  cacheOut << this->IncludeRegexComplainString << "\n\n";
-  cacheOut << this->IncludeRegexTransformString << "\n\n";
+  cmBinaryWriter out;
+  out.Bytes(cm::string_view(kCacheMagic, sizeof(kCacheMagic)));
+  out.U32(kCacheVersion);
+  out.String(this->IncludeRegexLineString);
+  out.String(this->IncludeRegexScanString);
+  out.String(this->IncludeRegexComplainString);
+  out.String(this->IncludeRegexTransformString);
 
   for (auto const& fileIt : this->FileCache) {
     if (fileIt.second.Used) {
-      cacheOut << fileIt.first << '\n';
-
+      out.String(fileIt.first);
+      out.I64(fileIt.second.Time);
+      out.U64(fileIt.second.Size);
+      out.U32(
+        static_cast<std::uint32_t>(fileIt.second.UnscannedEntries.size()));
       for (UnscannedEntry const& inc : fileIt.second.UnscannedEntries) {
-        cacheOut << inc.FileName << '\n';
-        if (inc.QuotedLocation.empty()) {
-          cacheOut << '-' << '\n';
-        } else {
-          cacheOut << inc.QuotedLocation << '\n';
-        }
+        out.String(inc.FileName);
+        out.String(inc.QuotedLocation);
       }
-      cacheOut << '\n';
     }
   }
+
+  cmStoreBinaryFile(this->CacheFileName, out.Data);
 }
 
-void cmDependsC::Scan(std::istream& is, const std::string& directory,
-                      const std::string& fullName)
+cmDependsC::cmIncludeLines& cmDependsC::Scan(cm::string_view content,
+                                             const std::string& directory,
+                                             const std::string& fullName)
 {
   cmIncludeLines& newCacheEntry = this->FileCache[fullName];
   newCacheEntry.Used = true;
 
-  // Read one line at a time.
+  char const* p = content.data();
+  char const* const end = p + content.size();
   std::string line;
-  while (cmSystemTools::GetLineFromStream(is, line)) {
-    // Transform the line content first.
-    if (!this->TransformRules.empty()) {
-      this->TransformLine(line);
+  while (p != end) {
+    // Find the end of the current line.
+    char const* eol =
+      static_cast<char const*>(std::memchr(p, '\n', end - p));
+    if (!eol) {
+      eol = end;
     }
 
-    // Match include directives.
-    if (this->IncludeRegexLine.find(line)) {
-      // Get the file being included.
-      UnscannedEntry entry;
-      entry.FileName = this->IncludeRegexLine.match(2);
-      cmSystemTools::ConvertToUnixSlashes(entry.FileName);
-      if (this->IncludeRegexLine.match(3) == "\"" &&
-          !cmSystemTools::FileIsFullPath(entry.FileName)) {
-        // This was a double-quoted include with a relative path.  We
-        // must check for the file in the directory containing the
-        // file we are scanning.
-        entry.QuotedLocation =
-          cmSystemTools::CollapseFullPath(entry.FileName, directory);
+    if (this->TransformRules.empty()) {
+      // Match include directives.
+      cm::string_view name;
+      bool quoted;
+      if (ParseIncludeLine(p, eol, name, quoted)) {
+        this->AddInclude(std::string(name), quoted, directory,
+                         newCacheEntry);
+      }
+    } else {
+      // Transform the line content first.
+      line.assign(p, eol);
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
       }
+      this->TransformLine(line);
 
-      // Queue the file if it has not yet been encountered and it
-      // matches the regular expression for recursive scanning.  Note
-      // that this check does not account for the possibility of two
-      // headers with the same name in different directories when one
-      // is included by double-quotes and the other by angle brackets.
-      // It also does not work properly if two header files with the same
-      // name exist in different directories, and both are included from a
-      // file their own directory by simply using "filename.h" (#12619)
-      // This kind of problem will be fixed when a more
-      // preprocessor-like implementation of this scanner is created.
-      if (this->IncludeRegexScan.find(entry.FileName)) {
-        newCacheEntry.UnscannedEntries.push_back(entry);
-        if (this->Encountered.find(entry.FileName) ==
-            this->Encountered.end()) {
-          this->Encountered.insert(entry.FileName);
-          this->Unscanned.push(entry);
-        }
+      // Match include directives.
+      if (this->IncludeRegexLine.find(line)) {
+        this->AddInclude(this->IncludeRegexLine.match(2),
+                         this->IncludeRegexLine.match(3) == "\"", directory,
+                         newCacheEntry);
       }
     }
+
+    p = eol == end ? end : eol + 1;
+  }
+  return newCacheEntry;
+}
+
+void cmDependsC::AddInclude(std::string fileName, bool quoted,
+                            const std::string& directory,
+                            cmIncludeLines& lines)
+{
+  // Get the file being included.
+  UnscannedEntry entry;
+  entry.FileName = std::move(fileName);
+  cmSystemTools::ConvertToUnixSlashes(entry.FileName);
+  if (quoted && !cmSystemTools::FileIsFullPath(entry.FileName)) {
+    // This was a double-quoted include with a relative path.  We
+    // must check for the file in the directory containing the
+    // file we are scanning.
+    entry.QuotedLocation =
+      cmSystemTools::CollapseFullPath(entry.FileName, directory);
+  }
+
+  // Queue the file if it has not yet been encountered and it
+  // matches the regular expression for recursive scanning.  Note
+  // that this check does not account for the possibility of two
+  // headers with the same name in different directories when one
+  // is included by double-quotes and the other by angle brackets.
+  // It also does not work properly if two header files with the same
+  // name exist in different directories, and both are included from a
+  // file their own directory by simply using "filename.h" (#12619)
+  // This kind of problem will be fixed when a more
+  // preprocessor-like implementation of this scanner is created.
+  if (this->IncludeRegexScan.find(entry.FileName)) {
+    lines.UnscannedEntries.push_back(entry);
+    if (this->Encountered.insert(entry.FileName).second) {
+      this->Unscanned.push(std::move(entry));
+    }
   }
 }
 
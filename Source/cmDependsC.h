@@ -9,11 +9,16 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <cm/string_view>
+
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmDepends.h"
+#include "cmFileTime.h"
 
 class cmLocalUnixMakefileGenerator3;
 
@@ -41,10 +46,6 @@ protected:
                          const std::string& obj, std::ostream& makeDepends,
                          std::ostream& internalDepends) override;
 
-  // Method to scan a single file.
-  void Scan(std::istream& is, const std::string& directory,
-            const std::string& fullName);
-
   // Regular expression to identify C preprocessor include directives.
   cmsys::RegularExpression IncludeRegexLine;
 
@@ -76,16 +77,25 @@ public:
   struct cmIncludeLines
   {
     std::vector<UnscannedEntry> UnscannedEntries;
+    // Modification time and size of the file when it was scanned.
+    cmFileTime::TimeType Time = 0;
+    unsigned long long Size = 0;
     bool Used = false;
   };
 
 protected:
+  // Method to scan the content of a single file.
+  cmIncludeLines& Scan(cm::string_view content, const std::string& directory,
+                       const std::string& fullName);
+  void AddInclude(std::string fileName, bool quoted,
+                  const std::string& directory, cmIncludeLines& lines);
+
   const DependencyMap* ValidDeps = nullptr;
-  std::set<std::string> Encountered;
+  std::unordered_set<std::string> Encountered;
   std::queue<UnscannedEntry> Unscanned;
 
-  std::map<std::string, cmIncludeLines> FileCache;
-  std::map<std::string, std::string> HeaderLocationCache;
+  std::unordered_map<std::string, cmIncludeLines> FileCache;
+  std::unordered_map<std::string, std::string> HeaderLocationCache;
 
   std::string CacheFileName;
 
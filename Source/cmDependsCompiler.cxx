@@ -4,9 +4,13 @@
 #include "cmDependsCompiler.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
@@ -17,171 +21,350 @@
 
 #include "cmsys/FStream.hxx"
 
+#include "cmBinaryFormat.h"
 #include "cmFileTime.h"
 #include "cmGccDepfileReader.h"
 #include "cmGccDepfileReaderTypes.h"
 #include "cmGlobalUnixMakefileGenerator3.h"
 #include "cmLocalUnixMakefileGenerator3.h"
+#include "cmMappedFile.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
-bool cmDependsCompiler::CheckDependencies(
-  const std::string& internalDepFile, const std::vector<std::string>& depFiles,
-  cmDepends::DependencyMap& dependencies,
-  const std::function<bool(const std::string&)>& isValidPath)
+namespace {
+// Bump the version whenever the file layout changes.
+char const kMagic[4] = { 'C', 'M', 'D', 'D' };
+std::uint32_t const kVersion = 1;
+
+// The database is a sequence of records, each starting with a header
+// that holds the size of its payload.  A path record adds a path to the
+// table of paths.  A dependencies record, marked by this bit in its
+// header, lists the indices of a target and of the paths it depends on.
+// Updates are appended, and a later record of a target replaces earlier
+// ones.
+std::uint32_t const kDependenciesRecord = 0x80000000u;
+
+// Rewrite the database when it holds many more records than targets.
+std::size_t const kMinCompactionRecords = 1000;
+std::size_t const kCompactionRatio = 3;
+
+/** Dependencies of the objects of a target as recorded on disk.  */
+class DependencyDatabase
 {
-  bool status = true;
-  bool forceReadDeps = true;
+public:
+  /** Load the recorded dependencies.  Return false if the file does not
+      exist or is not a valid database.  */
+  bool Load(std::string const& path, cmDepends::DependencyMap& dependencies);
 
-  cmFileTime internalDepFileTime;
-  // read cached dependencies stored in internal file
-  if (cmSystemTools::FileExists(internalDepFile)) {
-    internalDepFileTime.Load(internalDepFile);
-    forceReadDeps = false;
-
-    // read current dependencies
-    cmsys::ifstream fin(internalDepFile.c_str());
-    if (fin) {
-      std::string line;
-      std::string depender;
-      std::vector<std::string>* currentDependencies = nullptr;
-      while (std::getline(fin, line)) {
-        if (line.empty() || line.front() == '#') {
-          continue;
-        }
-        // Drop carriage return character at the end
-        if (line.back() == '\r') {
-          line.pop_back();
-          if (line.empty()) {
-            continue;
-          }
-        }
-        // Check if this a depender line
-        if (line.front() != ' ') {
-          depender = std::move(line);
-          currentDependencies = &dependencies[depender];
-          continue;
-        }
-        // This is a dependee line
-        if (currentDependencies != nullptr) {
-          currentDependencies->emplace_back(line.substr(1));
-        }
+  /** Record the dependencies of a target unless they are unchanged.  */
+  void Update(std::string const& target, std::vector<std::string> depends,
+              cmDepends::DependencyMap& dependencies);
+
+  /** Whether Update() changed any dependencies or the database must be
+      written from scratch.  */
+  bool Changed() const
+  {
+    return !this->Valid || !this->Pending.Data.empty();
+  }
+
+  /** Append the updated records, or write all dependencies if the
+      database was not valid or holds too many replaced records.  */
+  bool Save(std::string const& path,
+            cmDepends::DependencyMap const& dependencies);
+
+private:
+  std::uint32_t PathIndex(std::string const& path);
+  void AppendRecord(std::string const& target,
+                    std::vector<std::string> const& depends);
+
+  std::unordered_map<std::string, std::uint32_t> PathIndices;
+  std::size_t Records = 0;
+  cmBinaryWriter Pending;
+  bool Valid = false;
+};
+
+bool DependencyDatabase::Load(std::string const& path,
+                              cmDepends::DependencyMap& dependencies)
+{
+  cmMappedFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+  cmBinaryReader in(file.View());
+  std::uint32_t version;
+  if (!in.Magic(cm::string_view(kMagic, sizeof(kMagic))) ||
+      !in.U32(version) || version != kVersion) {
+    return false;
+  }
+
+  // Decode into temporaries so an invalid file leaves no partial result.
+  std::vector<cm::string_view> paths;
+  std::map<std::uint32_t, std::vector<std::uint32_t>> targets;
+  std::size_t records = 0;
+  while (!in.AtEnd()) {
+    std::uint32_t header;
+    cm::string_view payload;
+    if (!in.U32(header) ||
+        !in.Bytes(header & ~kDependenciesRecord, payload)) {
+      return false;
+    }
+    if (!(header & kDependenciesRecord)) {
+      paths.push_back(payload);
+      continue;
+    }
+    cmBinaryReader record(payload);
+    std::uint32_t target;
+    if (payload.size() % 4 != 0 || !record.U32(target) ||
+        target >= paths.size()) {
+      return false;
+    }
+    std::vector<std::uint32_t>& depends = targets[target];
+    depends.clear();
+    while (!record.AtEnd()) {
+      std::uint32_t index;
+      record.U32(index);
+      if (index >= paths.size()) {
+        return false;
       }
-      fin.close();
+      depends.push_back(index);
     }
+    ++records;
   }
 
-  // Now, update dependencies map with all new compiler generated
-  // dependencies files
-  cmFileTime depFileTime;
-  for (auto dep = depFiles.begin(); dep != depFiles.end(); dep++) {
-    const auto& source = *dep++;
-    const auto& target = *dep++;
-    const auto& format = *dep++;
-    const auto& depFile = *dep;
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    this->PathIndices.emplace(std::string(paths[i]),
+                              static_cast<std::uint32_t>(i));
+  }
+  for (auto const& t : targets) {
+    std::vector<std::string>& depends =
+      dependencies[std::string(paths[t.first])];
+    depends.clear();
+    depends.reserve(t.second.size());
+    for (std::uint32_t index : t.second) {
+      depends.emplace_back(paths[index]);
+    }
+  }
+  this->Records = records;
+  this->Valid = true;
+  return true;
+}
 
-    if (!cmSystemTools::FileExists(depFile)) {
-      continue;
+std::uint32_t DependencyDatabase::PathIndex(std::string const& path)
+{
+  auto i = this->PathIndices.emplace(
+    path, static_cast<std::uint32_t>(this->PathIndices.size()));
+  if (i.second) {
+    this->Pending.String(path);
+  }
+  return i.first->second;
+}
+
+void DependencyDatabase::AppendRecord(std::string const& target,
+                                      std::vector<std::string> const& depends)
+{
+  cmBinaryWriter record;
+  record.U32(this->PathIndex(target));
+  for (std::string const& dep : depends) {
+    record.U32(this->PathIndex(dep));
+  }
+  this->Pending.U32(static_cast<std::uint32_t>(record.Data.size()) |
+                    kDependenciesRecord);
+  this->Pending.Bytes(record.Data);
+}
+
+void DependencyDatabase::Update(std::string const& target,
+                                std::vector<std::string> depends,
+                                cmDepends::DependencyMap& dependencies)
+{
+  auto i = dependencies.find(target);
+  if (i != dependencies.end()) {
+    if (i->second == depends) {
+      return;
     }
+  } else {
+    i = dependencies.emplace(target, std::vector<std::string>()).first;
+  }
+  if (this->Valid) {
+    this->AppendRecord(target, depends);
+    ++this->Records;
+  }
+  i->second = std::move(depends);
+}
+
+bool DependencyDatabase::Save(std::string const& path,
+                              cmDepends::DependencyMap const& dependencies)
+{
+  if (this->Valid && this->Pending.Data.empty()) {
+    // Mark the dependencies files as read.
+    return cmSystemTools::Touch(path, false);
+  }
 
-    if (!forceReadDeps) {
-      depFileTime.Load(depFile);
+  if (this->Valid &&
+      (this->Records < kMinCompactionRecords ||
+       this->Records <= kCompactionRatio * dependencies.size())) {
+    cmsys::ofstream fout(path.c_str(),
+                         std::ios::out | std::ios::binary | std::ios::app);
+    fout.write(this->Pending.Data.data(),
+               static_cast<std::streamsize>(this->Pending.Data.size()));
+    return static_cast<bool>(fout);
+  }
+
+  // Write all dependencies to a new database.
+  this->PathIndices.clear();
+  this->Pending.Data.clear();
+  this->Pending.Bytes(cm::string_view(kMagic, sizeof(kMagic)));
+  this->Pending.U32(kVersion);
+  for (auto const& node : dependencies) {
+    this->AppendRecord(node.first, node.second);
+  }
+  return cmStoreBinaryFile(path, this->Pending.Data);
+}
+}
+
+bool cmDependsCompiler::CheckDependencies(
+  const std::string& internalDepFile, const std::vector<std::string>& depFiles,
+  cmDepends::DependencyMap& dependencies,
+  const std::function<bool(const std::string&)>& isValidPath)
+{
+  // Look for dependencies files written since the database was updated.
+  // This needs only their timestamps, so a build where nothing changed
+  // does not read any file.
+  std::vector<std::size_t> newDepFiles;
+  cmFileTime internalDepFileTime;
+  bool const haveDatabase = internalDepFileTime.Load(internalDepFile);
+  cmFileTime depFileTime;
+  for (std::size_t i = 0; i + 3 < depFiles.size(); i += 4) {
+    const auto& depFile = depFiles[i + 3];
+    if (!depFileTime.Load(depFile)) {
+      continue;
     }
-    if (forceReadDeps || depFileTime.Compare(internalDepFileTime) >= 0) {
-      status = false;
+    if (!haveDatabase || depFileTime.Compare(internalDepFileTime) >= 0) {
       if (this->Verbose) {
         cmSystemTools::Stdout(cmStrCat("Dependencies file \"", depFile,
                                        "\" is newer than depends file \"",
                                        internalDepFile, "\".\n"));
       }
+      newDepFiles.push_back(i);
+    }
+  }
+  if (newDepFiles.empty()) {
+    return true;
+  }
 
-      std::vector<std::string> depends;
-      if (format == "custom"_s) {
-        auto deps = cmReadGccDepfile(
-          depFile.c_str(), this->LocalGenerator->GetCurrentBinaryDirectory());
-        if (!deps) {
-          continue;
-        }
+  DependencyDatabase database;
+  if (!database.Load(internalDepFile, dependencies)) {
+    // Without valid recorded dependencies all files must be read.
+    newDepFiles.clear();
+    for (std::size_t i = 0; i + 3 < depFiles.size(); i += 4) {
+      if (cmSystemTools::FileExists(depFiles[i + 3])) {
+        newDepFiles.push_back(i);
+      }
+    }
+  }
 
-        for (auto& entry : *deps) {
-          depends = std::move(entry.paths);
-          if (isValidPath) {
-            cm::erase_if(depends, isValidPath);
-          }
-          // copy depends for each target, except first one, which can be
-          // moved
-          for (auto index = entry.rules.size() - 1; index > 0; --index) {
-            dependencies[entry.rules[index]] = depends;
-          }
-          dependencies[entry.rules.front()] = std::move(depends);
-        }
-      } else {
-        if (format == "msvc"_s) {
-          cmsys::ifstream fin(depFile.c_str());
-          if (!fin) {
-            continue;
-          }
+  // Now, update dependencies map with all new compiler generated
+  // dependencies files.  Their paths are mostly the same headers, so use
+  // one reader to normalize each of them once.
+  cmGccDepfileReader reader;
+  for (std::size_t i : newDepFiles) {
+    const auto& source = depFiles[i];
+    const auto& target = depFiles[i + 1];
+    const auto& format = depFiles[i + 2];
+    const auto& depFile = depFiles[i + 3];
 
-          std::string line;
-          if (!isValidPath) {
-            // insert source as first dependency
-            depends.push_back(source);
-          }
-          while (cmSystemTools::GetLineFromStream(fin, line)) {
-            depends.emplace_back(std::move(line));
-          }
-        } else if (format == "gcc"_s) {
-          auto deps = cmReadGccDepfile(depFile.c_str());
-          if (!deps) {
-            continue;
-          }
+    std::vector<std::string> depends;
+    if (format == "custom"_s) {
+      auto deps = reader.Read(
+        depFile.c_str(), this->LocalGenerator->GetCurrentBinaryDirectory());
+      if (!deps) {
+        continue;
+      }
 
-          // dependencies generated by the compiler contains only one target
-          depends = std::move(deps->front().paths);
-          if (depends.empty()) {
-            // unexpectedly empty, ignore it and continue
-            continue;
-          }
+      for (auto& entry : *deps) {
+        depends = std::move(entry.paths);
+        if (isValidPath) {
+          cm::erase_if(depends, isValidPath);
+        }
+        // copy depends for each target, except first one, which can be
+        // moved
+        for (auto index = entry.rules.size() - 1; index > 0; --index) {
+          database.Update(entry.rules[index], depends, dependencies);
+        }
+        database.Update(entry.rules.front(), std::move(depends),
+                        dependencies);
+      }
+    } else {
+      if (format == "msvc"_s) {
+        cmsys::ifstream fin(depFile.c_str());
+        if (!fin) {
+          continue;
+        }
 
-          // depending of the effective format of the dependencies file
-          // generated by the compiler, the target can be wrongly identified
-          // as a dependency so remove it from the list
-          if (depends.front() == target) {
-            depends.erase(depends.begin());
-          }
+        std::string line;
+        if (!isValidPath) {
+          // insert source as first dependency
+          depends.push_back(source);
+        }
+        while (cmSystemTools::GetLineFromStream(fin, line)) {
+          depends.emplace_back(std::move(line));
+        }
+      } else if (format == "gcc"_s) {
+        auto deps = reader.Read(depFile.c_str());
+        if (!deps) {
+          continue;
+        }
 
-          // ensure source file is the first dependency
-          if (depends.front() != source) {
-            cm::erase(depends, source);
-            if (!isValidPath) {
-              depends.insert(depends.begin(), source);
-            }
-          } else if (isValidPath) {
-            // remove first dependency because it must not be filtered out
-            depends.erase(depends.begin());
-          }
-        } else {
-          // unknown format, ignore it
+        // dependencies generated by the compiler contains only one target
+        depends = std::move(deps->front().paths);
+        if (depends.empty()) {
+          // unexpectedly empty, ignore it and continue
           continue;
         }
 
-        if (isValidPath) {
-          cm::erase_if(depends, isValidPath);
-          // insert source as first dependency
-          depends.insert(depends.begin(), source);
+        // depending of the effective format of the dependencies file
+        // generated by the compiler, the target can be wrongly identified
+        // as a dependency so remove it from the list
+        if (depends.front() == target) {
+          depends.erase(depends.begin());
+        }
+
+        // ensure source file is the first dependency
+        if (depends.front() != source) {
+          cm::erase(depends, source);
+          if (!isValidPath) {
+            depends.insert(depends.begin(), source);
+          }
+        } else if (isValidPath) {
+          // remove first dependency because it must not be filtered out
+          depends.erase(depends.begin());
         }
+      } else {
+        // unknown format, ignore it
+        continue;
+      }
 
-        dependencies[target] = std::move(depends);
+      if (isValidPath) {
+        cm::erase_if(depends, isValidPath);
+        // insert source as first dependency
+        depends.insert(depends.begin(), source);
       }
+
+      database.Update(target, std::move(depends), dependencies);
     }
   }
 
-  return status;
+  // Objects are often recompiled without a change of their dependencies.
+  // The database then only gets a new timestamp and the make depends file
+  // is kept as it is.
+  bool const changed = database.Changed();
+  if (!database.Save(internalDepFile, dependencies)) {
+    cmSystemTools::RemoveFile(internalDepFile);
+  }
+  return !changed;
 }
 
 void cmDependsCompiler::WriteDependencies(
-  const cmDepends::DependencyMap& dependencies, std::ostream& makeDepends,
-  std::ostream& internalDepends)
+  const cmDepends::DependencyMap& dependencies, std::ostream& makeDepends)
 {
   // dependencies file consumed by make tool
   const auto& lineContinue = static_cast<cmGlobalUnixMakefileGenerator3*>(
@@ -219,26 +402,17 @@ void cmDependsCompiler::WriteDependencies(
           makeDepends << ' ' << lineContinue << "  " << dep;
         }
       } else {
-        makeDepends << target << ": " << dep << std::endl;
+        makeDepends << target << ": " << dep << '\n';
       }
 
       phonyTargets.emplace(dep.data(), dep.length());
     }
-    makeDepends << std::endl << std::endl;
+    makeDepends << "\n\n";
   }
 
   // add phony targets
   for (const auto& target : phonyTargets) {
-    makeDepends << std::endl << target << ':' << std::endl;
-  }
-
-  // internal dependencies file
-  for (const auto& node : dependencies) {
-    internalDepends << node.first << std::endl;
-    for (const auto& dep : node.second) {
-      internalDepends << ' ' << dep << std::endl;
-    }
-    internalDepends << std::endl;
+    makeDepends << '\n' << target << ":\n";
   }
 }
 
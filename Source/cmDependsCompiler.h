@@ -17,7 +17,11 @@ class cmLocalUnixMakefileGenerator3;
  * \brief Dependencies files manager.
  *
  * This class is responsible for maintaining a compiler_depends.make file in
- * the build tree corresponding to an object file.
+ * the build tree corresponding to an object file.  The dependencies read
+ * from the files generated by the compiler are recorded in a binary
+ * database, compiler_depend.internal, which is appended to as objects are
+ * recompiled.  The make file is rewritten only when the recorded
+ * dependencies change.
  */
 class cmDependsCompiler
 {
@@ -37,9 +41,10 @@ public:
     this->LocalGenerator = lg;
   }
 
-  /** Read dependencies for the target file. Return true if
-      dependencies didn't changed and false if not.
-      Up-to-date Dependencies will be stored in deps. */
+  /** Update the dependencies database of the target with the
+      dependencies files written since it was last updated.  Return true
+      if dependencies didn't changed and false if not.  In the latter
+      case all up-to-date dependencies will be stored in dependencies. */
   bool CheckDependencies(
     const std::string& internalDepFile,
     const std::vector<std::string>& depFiles,
@@ -48,8 +53,7 @@ public:
 
   /** Write dependencies for the target file.  */
   void WriteDependencies(const cmDepends::DependencyMap& dependencies,
-                         std::ostream& makeDepends,
-                         std::ostream& internalDepends);
+                         std::ostream& makeDepends);
 
   /** Clear dependencies for the target so they will be regenerated.  */
   void ClearDependencies(const std::vector<std::string>& depFiles);
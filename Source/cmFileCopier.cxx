@@ -18,6 +18,13 @@
 #  include "cmsys/FStream.hxx"
 #endif
 
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmInstallHashManifest.h"
+#  include "cmWorkerPool.h"
+#endif
+
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <sstream>
 
@@ -29,6 +36,9 @@ cmFileCopier::cmFileCopier(cmExecutionStatus& status, const char* name)
   , Name(name)
   , Always(false)
   , MatchlessFiles(true)
+  , LinkFiles(false)
+  , Jobs(1)
+  , HashManifest(nullptr)
   , FilePermissions(0)
   , DirPermissions(0)
   , CurrentMatchRule(nullptr)
@@ -70,10 +80,33 @@ cmFileCopier::MatchProperties cmFileCopier::CollectMatchProperties(
 
 bool cmFileCopier::SetPermissions(const std::string& toFile,
                                   mode_t permissions)
+{
+  std::string error;
+  if (!WritePermissions(this->Name, toFile, permissions,
+                        this->StorePermissionsStream(), error)) {
+    this->Status.SetError(error);
+    return false;
+  }
+  return true;
+}
+
+bool cmFileCopier::StorePermissionsStream() const
+{
+#ifdef WIN32
+  return this->Makefile->IsOn("CMAKE_CROSSCOMPILING");
+#else
+  return false;
+#endif
+}
+
+bool cmFileCopier::WritePermissions(const char* name,
+                                    const std::string& toFile,
+                                    mode_t permissions, bool storeStream,
+                                    std::string& error)
 {
   if (permissions) {
 #ifdef WIN32
-    if (Makefile->IsOn("CMAKE_CROSSCOMPILING")) {
+    if (storeStream) {
       // Store the mode in an NTFS alternate stream.
       std::string mode_t_adt_filename = toFile + ":cmake_mode_t";
 
@@ -89,13 +122,15 @@ bool cmFileCopier::SetPermissions(const std::string& toFile,
       }
       file_time_orig.Store(toFile);
     }
+#else
+    static_cast<void>(storeStream);
 #endif
 
     if (!cmSystemTools::SetPermissions(toFile, permissions)) {
       std::ostringstream e;
-      e << this->Name << " cannot set permissions on \"" << toFile
+      e << name << " cannot set permissions on \"" << toFile
         << "\": " << cmSystemTools::GetLastSystemError() << ".";
-      this->Status.SetError(e.str());
+      error = e.str();
       return false;
     }
   }
@@ -389,6 +424,14 @@ bool cmFileCopier::Run(std::vector<std::string> const& args)
     return false;
   }
 
+  // Files queued before a failure come before it in the installation, so
+  // finish them anyway and report their first error instead.
+  bool const installed = this->InstallFiles();
+  return this->FinishQueuedFiles() && installed;
+}
+
+bool cmFileCopier::InstallFiles()
+{
   for (std::string const& f : this->Files) {
     std::string file;
     if (!f.empty() && !cmSystemTools::FileIsFullPath(f)) {
@@ -462,6 +505,12 @@ bool cmFileCopier::Install(const std::string& fromFile,
   }
 
   if (cmSystemTools::SameFile(fromFile, toFile)) {
+    // A file linked by a previous installation is up to date.
+    if (this->LinkFiles && !cmSystemTools::FileIsSymlink(toFile) &&
+        !cmSystemTools::FileIsDirectory(fromFile) &&
+        !cmSystemTools::ComparePath(fromFile, toFile)) {
+      this->Report(toFile, TypeFile, false);
+    }
     return true;
   }
 
@@ -508,7 +557,7 @@ bool cmFileCopier::InstallSymlinkChain(std::string& fromFile,
       }
     }
 
-    this->ReportCopy(toFile, TypeLink, copy);
+    this->Report(toFile, TypeLink, copy);
 
     if (copy) {
       cmSystemTools::RemoveFile(toFile);
@@ -557,7 +606,7 @@ bool cmFileCopier::InstallSymlink(const std::string& fromFile,
   }
 
   // Inform the user about this file installation.
-  this->ReportCopy(toFile, TypeLink, copy);
+  this->Report(toFile, TypeLink, copy);
 
   if (copy) {
     // Remove the destination file so we can always create the symlink.
@@ -591,47 +640,233 @@ bool cmFileCopier::InstallFile(const std::string& fromFile,
     if (!this->FileTimes.DifferS(fromFile, toFile)) {
       copy = false;
     }
+#if !defined(CMAKE_BOOTSTRAP)
+    // Nor if both still have the content recorded by the last install.
+    if (copy && this->HashManifest &&
+        this->HashManifest->IsUpToDate(fromFile, toFile)) {
+      copy = false;
+    }
+#endif
   }
 
   // Inform the user about this file installation.
-  this->ReportCopy(toFile, TypeFile, copy);
+  this->Report(toFile, TypeFile, copy, copy && this->Jobs > 1);
+
+  // Compute the requested permissions for the destination file.
+  mode_t permissions =
+    (match_properties.Permissions ? match_properties.Permissions
+                                  : this->FilePermissions);
+  if (!permissions) {
+    // No permissions were explicitly provided but the user requested
+    // that the source file permissions be used.
+    cmSystemTools::GetPermissions(fromFile, permissions);
+  }
+
+  if (!copy) {
+#if !defined(CMAKE_BOOTSTRAP)
+    if (this->HashManifest) {
+      this->HashManifest->Record(fromFile, toFile, false);
+    }
+#endif
+    return this->SetPermissions(toFile, permissions);
+  }
+
+  cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(toFile));
 
-  // Copy the file.
-  if (copy && !cmSystemTools::CopyAFile(fromFile, toFile, true)) {
+  FileOperation op;
+  op.FromFile = fromFile;
+  op.ToFile = toFile;
+  op.Permissions = permissions;
+  op.StorePermissionsStream = this->StorePermissionsStream();
+  op.Link = this->LinkFiles;
+  op.CopyTime = !this->Always;
+
+  // With several jobs, copy the files concurrently once all of them
+  // have been found.
+  if (this->Jobs > 1) {
+    this->QueuedFiles.push_back(std::move(op));
+    return true;
+  }
+  if (!this->CopyOrLinkFile(op)) {
+    this->Status.SetError(op.Error);
+    return false;
+  }
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->HashManifest) {
+    this->HashManifest->Record(fromFile, toFile, true);
+  }
+#endif
+  return true;
+}
+
+bool cmFileCopier::CopyOrLinkFile(FileOperation& op) const
+{
+  // Link or copy the file.
+  bool const linked =
+    op.Link && LinkFile(op.FromFile, op.ToFile, op.Permissions);
+  std::string err;
+  if (!linked &&
+      cmSystemTools::CopySingleFile(op.FromFile, op.ToFile,
+                                    cmSystemTools::CopyWhen::Always,
+                                    &err) !=
+        cmSystemTools::CopyResult::Success) {
     std::ostringstream e;
-    e << this->Name << " cannot copy file \"" << fromFile << "\" to \""
-      << toFile << "\": " << cmSystemTools::GetLastSystemError() << ".";
-    this->Status.SetError(e.str());
+    e << this->Name << " cannot copy file \"" << op.FromFile << "\" to \""
+      << op.ToFile << "\": " << err << ".";
+    op.Error = e.str();
     return false;
   }
 
-  // Set the file modification time of the destination file.
-  if (copy && !this->Always) {
+  // Set the file modification time of the destination file.  A link
+  // shares it with the source already.
+  if (!linked && op.CopyTime) {
     // Add write permission so we can set the file time.
     // Permissions are set unconditionally below anyway.
     mode_t perm = 0;
-    if (cmSystemTools::GetPermissions(toFile, perm)) {
-      cmSystemTools::SetPermissions(toFile, perm | mode_owner_write);
+    if (cmSystemTools::GetPermissions(op.ToFile, perm)) {
+      cmSystemTools::SetPermissions(op.ToFile, perm | mode_owner_write);
     }
-    if (!cmFileTimes::Copy(fromFile, toFile)) {
+    if (!cmFileTimes::Copy(op.FromFile, op.ToFile)) {
       std::ostringstream e;
-      e << this->Name << " cannot set modification time on \"" << toFile
+      e << this->Name << " cannot set modification time on \"" << op.ToFile
         << "\": " << cmSystemTools::GetLastSystemError() << ".";
-      this->Status.SetError(e.str());
+      op.Error = e.str();
       return false;
     }
   }
 
   // Set permissions of the destination file.
-  mode_t permissions =
-    (match_properties.Permissions ? match_properties.Permissions
-                                  : this->FilePermissions);
-  if (!permissions) {
-    // No permissions were explicitly provided but the user requested
-    // that the source file permissions be used.
-    cmSystemTools::GetPermissions(fromFile, permissions);
+  return WritePermissions(this->Name, op.ToFile, op.Permissions,
+                          op.StorePermissionsStream, op.Error);
+}
+
+#if !defined(CMAKE_BOOTSTRAP)
+class cmFileCopier::CopyFilesJob : public cmWorkerPool::JobT
+{
+public:
+  CopyFilesJob(cmFileCopier const& copier, std::vector<FileOperation>& files,
+               std::size_t begin, std::size_t end)
+    : Copier(copier)
+    , Files(files)
+    , Begin(begin)
+    , End(end)
+  {
+  }
+
+  void Process() override
+  {
+    // Each job owns its range of operations, so no locking is needed.
+    for (std::size_t i = this->Begin; i != this->End; ++i) {
+      this->Copier.CopyOrLinkFile(this->Files[i]);
+    }
+  }
+
+private:
+  cmFileCopier const& Copier;
+  std::vector<FileOperation>& Files;
+  std::size_t Begin;
+  std::size_t End;
+};
+
+namespace {
+class CopyFilesDoneJob : public cmWorkerPool::JobFenceT
+{
+public:
+  void Process() override { this->Pool()->Abort(); }
+};
+}
+#endif
+
+void cmFileCopier::Report(const std::string& toFile, Type type, bool copy,
+                          bool queued)
+{
+  if (this->Jobs > 1) {
+    this->QueuedReports.push_back(QueuedReport{ toFile, type, copy, queued });
+    return;
+  }
+  this->ReportCopy(toFile, type, copy);
+}
+
+bool cmFileCopier::FinishQueuedFiles()
+{
+  std::vector<QueuedReport> reports;
+  reports.swap(this->QueuedReports);
+  if (this->QueuedFiles.empty()) {
+    for (QueuedReport const& r : reports) {
+      this->ReportCopy(r.ToFile, r.FileType, r.Copy);
+    }
+    return true;
+  }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  // Hand the files out in a few chunks per thread to balance uneven
+  // file sizes.
+  std::size_t const count = this->QueuedFiles.size();
+  std::size_t const chunks =
+    std::min<std::size_t>(count, std::size_t(this->Jobs) * 4);
+  cmWorkerPool pool;
+  pool.SetThreadCount(this->Jobs);
+  for (std::size_t c = 0; c != chunks; ++c) {
+    pool.EmplaceJob<CopyFilesJob>(*this, this->QueuedFiles,
+                                  count * c / chunks,
+                                  count * (c + 1) / chunks);
+  }
+  pool.EmplaceJob<CopyFilesDoneJob>();
+  pool.Process();
+#else
+  for (FileOperation& op : this->QueuedFiles) {
+    this->CopyOrLinkFile(op);
   }
-  return this->SetPermissions(toFile, permissions);
+#endif
+
+  // Report the files in the order they were given, up to the first
+  // copy that failed.
+  std::vector<FileOperation> files;
+  files.swap(this->QueuedFiles);
+  auto next = files.begin();
+  for (QueuedReport const& r : reports) {
+    if (r.Queued) {
+      if (!next->Error.empty()) {
+        this->Status.SetError(next->Error);
+        this->QueuedDirectoryPermissions.clear();
+        return false;
+      }
+      ++next;
+    }
+    this->ReportCopy(r.ToFile, r.FileType, r.Copy);
+  }
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->HashManifest) {
+    for (FileOperation const& op : files) {
+      this->HashManifest->Record(op.FromFile, op.ToFile, true);
+    }
+  }
+#endif
+
+  std::vector<std::pair<std::string, mode_t>> directories;
+  directories.swap(this->QueuedDirectoryPermissions);
+  for (auto const& dir : directories) {
+    if (!this->SetPermissions(dir.first, dir.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool cmFileCopier::LinkFile(const std::string& fromFile,
+                            const std::string& toFile, mode_t permissions)
+{
+  // A link shares the permissions of the source file, so link only if
+  // setting them on the destination will not change them.
+  mode_t const mask = 07777;
+  mode_t perm = 0;
+  if (!cmSystemTools::GetPermissions(fromFile, perm) ||
+      (perm & mask) != (permissions & mask)) {
+    return false;
+  }
+  cmSystemTools::RemoveFile(toFile);
+  std::string err;
+  return cmSystemTools::CreateLink(fromFile, toFile, &err);
 }
 
 bool cmFileCopier::InstallDirectory(const std::string& source,
@@ -639,7 +874,7 @@ bool cmFileCopier::InstallDirectory(const std::string& source,
                                     MatchProperties match_properties)
 {
   // Inform the user about this directory installation.
-  this->ReportCopy(destination, TypeDir,
+  this->Report(destination, TypeDir,
                    !cmSystemTools::FileIsDirectory(destination));
 
   // check if default dir creation permissions were set
@@ -707,6 +942,12 @@ bool cmFileCopier::InstallDirectory(const std::string& source,
     }
   }
 
-  // Set the requested permissions of the destination directory.
+  // Set the requested permissions of the destination directory.  If
+  // its files are still to be copied, do that after them.
+  if (permissions_after && !this->QueuedFiles.empty()) {
+    this->QueuedDirectoryPermissions.emplace_back(destination,
+                                                  permissions_after);
+    return true;
+  }
   return this->SetPermissions(destination, permissions_after);
 }
@@ -5,6 +5,7 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cmsys/RegularExpression.hxx"
@@ -14,6 +15,7 @@
 #include "cmFileTimeCache.h"
 
 class cmExecutionStatus;
+class cmInstallHashManifest;
 class cmMakefile;
 
 // File installation helper class.
@@ -34,6 +36,31 @@ protected:
   // Whether to install a file not matching any expression.
   bool MatchlessFiles;
 
+  // Whether to hard link files instead of copying them where possible.
+  bool LinkFiles;
+
+  // Number of threads to copy files with.  With more than one, files
+  // are queued and copied at the end, then reported.
+  unsigned int Jobs;
+
+  // Content of previously installed files, to skip those whose source
+  // was only touched.  Owned by the global generator.
+  cmInstallHashManifest* HashManifest;
+
+  // The work to place one file after deciding to install it.
+  struct FileOperation
+  {
+    std::string FromFile;
+    std::string ToFile;
+    mode_t Permissions = 0;
+    bool StorePermissionsStream = false;
+    bool Link = false;
+    bool CopyTime = false;
+    std::string Error;
+  };
+  std::vector<FileOperation> QueuedFiles;
+  std::vector<std::pair<std::string, mode_t>> QueuedDirectoryPermissions;
+
   // Permissions for files and directories installed by this object.
   mode_t FilePermissions;
   mode_t DirPermissions;
@@ -61,6 +88,10 @@ protected:
   MatchProperties CollectMatchProperties(const std::string& file);
 
   bool SetPermissions(const std::string& toFile, mode_t permissions);
+  bool StorePermissionsStream() const;
+  static bool WritePermissions(const char* name, const std::string& toFile,
+                               mode_t permissions, bool storeStream,
+                               std::string& error);
 
   // Translate an argument to a permissions bit.
   bool CheckPermissions(std::string const& arg, mode_t& permissions);
@@ -69,6 +100,11 @@ protected:
   bool InstallSymlink(const std::string& fromFile, const std::string& toFile);
   bool InstallFile(const std::string& fromFile, const std::string& toFile,
                    MatchProperties match_properties);
+  bool CopyOrLinkFile(FileOperation& op) const;
+  static bool LinkFile(const std::string& fromFile, const std::string& toFile,
+                       mode_t permissions);
+  bool InstallFiles();
+  bool FinishQueuedFiles();
   bool InstallDirectory(const std::string& source,
                         const std::string& destination,
                         MatchProperties match_properties);
@@ -82,6 +118,20 @@ protected:
     TypeLink
   };
   virtual void ReportCopy(const std::string&, Type, bool) {}
+
+  // Report a file now or, with several jobs, in order once the queued
+  // copies have finished.  The report of a queued copy that fails is
+  // dropped so it does not enter the install manifest.
+  void Report(const std::string& toFile, Type type, bool copy,
+              bool queued = false);
+  struct QueuedReport
+  {
+    std::string ToFile;
+    Type FileType;
+    bool Copy;
+    bool Queued;
+  };
+  std::vector<QueuedReport> QueuedReports;
   virtual bool ReportMissing(const std::string& fromFile);
 
   MatchRule* CurrentMatchRule;
@@ -118,4 +168,7 @@ protected:
   virtual void DefaultDirectoryPermissions();
 
   bool GetDefaultDirectoryPermissions(mode_t** mode);
+
+private:
+  class CopyFilesJob;
 };
@@ -9,10 +9,16 @@
 
 #include "cmExecutionStatus.h"
 #include "cmFSPermissions.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
+#include "cmProperty.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmInstallHashManifest.h"
+#endif
+
 using namespace cmFSPermissions;
 
 cmFileInstaller::cmFileInstaller(cmExecutionStatus& status)
@@ -133,6 +139,65 @@ bool cmFileInstaller::Parse(std::vector<std::string> const& args)
     return false;
   }
 
+  // Check whether to link files instead of copying them.  Installed
+  // targets are not linked because their files are edited afterwards.
+  std::string install_mode;
+  if (cmSystemTools::GetEnv("CMAKE_INSTALL_MODE", install_mode) &&
+      !install_mode.empty() && install_mode != "COPY") {
+    if (install_mode != "HARDLINK_OR_COPY") {
+      this->Status.SetError(cmStrCat("CMAKE_INSTALL_MODE environment "
+                                     "variable has unknown value \"",
+                                     install_mode, "\"."));
+      return false;
+    }
+    this->LinkFiles = this->InstallType == cmInstallType_FILES ||
+      this->InstallType == cmInstallType_PROGRAMS ||
+      this->InstallType == cmInstallType_DIRECTORY;
+#ifdef WIN32
+    // Permissions stored for cross-compiling would change the source.
+    if (this->Makefile->IsOn("CMAKE_CROSSCOMPILING")) {
+      this->LinkFiles = false;
+    }
+#endif
+  }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  // Check how many threads to copy files with.
+  std::string jobs =
+    this->Makefile->GetSafeDefinition("CMAKE_INSTALL_PARALLEL_LEVEL");
+  if (jobs.empty()) {
+    cmSystemTools::GetEnv("CMAKE_INSTALL_PARALLEL_LEVEL", jobs);
+  }
+  unsigned long numJobs = 0;
+  if (cmStrToULong(jobs, &numJobs) && numJobs > 1) {
+    this->Jobs = static_cast<unsigned int>(numJobs);
+  }
+
+  // Check whether to compare the content of files that are not older
+  // than their installation.
+  std::string install_compare;
+  if (cmSystemTools::GetEnv("CMAKE_INSTALL_COMPARE", install_compare) &&
+      !install_compare.empty() && install_compare != "TIMESTAMP") {
+    if (install_compare != "CONTENT") {
+      this->Status.SetError(cmStrCat("CMAKE_INSTALL_COMPARE environment "
+                                     "variable has unknown value \"",
+                                     install_compare, "\"."));
+      return false;
+    }
+    cmProp manifest =
+      this->Makefile->GetDefinition("CMAKE_INSTALL_HASH_MANIFEST");
+    if (cmNonempty(manifest)) {
+      this->HashManifest =
+        &this->Makefile->GetGlobalGenerator()->GetInstallHashManifest(
+          *manifest);
+      if (cmNonempty(
+            this->Makefile->GetDefinition("CMAKE_INSTALL_COMPONENT"))) {
+        this->HashManifest->KeepUnrecorded();
+      }
+    }
+  }
+#endif
+
   if (((this->MessageAlways ? 1 : 0) + (this->MessageLazy ? 1 : 0) +
        (this->MessageNever ? 1 : 0)) > 1) {
     this->Status.SetError("INSTALL options MESSAGE_ALWAYS, "
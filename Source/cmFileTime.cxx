@@ -15,6 +15,13 @@
 #endif
 
 bool cmFileTime::Load(std::string const& fileName)
+{
+  unsigned long long fileSize;
+  return this->Load(fileName, fileSize);
+}
+
+bool cmFileTime::Load(std::string const& fileName,
+                      unsigned long long& fileSize)
 {
 #if !defined(_WIN32) || defined(__CYGWIN__)
   // POSIX version.  Use the stat function.
@@ -32,6 +39,7 @@ bool cmFileTime::Load(std::string const& fileName)
   // Second resolution
   this->Time = fst.st_mtime * UtPerS;
 #  endif
+  fileSize = static_cast<unsigned long long>(fst.st_size);
 #else
   // Windows version.  Get the modification time from extended file attributes.
   WIN32_FILE_ATTRIBUTE_DATA fdata;
@@ -46,6 +54,7 @@ bool cmFileTime::Load(std::string const& fileName)
   this->Time = static_cast<TimeType>(
     (uint64(fdata.ftLastWriteTime.dwHighDateTime) << 32) +
     fdata.ftLastWriteTime.dwLowDateTime);
+  fileSize = (uint64(fdata.nFileSizeHigh) << 32) + fdata.nFileSizeLow;
 #endif
   return true;
 }
@@ -31,6 +31,13 @@ public:
    */
   bool Load(std::string const& fileName);
 
+  /**
+   * @brief Loads the file time and the size of fileName from the file
+   *        system
+   * @return true on success
+   */
+  bool Load(std::string const& fileName, unsigned long long& fileSize);
+
   /**
    * @brief Return true if this is older than ftm
    */
@@ -9,6 +9,7 @@
 
 #include <cmext/algorithm>
 
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmProperty.h"
 #include "cmRange.h"
@@ -23,6 +24,7 @@ class cmExecutionStatus;
 cmFindBase::cmFindBase(cmExecutionStatus& status)
   : cmFindCommon(status)
 {
+  this->Makefile->GetGlobalGenerator()->BeginFindSearch();
 }
 
 bool cmFindBase::ParseArguments(std::vector<std::string> const& argsIn)
@@ -8,6 +8,8 @@
 #include <set>
 #include <utility>
 
+#include <cm/optional>
+
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmGlobalGenerator.h"
@@ -18,6 +20,11 @@
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmMakefileProfilingData.h"
+#endif
 
 class cmExecutionStatus;
 
@@ -193,6 +200,14 @@ void cmFindLibraryCommand::AddArchitecturePath(
 
 std::string cmFindLibraryCommand::FindLibrary()
 {
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(
+      this->Makefile->GetCMakeInstance()->GetProfilingOutput(), "find",
+      "find_library search");
+  }
+#endif
   std::string library;
   if (this->SearchFrameworkFirst || this->SearchFrameworkOnly) {
     library = this->FindFrameworkLibrary();
@@ -405,7 +420,8 @@ bool cmFindLibraryHelper::CheckDirectoryForName(std::string const& path,
   if (name.TryRaw) {
     this->TestPath = cmStrCat(path, name.Raw);
 
-    const bool exists = cmSystemTools::FileExists(this->TestPath, true);
+    const bool exists = this->GG->DirectoryMayContain(path, name.Raw) &&
+      cmSystemTools::FileExists(this->TestPath, true);
     if (!exists) {
       this->DebugLibraryFailed(name.Raw, path);
     } else {
@@ -13,6 +13,7 @@
 #include <utility>
 
 #include <cm/memory>
+#include <cm/optional>
 #include <cmext/string_view>
 
 #include "cmsys/Directory.hxx"
@@ -33,6 +34,12 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmVersion.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmMakefileProfilingData.h"
+#  include "cmTryCompileBatch.h"
+#endif
 
 #if defined(__HAIKU__)
 #  include <FindDirectory.h>
@@ -1079,6 +1086,14 @@ bool cmFindPackageCommand::HandlePackageMode(
 
 bool cmFindPackageCommand::FindConfig()
 {
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(
+      this->Makefile->GetCMakeInstance()->GetProfilingOutput(), "find",
+      "find_package config search");
+  }
+#endif
   // Compute the set of search prefixes.
   this->ComputePrefixes();
 
@@ -1172,7 +1187,19 @@ bool cmFindPackageCommand::ReadListFile(const std::string& f,
                                         PolicyScopeRule psr)
 {
   const bool noPolicyScope = !this->PolicyScope || psr == NoPolicyScope;
-  if (this->Makefile->ReadDependentFile(f, noPolicyScope)) {
+#if !defined(CMAKE_BOOTSTRAP)
+  // Find modules and package configuration files use the results of
+  // their checks right away, so they run outside of a try_compile batch.
+  std::unique_ptr<cmTryCompileBatch> batch =
+    this->Makefile->TakeTryCompileBatch();
+#endif
+  bool const result = this->Makefile->ReadDependentFile(f, noPolicyScope);
+#if !defined(CMAKE_BOOTSTRAP)
+  if (batch) {
+    this->Makefile->SetTryCompileBatch(std::move(batch));
+  }
+#endif
+  if (result) {
     return true;
   }
   std::string e = cmStrCat("Error reading CMake code from \"", f, "\".");
@@ -2,13 +2,21 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmFindPathCommand.h"
 
+#include <cm/optional>
+
 #include "cmsys/Glob.hxx"
 
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmMakefileProfilingData.h"
+#endif
 
 class cmExecutionStatus;
 
@@ -65,6 +73,14 @@ bool cmFindPathCommand::InitialPass(std::vector<std::string> const& argsIn)
 std::string cmFindPathCommand::FindHeader()
 {
   std::string debug_name = this->IncludeFileInPath ? "find_file" : "find_path";
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(
+      this->Makefile->GetCMakeInstance()->GetProfilingOutput(), "find",
+      cmStrCat(debug_name, " search"));
+  }
+#endif
   cmFindBaseDebugState debug(debug_name, this);
   std::string header;
   if (this->SearchFrameworkFirst || this->SearchFrameworkOnly) {
@@ -134,7 +150,8 @@ std::string cmFindPathCommand::FindNormalHeader(cmFindBaseDebugState& debug)
   for (std::string const& n : this->Names) {
     for (std::string const& sp : this->SearchPaths) {
       tryPath = cmStrCat(sp, n);
-      if (cmSystemTools::FileExists(tryPath)) {
+      if (this->Makefile->GetGlobalGenerator()->DirectoryMayContain(sp, n) &&
+          cmSystemTools::FileExists(tryPath)) {
         debug.FoundAt(tryPath);
         if (this->IncludeFileInPath) {
           return tryPath;
@@ -5,12 +5,20 @@
 #include <algorithm>
 #include <string>
 
+#include <cm/optional>
+
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
 #include "cmPolicies.h"
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmMakefileProfilingData.h"
+#endif
 
 class cmExecutionStatus;
 
@@ -90,7 +98,10 @@ struct cmFindProgramHelper
                          this->TestNameExt = cmStrCat(name, ext);
                          this->TestPath = cmSystemTools::CollapseFullPath(
                            this->TestNameExt, path);
-                         bool exists = this->FileIsExecutable(this->TestPath);
+                         bool exists =
+                           this->Makefile->GetGlobalGenerator()
+                             ->DirectoryMayContain(path, this->TestNameExt) &&
+                           this->FileIsExecutable(this->TestPath);
                          exists ? this->DebugSearches.FoundAt(this->TestPath)
                                 : this->DebugSearches.FailedAt(this->TestPath);
                          if (exists) {
@@ -196,6 +207,14 @@ bool cmFindProgramCommand::InitialPass(std::vector<std::string> const& argsIn)
 
 std::string cmFindProgramCommand::FindProgram()
 {
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(
+      this->Makefile->GetCMakeInstance()->GetProfilingOutput(), "find",
+      "find_program search");
+  }
+#endif
   std::string program;
 
   if (this->SearchAppBundleFirst || this->SearchAppBundleOnly) {
@@ -25,6 +25,7 @@
 #include "cmListFileCache.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
+#include "cmPlainList.h"
 #include "cmProperty.h"
 #include "cmRange.h"
 #include "cmStringAlgorithms.h"
@@ -325,7 +326,14 @@ bool HandleInMode(std::vector<std::string> const& args,
 
     } else if (doing == DoingLists) {
       auto const& value = makefile.GetSafeDefinition(arg);
-      if (!value.empty()) {
+      if (cmPlainList const* list = makefile.GetDefinitionList(arg)) {
+        // Use the elements already split, including empty ones.
+        fb->Args.reserve(fb->Args.size() + list->size());
+        for (std::size_t i = 0; i < list->size(); ++i) {
+          cm::string_view element = (*list)[i];
+          fb->Args.emplace_back(element.data(), element.size());
+        }
+      } else if (!value.empty()) {
         cmExpandList(value, fb->Args, true);
       }
 
@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmGccDepfileLexerHelper.h"
 
+#include <cstddef>
 #include <cstdio>
 #include <memory>
 #include <string>
@@ -39,6 +40,141 @@ bool cmGccDepfileLexerHelper::readFile(const char* filePath)
   return this->HelperState != State::Failed;
 }
 
+namespace {
+// Length of the newline at the given position, or 0 if there is none.
+std::size_t NewlineLength(const char* p, const char* end)
+{
+  if (p != end && *p == '\n') {
+    return 1;
+  }
+  if (end - p >= 2 && p[0] == '\r' && p[1] == '\n') {
+    return 2;
+  }
+  return 0;
+}
+
+bool IsBlank(char c)
+{
+  return c == ' ' || c == '\t';
+}
+
+// Characters that start a token other than plain text.
+bool IsSpecial(char c)
+{
+  return c == '$' || c == '\\' || c == ' ' || c == '\t' || c == ':' ||
+    c == '\r' || c == '\n';
+}
+}
+
+bool cmGccDepfileLexerHelper::parseContent(cm::string_view content)
+{
+  // Each case matches the longest token that the rules of
+  // cmGccDepfileLexer.in.l match at the same position, and has the same
+  // effect.  Runs of plain text are appended at once.
+  this->newEntry();
+  const char* p = content.data();
+  const char* const end = p + content.size();
+  while (p != end) {
+    switch (*p) {
+      case '$':
+        if (end - p >= 2 && p[1] == '$') {
+          // Unescape the dollar sign.
+          this->addToCurrentPath("$");
+          p += 2;
+          continue;
+        }
+        break;
+      case '\\': {
+        const char* q = p;
+        while (q != end && *q == '\\') {
+          ++q;
+        }
+        std::size_t const count = static_cast<std::size_t>(q - p);
+        if (q != end && *q == ' ') {
+          if (count % 2 == 1) {
+            // 2N+1 backslashes plus space -> N backslashes plus space.
+            std::string s(count / 2, '\\');
+            s.push_back(' ');
+            this->addToCurrentPath(s);
+          } else {
+            // 2N backslashes plus space -> 2N backslashes, end of filename.
+            this->addToCurrentPath(cm::string_view(p, count));
+            this->newDependency();
+          }
+          p = q + 1;
+          continue;
+        }
+        if (std::size_t const n = NewlineLength(p + 1, end)) {
+          // A line continuation ends the current file name.
+          this->newRuleOrDependency();
+          p += 1 + n;
+          continue;
+        }
+        if (end - p >= 2 && p[1] == '#') {
+          // Unescape the hash.
+          this->addToCurrentPath("#");
+          p += 2;
+          continue;
+        }
+        this->addToCurrentPath("\\");
+        ++p;
+        continue;
+      }
+      case ' ':
+      case '\t': {
+        const char* q = p;
+        while (q != end && IsBlank(*q)) {
+          ++q;
+        }
+        if (q != end && *q == '\\') {
+          if (std::size_t const n = NewlineLength(q + 1, end)) {
+            // A line continuation ends the current file name.
+            this->newRuleOrDependency();
+            p = q + 1 + n;
+            continue;
+          }
+        }
+        // Rules and dependencies are separated by blocks of whitespace.
+        this->newRuleOrDependency();
+        p = q;
+        continue;
+      }
+      case ':':
+        if (end - p >= 2 && IsBlank(p[1])) {
+          // A colon followed by space ends the rules and starts a new
+          // dependency.
+          p += 2;
+          while (p != end && IsBlank(*p)) {
+            ++p;
+          }
+          this->newDependency();
+          continue;
+        }
+        break;
+      case '\r':
+      case '\n':
+        if (std::size_t const n = NewlineLength(p, end)) {
+          // A newline ends the current file name and the current rule.
+          this->newEntry();
+          p += n;
+          continue;
+        }
+        break;
+      default:
+        break;
+    }
+    // Got a span of plain text.
+    const char* q = p + 1;
+    while (q != end && !IsSpecial(*q)) {
+      ++q;
+    }
+    this->addToCurrentPath(cm::string_view(p, q - p));
+    p = q;
+  }
+  this->sanitizeContent();
+  return this->HelperState != State::Failed;
+}
+
 void cmGccDepfileLexerHelper::newEntry()
 {
   if (this->HelperState == State::Rule && !this->Content.empty()) {
@@ -82,7 +218,7 @@ void cmGccDepfileLexerHelper::newRuleOrDependency()
   }
 }
 
-void cmGccDepfileLexerHelper::addToCurrentPath(const char* s)
+void cmGccDepfileLexerHelper::addToCurrentPath(cm::string_view s)
 {
   if (this->Content.empty()) {
     return;
@@ -105,7 +241,7 @@ void cmGccDepfileLexerHelper::addToCurrentPath(const char* s)
     case State::Failed:
       return;
   }
-  dst->append(s);
+  dst->append(s.data(), s.size());
 }
 
 void cmGccDepfileLexerHelper::sanitizeContent()
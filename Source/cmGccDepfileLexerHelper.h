@@ -4,6 +4,8 @@
 
 #include <utility>
 
+#include <cm/string_view>
+
 #include <cmGccDepfileReaderTypes.h>
 
 class cmGccDepfileLexerHelper
@@ -11,7 +13,12 @@ class cmGccDepfileLexerHelper
 public:
   cmGccDepfileLexerHelper() = default;
 
+  // Read a file with the flex generated lexer.
   bool readFile(const char* filePath);
+
+  // Parse content with a hand-written equivalent of the lexer.
+  bool parseContent(cm::string_view content);
+
   cmGccDepfileContent extractContent() && { return std::move(this->Content); }
 
   // Functions called by the lexer
@@ -19,7 +26,7 @@ public:
   void newRule();
   void newDependency();
   void newRuleOrDependency();
-  void addToCurrentPath(const char* s);
+  void addToCurrentPath(cm::string_view s);
 
 private:
   void sanitizeContent();
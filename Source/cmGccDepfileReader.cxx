@@ -7,40 +7,65 @@
 #include <vector>
 
 #include <cm/optional>
+#include <cm/string_view>
 
 #include "cmGccDepfileLexerHelper.h"
+#include "cmMappedFile.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
-cm::optional<cmGccDepfileContent> cmReadGccDepfile(const char* filePath,
-                                                   const std::string& prefix)
+cm::optional<cmGccDepfileContent> cmGccDepfileReader::Read(
+  const char* filePath, const std::string& prefix)
 {
+  cmMappedFile file;
+  if (!file.Open(filePath)) {
+    // Empty files cannot be mapped.
+    std::string const path = filePath;
+    if (!cmSystemTools::FileExists(path, true) ||
+        cmSystemTools::FileLength(path) != 0) {
+      return cm::nullopt;
+    }
+  }
   cmGccDepfileLexerHelper helper;
-  if (!helper.readFile(filePath)) {
+  if (!helper.parseContent(file.View())) {
     return cm::nullopt;
   }
+  file.Close();
   auto deps = cm::make_optional(std::move(helper).extractContent());
 
   for (auto& dep : *deps) {
     for (auto& rule : dep.rules) {
-      if (!prefix.empty() && !cmSystemTools::FileIsFullPath(rule)) {
-        rule = cmStrCat(prefix, '/', rule);
-      }
-      if (cmSystemTools::FileIsFullPath(rule)) {
-        rule = cmSystemTools::CollapseFullPath(rule);
-      }
-      cmSystemTools::ConvertToLongPath(rule);
+      this->Normalize(rule, prefix);
     }
     for (auto& path : dep.paths) {
-      if (!prefix.empty() && !cmSystemTools::FileIsFullPath(path)) {
-        path = cmStrCat(prefix, '/', path);
-      }
-      if (cmSystemTools::FileIsFullPath(path)) {
-        path = cmSystemTools::CollapseFullPath(path);
-      }
-      cmSystemTools::ConvertToLongPath(path);
+      this->Normalize(path, prefix);
     }
   }
 
   return deps;
 }
+
+void cmGccDepfileReader::Normalize(std::string& path,
+                                   const std::string& prefix)
+{
+  if (!prefix.empty() && !cmSystemTools::FileIsFullPath(path)) {
+    path = cmStrCat(prefix, '/', path);
+  }
+  auto i = this->NormalizedPaths.find(path);
+  if (i == this->NormalizedPaths.end()) {
+    std::string normalized = path;
+    if (cmSystemTools::FileIsFullPath(normalized)) {
+      normalized = cmSystemTools::CollapseFullPath(normalized);
+    }
+    cmSystemTools::ConvertToLongPath(normalized);
+    i = this->NormalizedPaths.emplace(path, std::move(normalized)).first;
+  }
+  path = i->second;
+}
+
+cm::optional<cmGccDepfileContent> cmReadGccDepfile(const char* filePath,
+                                                   const std::string& prefix)
+{
+  cmGccDepfileReader reader;
+  return reader.Read(filePath, prefix);
+}
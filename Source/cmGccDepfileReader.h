@@ -3,11 +3,34 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 
 #include <cm/optional>
 
 #include "cmGccDepfileReaderTypes.h"
 
+/** \class cmGccDepfileReader
+ * \brief Reads dependencies files and normalizes the paths they list.
+ *
+ * The files are memory-mapped and parsed in place.  The normalization of
+ * each path is computed once per reader, so a reader used for many files
+ * of the same build saves most of that work.
+ */
+class cmGccDepfileReader
+{
+public:
+  /*
+   * Read dependencies file and append prefix to all relative paths
+   */
+  cm::optional<cmGccDepfileContent> Read(const char* filePath,
+                                         const std::string& prefix = {});
+
+private:
+  void Normalize(std::string& path, const std::string& prefix);
+
+  std::unordered_map<std::string, std::string> NormalizedPaths;
+};
+
 /*
  * Read dependencies file and append prefix to all relative paths
  */
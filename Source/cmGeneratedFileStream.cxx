@@ -3,6 +3,7 @@
 #include "cmGeneratedFileStream.h"
 
 #include <cstdio>
+#include <utility>
 
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
@@ -76,6 +77,13 @@ cmGeneratedFileStream& cmGeneratedFileStream::Open(std::string const& name,
   return *this;
 }
 
+void cmGeneratedFileStream::SetBufferSize(std::size_t size)
+{
+  this->Buffer.resize(size);
+  this->rdbuf()->pubsetbuf(this->Buffer.data(),
+                           static_cast<std::streamsize>(size));
+}
+
 bool cmGeneratedFileStream::Close()
 {
   // Save whether the temporary output file is valid before closing.
@@ -144,8 +152,6 @@ void cmGeneratedFileStreamBase::Open(std::string const& name)
 
 bool cmGeneratedFileStreamBase::Close()
 {
-  bool replaced = false;
-
   std::string resname = this->Name;
   if (this->Compress && this->CompressExtraExtension) {
     resname += ".gz";
@@ -153,32 +159,96 @@ bool cmGeneratedFileStreamBase::Close()
 
   // Only consider replacing the destination file if no error
   // occurred.
-  if (!this->Name.empty() && this->Okay &&
-      (!this->CopyIfDifferent ||
-       cmSystemTools::FilesDiffer(this->TempName, resname))) {
+  if (!this->Name.empty() && this->Okay) {
+    Replacement replacement;
+    replacement.TempName = this->TempName;
+    replacement.Name = resname;
+    replacement.CopyIfDifferent = this->CopyIfDifferent;
+    replacement.Compress = this->Compress;
+
+    if (this->DeferredReplacements) {
+      // Keep the temporary file for the deferred replacement and make
+      // sure a later call does not consider it again.
+      this->DeferredReplacements->Record(std::move(replacement));
+      this->Name.clear();
+      this->TempName.clear();
+      return false;
+    }
+
+    return Replace(replacement);
+  }
+
+  // Else, the destination was not replaced.
+  //
+  // Always delete the temporary file. We never want it to stay around.
+  if (!this->TempName.empty()) {
+    cmSystemTools::RemoveFile(this->TempName);
+  }
+
+  return false;
+}
+
+bool cmGeneratedFileStreamBase::Replace(Replacement const& replacement)
+{
+  bool replaced = false;
+  if (!replacement.CopyIfDifferent ||
+      cmSystemTools::FilesDiffer(replacement.TempName, replacement.Name)) {
     // The destination is to be replaced.  Rename the temporary to the
     // destination atomically.
-    if (this->Compress) {
-      std::string gzname = cmStrCat(this->TempName, ".temp.gz");
-      if (this->CompressFile(this->TempName, gzname)) {
-        this->RenameFile(gzname, resname);
+    if (replacement.Compress) {
+      std::string gzname = cmStrCat(replacement.TempName, ".temp.gz");
+      if (CompressFile(replacement.TempName, gzname)) {
+        RenameFile(gzname, replacement.Name);
       }
       cmSystemTools::RemoveFile(gzname);
     } else {
-      this->RenameFile(this->TempName, resname);
+      RenameFile(replacement.TempName, replacement.Name);
     }
 
     replaced = true;
   }
 
-  // Else, the destination was not replaced.
-  //
   // Always delete the temporary file. We never want it to stay around.
-  cmSystemTools::RemoveFile(this->TempName);
+  cmSystemTools::RemoveFile(replacement.TempName);
 
   return replaced;
 }
 
+void cmGeneratedFileStream::SetDeferredReplacements(
+  cmGeneratedFileReplacements* replacements)
+{
+  this->DeferredReplacements = replacements;
+}
+
+cmGeneratedFileReplacements::~cmGeneratedFileReplacements()
+{
+  for (auto const& entry : this->Replacements) {
+    cmSystemTools::RemoveFile(entry.second.TempName);
+  }
+}
+
+void cmGeneratedFileReplacements::Record(Replacement replacement)
+{
+  Replacement& recorded = this->Replacements[replacement.Name];
+  if (!recorded.TempName.empty() &&
+      recorded.TempName != replacement.TempName) {
+    cmSystemTools::RemoveFile(recorded.TempName);
+  }
+  recorded = std::move(replacement);
+}
+
+std::vector<cmGeneratedFileReplacements::Replacement>
+cmGeneratedFileReplacements::Take()
+{
+  std::vector<Replacement> replacements;
+  replacements.reserve(this->Replacements.size());
+  for (auto& entry : this->Replacements) {
+    replacements.emplace_back(std::move(entry.second));
+  }
+  this->Replacements.clear();
+  return replacements;
+}
+
 #ifndef CMAKE_BOOTSTRAP
 int cmGeneratedFileStreamBase::CompressFile(std::string const& oldname,
                                             std::string const& newname)
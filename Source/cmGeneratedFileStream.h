@@ -4,17 +4,38 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "cmsys/FStream.hxx"
 
 #include "cm_codecvt.hxx"
 
+class cmGeneratedFileReplacements;
+
 // This is the first base class of cmGeneratedFileStream.  It will be
 // created before and destroyed after the ofstream portion and can
 // therefore be used to manage the temporary file.
 class cmGeneratedFileStreamBase
 {
+public:
+  // A replacement of a destination file by a temporary file whose
+  // content is complete.
+  struct Replacement
+  {
+    std::string TempName;
+    std::string Name;
+    bool CopyIfDifferent = false;
+    bool Compress = false;
+  };
+
+  // Perform a replacement.  Returns whether the destination was replaced.
+  // This does not touch any shared state and may be called concurrently
+  // for distinct destinations.
+  static bool Replace(Replacement const& replacement);
+
 protected:
   // This constructor does not prepare the temporary file.  The open
   // method must be used.
@@ -34,10 +55,12 @@ protected:
   bool Close();
 
   // Internal file replacement implementation.
-  int RenameFile(std::string const& oldname, std::string const& newname);
+  static int RenameFile(std::string const& oldname,
+                        std::string const& newname);
 
   // Internal file compression implementation.
-  int CompressFile(std::string const& oldname, std::string const& newname);
+  static int CompressFile(std::string const& oldname,
+                          std::string const& newname);
 
   // The name of the final destination file for the output.
   std::string Name;
@@ -59,6 +82,13 @@ protected:
 
   // Whether the destination file is compressed
   bool CompressExtraExtension = true;
+
+  // Where to record the replacement instead of performing it, if set.
+  cmGeneratedFileReplacements* DeferredReplacements = nullptr;
+
+  // Storage of a custom stream buffer.  It must outlive the ofstream
+  // portion, which flushes the buffer when it is destroyed.
+  std::vector<char> Buffer;
 };
 
 /** \class cmGeneratedFileStream
@@ -112,6 +142,12 @@ public:
   cmGeneratedFileStream& Open(std::string const& name, bool quiet = false,
                               bool binaryFlag = false);
 
+  /**
+   * Write through a buffer of the given size instead of the default
+   * one.  This must be called before the stream is opened.
+   */
+  void SetBufferSize(std::size_t size);
+
   /**
    * Close the output file.  This should be used only with an open
    * stream.  The temporary file is atomically renamed to the
@@ -153,7 +189,47 @@ public:
    */
   void WriteRaw(std::string const& data);
 
+  /**
+   * Record the replacement of the destination file in the given list
+   * when the stream is closed instead of performing it.  Close then
+   * returns false.  Pass nullptr to replace the file on close.
+   */
+  void SetDeferredReplacements(cmGeneratedFileReplacements* replacements);
+
 private:
   // The original locale of the stream (performs no encoding conversion).
   std::locale OriginalLocale;
 };
+
+/** \class cmGeneratedFileReplacements
+ * \brief Replacements of generated files to be performed later.
+ *
+ * Streams given to SetDeferredReplacements leave their temporary files
+ * in place and record the replacements here.  If several streams write
+ * the same destination only the last one is kept.  Replacements that are
+ * not taken are dropped with their temporary files.
+ */
+class cmGeneratedFileReplacements
+{
+public:
+  using Replacement = cmGeneratedFileStreamBase::Replacement;
+
+  cmGeneratedFileReplacements() = default;
+  ~cmGeneratedFileReplacements();
+
+  cmGeneratedFileReplacements(cmGeneratedFileReplacements const&) = delete;
+  cmGeneratedFileReplacements& operator=(cmGeneratedFileReplacements const&) =
+    delete;
+
+  void Record(Replacement replacement);
+
+  /**
+   * Return the recorded replacements ordered by destination file name
+   * and forget them.  The caller passes each of them to
+   * cmGeneratedFileStreamBase::Replace, possibly concurrently.
+   */
+  std::vector<Replacement> Take();
+
+private:
+  std::map<std::string, Replacement> Replacements;
+};
@@ -4,8 +4,11 @@
 
 #include <cassert>
 #include <memory>
+#include <tuple>
 #include <utility>
 
+#include <cm/optional>
+
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmGeneratorExpressionContext.h"
@@ -13,8 +16,15 @@
 #include "cmGeneratorExpressionEvaluator.h"
 #include "cmGeneratorExpressionLexer.h"
 #include "cmGeneratorExpressionParser.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmMakefileProfilingData.h"
+#endif
 
 cmGeneratorExpression::cmGeneratorExpression(cmListFileBacktrace backtrace)
   : Backtrace(std::move(backtrace))
@@ -52,12 +62,69 @@ const std::string& cmCompiledGeneratorExpression::Evaluate(
   cmGeneratorExpressionDAGChecker* dagChecker,
   const cmGeneratorTarget* currentTarget, std::string const& language) const
 {
+  if (!this->NeedsEvaluation) {
+    return this->Input;
+  }
+  if (!this->Parsed) {
+    this->Parsed = lg
+      ? lg->GetGlobalGenerator()->GetGeneratorExpressionParseCache().Get(
+          this->Input)
+      : cmGeneratorExpressionParseCache::Parse(this->Input);
+    this->NeedsEvaluation = this->Parsed->NeedsEvaluation;
+    if (!this->NeedsEvaluation) {
+      return this->Input;
+    }
+  }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (lg && lg->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(lg->GetCMakeInstance()->GetProfilingOutput(),
+                          "genex", "evaluate generator expression");
+  }
+#endif
+
   cmGeneratorExpressionContext context(
     lg, config, this->Quiet, headTarget,
     currentTarget ? currentTarget : headTarget, this->EvaluateForBuildsystem,
     this->Backtrace, language);
 
-  return this->EvaluateWithContext(context, dagChecker);
+  if (!lg) {
+    return this->EvaluateWithContext(context, dagChecker);
+  }
+
+  cmGeneratorExpressionResultCache& cache =
+    lg->GetGeneratorExpressionResultCache();
+  cmGeneratorExpressionResultCache::Key key{ this->Parsed, config,
+                                             language, headTarget,
+                                             context.CurrentTarget };
+  if (cmGeneratorExpressionResultCache::Result const* cached =
+        cache.Find(key)) {
+    this->Output = cached->Output;
+    this->DependTargets.clear();
+    this->AllTargetsSeen.clear();
+    this->MaxLanguageStandard.clear();
+    this->HadContextSensitiveCondition = cached->HadContextSensitiveCondition;
+    this->HadHeadSensitiveCondition = cached->HadHeadSensitiveCondition;
+    this->HadLinkLanguageSensitiveCondition =
+      cached->HadLinkLanguageSensitiveCondition;
+    this->SourceSensitiveTargets.clear();
+    return this->Output;
+  }
+
+  this->EvaluateWithContext(context, dagChecker);
+
+  if (!context.HadError && !context.HadUncacheableNode &&
+      context.DependTargets.empty() && context.AllTargets.empty() &&
+      context.SeenTargetProperties.empty() &&
+      context.SourceSensitiveTargets.empty() &&
+      context.MaxLanguageStandard.empty()) {
+    cache.Store(std::move(key),
+                { this->Output, context.HadContextSensitiveCondition,
+                  context.HadHeadSensitiveCondition,
+                  context.HadLinkLanguageSensitiveCondition });
+  }
+  return this->Output;
 }
 
 const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
@@ -70,7 +137,7 @@ const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
 
   this->Output.clear();
 
-  for (const auto& it : this->Evaluators) {
+  for (const auto& it : this->Parsed->Evaluators) {
     this->Output += it->Evaluate(&context, dagChecker);
 
     this->SeenTargetProperties.insert(context.SeenTargetProperties.cbegin(),
@@ -96,24 +163,65 @@ const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
   return this->Output;
 }
 
+std::shared_ptr<cmGeneratorExpressionParseCache::Parsed const>
+cmGeneratorExpressionParseCache::Get(std::string const& input)
+{
+  auto it = this->Entries.find(input);
+  if (it == this->Entries.end()) {
+    std::shared_ptr<Parsed const> parsed = Parse(input);
+    it = this->Entries.emplace(parsed->Input, std::move(parsed)).first;
+  }
+  return it->second;
+}
+
+std::shared_ptr<cmGeneratorExpressionParseCache::Parsed const>
+cmGeneratorExpressionParseCache::Parse(std::string input)
+{
+  // The evaluators point into the input, which stays put with its entry.
+  auto parsed = std::make_shared<Parsed>();
+  parsed->Input = std::move(input);
+  cmGeneratorExpressionLexer l;
+  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(parsed->Input);
+  parsed->NeedsEvaluation = l.GetSawGeneratorExpression();
+  if (parsed->NeedsEvaluation) {
+    cmGeneratorExpressionParser p(tokens);
+    p.Parse(parsed->Evaluators);
+  }
+  return parsed;
+}
+
 cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
   cmListFileBacktrace backtrace, std::string input)
   : Backtrace(std::move(backtrace))
   , Input(std::move(input))
+  , NeedsEvaluation(false)
   , EvaluateForBuildsystem(false)
   , Quiet(false)
   , HadContextSensitiveCondition(false)
   , HadHeadSensitiveCondition(false)
   , HadLinkLanguageSensitiveCondition(false)
 {
-  cmGeneratorExpressionLexer l;
-  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
-  this->NeedsEvaluation = l.GetSawGeneratorExpression();
+  this->NeedsEvaluation = this->Input.find("$<") != std::string::npos;
+}
 
-  if (this->NeedsEvaluation) {
-    cmGeneratorExpressionParser p(tokens);
-    p.Parse(this->Evaluators);
-  }
+bool cmGeneratorExpressionResultCache::Key::operator<(Key const& other) const
+{
+  return std::tie(this->Expression, this->HeadTarget, this->CurrentTarget,
+                  this->Config, this->Language) <
+    std::tie(other.Expression, other.HeadTarget, other.CurrentTarget,
+             other.Config, other.Language);
+}
+
+cmGeneratorExpressionResultCache::Result const*
+cmGeneratorExpressionResultCache::Find(Key const& key) const
+{
+  auto it = this->Results.find(key);
+  return it != this->Results.end() ? &it->second : nullptr;
+}
+
+void cmGeneratorExpressionResultCache::Store(Key key, Result result)
+{
+  this->Results.emplace(std::move(key), std::move(result));
 }
 
 std::string cmGeneratorExpression::StripEmptyListElements(
@@ -8,9 +8,12 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <cm/string_view>
+
 #include "cmListFileCache.h"
 
 class cmCompiledGeneratorExpression;
@@ -85,6 +88,34 @@ private:
   cmListFileBacktrace Backtrace;
 };
 
+/** \class cmGeneratorExpressionParseCache
+ * \brief Parsed generator expressions of a global generator.
+ *
+ * The same property strings are parsed over and over for every target,
+ * configuration, and language.  Parsing depends on nothing but the input,
+ * so each distinct string is parsed once.  Compiled expressions share
+ * ownership of their parsed form and may outlive the cache.
+ */
+class cmGeneratorExpressionParseCache
+{
+public:
+  struct Parsed
+  {
+    std::string Input;
+    bool NeedsEvaluation = false;
+    std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>> Evaluators;
+  };
+
+  std::shared_ptr<Parsed const> Get(std::string const& input);
+
+  /** Parse an input without keeping it.  */
+  static std::shared_ptr<Parsed const> Parse(std::string input);
+
+private:
+  // The keys view the input of their entry.
+  std::unordered_map<cm::string_view, std::shared_ptr<Parsed const>> Entries;
+};
+
 class cmCompiledGeneratorExpression
 {
 public:
@@ -158,9 +189,12 @@ private:
   friend class cmGeneratorExpression;
 
   cmListFileBacktrace Backtrace;
-  std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>> Evaluators;
   const std::string Input;
-  bool NeedsEvaluation;
+  // Parsed form of the input, shared by every expression with the same
+  // input string.  It is looked up on first evaluation.
+  mutable std::shared_ptr<cmGeneratorExpressionParseCache::Parsed const>
+    Parsed;
+  mutable bool NeedsEvaluation;
   bool EvaluateForBuildsystem;
   bool Quiet;
 
@@ -177,6 +211,44 @@ private:
   mutable std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
 };
 
+/** \class cmGeneratorExpressionResultCache
+ * \brief Memoizes results of generator expressions for a local generator.
+ *
+ * A result is stored only when every node evaluated to produce it depends
+ * on nothing but its parameters and the entries of the key.  Expressions
+ * that read target properties, find targets, consult the dependency graph
+ * checker, or issue diagnostics are always evaluated.
+ */
+class cmGeneratorExpressionResultCache
+{
+public:
+  struct Key
+  {
+    std::shared_ptr<cmGeneratorExpressionParseCache::Parsed const>
+      Expression;
+    std::string Config;
+    std::string Language;
+    cmGeneratorTarget const* HeadTarget;
+    cmGeneratorTarget const* CurrentTarget;
+
+    bool operator<(Key const& other) const;
+  };
+
+  struct Result
+  {
+    std::string Output;
+    bool HadContextSensitiveCondition;
+    bool HadHeadSensitiveCondition;
+    bool HadLinkLanguageSensitiveCondition;
+  };
+
+  Result const* Find(Key const& key) const;
+  void Store(Key key, Result result);
+
+private:
+  std::map<Key, Result> Results;
+};
+
 class cmGeneratorExpressionInterpreter
 {
 public:
@@ -20,6 +20,7 @@ cmGeneratorExpressionContext::cmGeneratorExpressionContext(
   , HadContextSensitiveCondition(false)
   , HadHeadSensitiveCondition(false)
   , HadLinkLanguageSensitiveCondition(false)
+  , HadUncacheableNode(false)
   , EvaluateForBuildsystem(evaluateForBuildsystem)
 {
 }
@@ -40,5 +40,7 @@ struct cmGeneratorExpressionContext
   bool HadContextSensitiveCondition;
   bool HadHeadSensitiveCondition;
   bool HadLinkLanguageSensitiveCondition;
+  // Set when a node whose result may not be memoized was evaluated.
+  bool HadUncacheableNode;
   bool EvaluateForBuildsystem;
 };
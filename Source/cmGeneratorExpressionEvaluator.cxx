@@ -80,6 +80,10 @@ std::string GeneratorExpressionContent::Evaluate(
     return std::string();
   }
 
+  if (!node->SupportsResultCache()) {
+    context->HadUncacheableNode = true;
+  }
+
   if (!node->GeneratesContent()) {
     if (node->NumExpectedParameters() == 1 &&
         node->AcceptsArbitraryContentParameter()) {
@@ -77,6 +77,8 @@ static const struct ZeroNode : public cmGeneratorExpressionNode
 {
   ZeroNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   bool GeneratesContent() const override { return false; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -95,6 +97,8 @@ static const struct OneNode : public cmGeneratorExpressionNode
 {
   OneNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -121,6 +125,8 @@ struct BooleanOpNode : public cmGeneratorExpressionNode
   {
   }
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return OneOrMoreParameters; }
 
   std::string Evaluate(const std::vector<std::string>& parameters,
@@ -152,6 +158,8 @@ static const struct NotNode : public cmGeneratorExpressionNode
 {
   NotNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   std::string Evaluate(
     const std::vector<std::string>& parameters,
     cmGeneratorExpressionContext* context,
@@ -172,6 +180,8 @@ static const struct BoolNode : public cmGeneratorExpressionNode
 {
   BoolNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -188,6 +198,8 @@ static const struct IfNode : public cmGeneratorExpressionNode
 {
   IfNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 3; }
 
   std::string Evaluate(const std::vector<std::string>& parameters,
@@ -209,6 +221,8 @@ static const struct StrEqualNode : public cmGeneratorExpressionNode
 {
   StrEqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -225,6 +239,8 @@ static const struct EqualNode : public cmGeneratorExpressionNode
 {
   EqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -278,6 +294,8 @@ static const struct InListNode : public cmGeneratorExpressionNode
 {
   InListNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -303,6 +321,7 @@ static const struct InListNode : public cmGeneratorExpressionNode
           e << cmPolicies::GetPolicyWarning(cmPolicies::CMP0085)
             << "\nSearch Item:\n  \"" << parameters.front()
             << "\"\nList:\n  \"" << parameters[1] << "\"\n";
+          context->HadUncacheableNode = true;
           context->LG->GetCMakeInstance()->IssueMessage(
             MessageType ::AUTHOR_WARNING, e.str(), context->Backtrace);
           return "0";
@@ -326,6 +345,8 @@ static const struct FilterNode : public cmGeneratorExpressionNode
 {
   FilterNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 3; }
 
   std::string Evaluate(
@@ -372,6 +393,8 @@ static const struct RemoveDuplicatesNode : public cmGeneratorExpressionNode
 {
   RemoveDuplicatesNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -571,6 +594,8 @@ static const struct LowerCaseNode : public cmGeneratorExpressionNode
 {
   LowerCaseNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -587,6 +612,8 @@ static const struct UpperCaseNode : public cmGeneratorExpressionNode
 {
   UpperCaseNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -603,6 +630,8 @@ static const struct MakeCIdentifierNode : public cmGeneratorExpressionNode
 {
   MakeCIdentifierNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -620,6 +649,8 @@ struct CharacterNode : public cmGeneratorExpressionNode
 {
   CharacterNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -642,6 +673,8 @@ struct CompilerIdNode : public cmGeneratorExpressionNode
   {
   }
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return ZeroOrMoreParameters; }
 
   std::string Evaluate(
@@ -694,6 +727,7 @@ struct CompilerIdNode : public cmGeneratorExpressionNode
       if (cmsysString_strcasecmp(param.c_str(), compilerId.c_str()) == 0) {
         switch (context->LG->GetPolicyStatus(cmPolicies::CMP0044)) {
           case cmPolicies::WARN: {
+            context->HadUncacheableNode = true;
             context->LG->GetCMakeInstance()->IssueMessage(
               MessageType::AUTHOR_WARNING,
               cmPolicies::GetPolicyWarning(cmPolicies::CMP0044),
@@ -727,6 +761,8 @@ struct CompilerVersionNode : public cmGeneratorExpressionNode
   {
   }
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return OneOrZeroParameters; }
 
   std::string Evaluate(
@@ -789,6 +825,8 @@ struct PlatformIdNode : public cmGeneratorExpressionNode
 {
   PlatformIdNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return ZeroOrMoreParameters; }
 
   std::string Evaluate(
@@ -821,6 +859,8 @@ struct VersionNode : public cmGeneratorExpressionNode
 {
   VersionNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -868,6 +908,8 @@ static const struct ConfigurationNode : public cmGeneratorExpressionNode
 {
   ConfigurationNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -885,6 +927,8 @@ static const struct ConfigurationTestNode : public cmGeneratorExpressionNode
 {
   ConfigurationTestNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return ZeroOrMoreParameters; }
 
   std::string Evaluate(
@@ -945,6 +989,8 @@ static const struct JoinNode : public cmGeneratorExpressionNode
 {
   JoinNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -964,6 +1010,8 @@ static const struct CompileLanguageNode : public cmGeneratorExpressionNode
 {
   CompileLanguageNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool SupportsResultCache() const override { return true; }
+
   int NumExpectedParameters() const override { return ZeroOrMoreParameters; }
 
   std::string Evaluate(
@@ -972,6 +1020,10 @@ static const struct CompileLanguageNode : public cmGeneratorExpressionNode
     const GeneratorExpressionContent* content,
     cmGeneratorExpressionDAGChecker* dagChecker) const override
   {
+    if (context->Language.empty()) {
+      // Validity depends on the dependency graph checker.
+      context->HadUncacheableNode = true;
+    }
     if (context->Language.empty() &&
         (!dagChecker || !dagChecker->EvaluatingCompileExpression())) {
       reportError(
@@ -33,6 +33,11 @@ struct cmGeneratorExpressionNode
 
   virtual int NumExpectedParameters() const { return 1; }
 
+  // Whether the result depends only on the parameters, the configuration,
+  // the language, the head and current targets, and the directory of the
+  // evaluation.  See cmGeneratorExpressionResultCache.
+  virtual bool SupportsResultCache() const { return false; }
+
   virtual std::string Evaluate(
     const std::vector<std::string>& parameters,
     cmGeneratorExpressionContext* context,
@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
@@ -14,6 +15,7 @@
 #include <utility>
 
 #include <cm/memory>
+#include <cm/optional>
 #include <cmext/algorithm>
 #include <cmext/string_view>
 
@@ -58,7 +60,10 @@
 #  include <cm3p/json/writer.h>
 
 #  include "cmCryptoHash.h"
+#  include "cmInstallHashManifest.h"
+#  include "cmMakefileProfilingData.h"
 #  include "cmQtAutoGenGlobalInitializer.h"
+#  include "cmWorkerPool.h"
 #endif
 
 #if defined(_MSC_VER) && _MSC_VER >= 1800
@@ -110,6 +115,9 @@ cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
 
   this->RecursionDepth = 0;
 
+  this->GeneratorExpressionParseCache =
+    cm::make_unique<cmGeneratorExpressionParseCache>();
+
   cm->GetState()->SetIsGeneratorMultiConfig(false);
   cm->GetState()->SetMinGWMake(false);
   cm->GetState()->SetMSYSShell(false);
@@ -132,6 +140,19 @@ Json::Value cmGlobalGenerator::GetJson() const
   generator["multiConfig"] = this->IsMultiConfig();
   return generator;
 }
+
+cmInstallHashManifest& cmGlobalGenerator::GetInstallHashManifest(
+  std::string const& file)
+{
+  if (!this->InstallHashManifest ||
+      this->InstallHashManifest->GetFile() != file) {
+    // Save the previous manifest before loading the new one, in case
+    // they are the same file under different names.
+    this->InstallHashManifest.reset();
+    this->InstallHashManifest = cm::make_unique<cmInstallHashManifest>(file);
+  }
+  return *this->InstallHashManifest;
+}
 #endif
 
 bool cmGlobalGenerator::SetGeneratorInstance(std::string const& i,
@@ -1219,6 +1240,7 @@ void cmGlobalGenerator::Configure()
 {
   this->FirstTimeProgress = 0.0f;
   this->ClearGeneratorMembers();
+  this->LoadDirectoryContent();
   this->NextDeferId = 0;
 
   cmStateSnapshot snapshot = this->CMakeInstance->GetCurrentSnapshot();
@@ -1241,6 +1263,7 @@ void cmGlobalGenerator::Configure()
   this->ConfigureDoneCMP0026AndCMP0024 = false;
   dirMf->Configure();
   dirMf->EnforceDirectoryLevelRules();
+  this->WriteDirectoryContent();
 
   this->ConfigureDoneCMP0026AndCMP0024 = true;
 
@@ -1497,6 +1520,64 @@ bool cmGlobalGenerator::Compute()
   return true;
 }
 
+#if !defined(CMAKE_BOOTSTRAP)
+namespace {
+class ReplaceGeneratedFilesJob : public cmWorkerPool::JobT
+{
+public:
+  ReplaceGeneratedFilesJob(
+    std::vector<cmGeneratedFileReplacements::Replacement> const& files,
+    std::size_t begin, std::size_t end)
+    : Files(files)
+    , Begin(begin)
+    , End(end)
+  {
+  }
+
+  void Process() override
+  {
+    for (std::size_t i = this->Begin; i != this->End; ++i) {
+      cmGeneratedFileStreamBase::Replace(this->Files[i]);
+    }
+  }
+
+private:
+  std::vector<cmGeneratedFileReplacements::Replacement> const& Files;
+  std::size_t Begin;
+  std::size_t End;
+};
+
+class ReplaceGeneratedFilesDoneJob : public cmWorkerPool::JobFenceT
+{
+public:
+  void Process() override { this->Pool()->Abort(); }
+};
+
+void ReplaceGeneratedFiles(
+  std::vector<cmGeneratedFileReplacements::Replacement> const& files,
+  unsigned int jobs)
+{
+  if (files.empty()) {
+    return;
+  }
+
+  // Each replacement touches only its own destination and temporary file,
+  // so they can be processed in any order.  Hand them out in a few chunks
+  // per thread to balance uneven file sizes.
+  std::size_t const chunks =
+    std::min<std::size_t>(files.size(), std::size_t(jobs) * 4);
+  cmWorkerPool pool;
+  pool.SetThreadCount(jobs);
+  for (std::size_t c = 0; c != chunks; ++c) {
+    pool.EmplaceJob<ReplaceGeneratedFilesJob>(files, files.size() * c / chunks,
+                                              files.size() * (c + 1) / chunks);
+  }
+  pool.EmplaceJob<ReplaceGeneratedFilesDoneJob>();
+  pool.Process();
+}
+}
+#endif
+
 void cmGlobalGenerator::Generate()
 {
   // Create a map from local generator to the complete set of targets
@@ -1507,8 +1588,29 @@ void cmGlobalGenerator::Generate()
 
   this->CMakeInstance->UpdateProgress("Generating", 0.1f);
 
-  // Generate project files
+#if !defined(CMAKE_BOOTSTRAP)
+  // With --parallel-file-replace, streams that opt in leave their files
+  // at temporary names here, to be moved into place concurrently later.
+  unsigned int const replaceJobs =
+    this->CMakeInstance->GetParallelFileReplaceJobs();
+  cmGeneratedFileReplacements deferredReplacements;
+  if (replaceJobs > 1) {
+    this->DeferredFileReplacements = &deferredReplacements;
+  }
+#endif
+
+  // Generate project files.  This stays serial: local generators fill
+  // lazily computed caches of targets, makefiles and this generator that
+  // are not synchronized, and SetCurrentMakefile selects shared state.
   for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
+#if !defined(CMAKE_BOOTSTRAP)
+    cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+    if (this->CMakeInstance->IsProfilingEnabled()) {
+      profilingRAII.emplace(
+        this->CMakeInstance->GetProfilingOutput(), "generate",
+        this->LocalGenerators[i]->GetCurrentBinaryDirectory());
+    }
+#endif
     this->SetCurrentMakefile(this->LocalGenerators[i]->GetMakefile());
     this->LocalGenerators[i]->Generate();
     if (!this->LocalGenerators[i]->GetMakefile()->IsOn(
@@ -1524,6 +1626,11 @@ void cmGlobalGenerator::Generate()
   }
   this->SetCurrentMakefile(nullptr);
 
+#if !defined(CMAKE_BOOTSTRAP)
+  this->DeferredFileReplacements = nullptr;
+  ReplaceGeneratedFiles(deferredReplacements.Take(), replaceJobs);
+#endif
+
   if (!this->GenerateCPackPropertiesFile()) {
     this->GetCMakeInstance()->IssueMessage(
       MessageType::FATAL_ERROR, "Could not write CPack properties file.");
@@ -2982,26 +3089,153 @@ std::set<std::string> const& cmGlobalGenerator::GetDirectoryContent(
 {
   DirectoryContent& dc = this->DirectoryContentMap[dir];
   if (needDisk) {
-    long mt = cmSystemTools::ModifiedTime(dir);
-    if (mt != dc.LastDiskTime) {
-      // Reset to non-loaded directory content.
-      dc.All = dc.Generated;
-
-      // Load the directory content from disk.
-      cmsys::Directory d;
-      if (d.Load(dir)) {
-        unsigned long n = d.GetNumberOfFiles();
-        for (unsigned long i = 0; i < n; ++i) {
-          const char* f = d.GetFile(i);
-          if (strcmp(f, ".") != 0 && strcmp(f, "..") != 0) {
-            dc.All.insert(f);
-          }
+    this->UpdateDirectoryContent(dir, dc);
+  }
+  return dc.All;
+}
+
+void cmGlobalGenerator::UpdateDirectoryContent(std::string const& dir,
+                                               DirectoryContent& dc)
+{
+  long mt = cmSystemTools::ModifiedTime(dir);
+  if (mt != dc.LastDiskTime) {
+    // Reset to non-loaded directory content.
+    dc.All = dc.Generated;
+
+    // Load the directory content from disk.
+    cmsys::Directory d;
+    if (d.Load(dir)) {
+      unsigned long n = d.GetNumberOfFiles();
+      for (unsigned long i = 0; i < n; ++i) {
+        const char* f = d.GetFile(i);
+        if (strcmp(f, ".") != 0 && strcmp(f, "..") != 0) {
+          dc.All.insert(f);
         }
       }
-      dc.LastDiskTime = mt;
     }
+    dc.LastDiskTime = mt;
+
+    // A change in the same second as the one before the listing was
+    // loaded would not change the time stamp.  Leave some slack for
+    // the clock of a network file system.
+    dc.Stable = mt + 1 < static_cast<long>(time(nullptr));
   }
-  return dc.All;
+  dc.Used = true;
+}
+
+bool cmGlobalGenerator::DirectoryMayContain(std::string const& dir,
+                                            std::string const& name)
+{
+#if defined(_WIN32) || defined(__APPLE__) || defined(__CYGWIN__)
+  // File names are not case-sensitive on these platforms, so a listing
+  // does not tell whether a name exists.
+  static_cast<void>(dir);
+  static_cast<void>(name);
+  return true;
+#else
+  if (dir.empty() || cmSystemTools::FileIsFullPath(name)) {
+    return true;
+  }
+  std::string const first = name.substr(0, name.find('/'));
+  if (first.empty() || first == "." || first == "..") {
+    return true;
+  }
+  std::string d = dir;
+  cmSystemTools::ConvertToUnixSlashes(d);
+  DirectoryContent& dc = this->DirectoryContentMap[d];
+  // Nothing changes the directory while a search runs, so check its
+  // time stamp only for the first candidate of each search.
+  if (dc.CheckedInSearch != this->FindSearch) {
+    this->UpdateDirectoryContent(d, dc);
+    dc.CheckedInSearch = this->FindSearch;
+  }
+  // An entry created in the same second as the listing was loaded does
+  // not change the time stamp, so only a stable listing can tell.
+  if (!dc.Stable) {
+    return true;
+  }
+  return dc.All.count(first) > 0;
+#endif
+}
+
+void cmGlobalGenerator::LoadDirectoryContent()
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->CMakeInstance->GetIsInTryCompile()) {
+    return;
+  }
+  std::string const pfile =
+    cmStrCat(this->CMakeInstance->GetHomeOutputDirectory(),
+             "/CMakeFiles/CMakeDirectoryContent.txt");
+  cmsys::ifstream fin(pfile.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return;
+  }
+  // Line format is either a time stamp followed by a space followed by
+  // a directory, or a space followed by the name of an entry of the
+  // directory on the most recent line of the first kind.
+  DirectoryContent* dc = nullptr;
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    if (line[0] == ' ') {
+      if (dc) {
+        dc->All.insert(line.substr(1));
+      }
+      continue;
+    }
+    std::string::size_type const pos = line.find(' ');
+    long mt;
+    if (pos == std::string::npos || !cmStrToLong(line.substr(0, pos), &mt)) {
+      dc = nullptr;
+      continue;
+    }
+    dc = &this->DirectoryContentMap[line.substr(pos + 1)];
+    dc->LastDiskTime = mt;
+    dc->Stable = true;
+  }
+#endif
+}
+
+void cmGlobalGenerator::WriteDirectoryContent()
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->CMakeInstance->GetIsInTryCompile()) {
+    return;
+  }
+  std::string const pfile =
+    cmStrCat(this->CMakeInstance->GetHomeOutputDirectory(),
+             "/CMakeFiles/CMakeDirectoryContent.txt");
+  // Keep listings used by this run that will reliably notice a change.
+  // A listing with a name that does not fit on a line is left out, so
+  // the directory will be loaded from disk again.
+  auto hasNewline = [](std::string const& n) -> bool {
+    return n.find_first_of("\r\n") != std::string::npos;
+  };
+  std::vector<std::pair<std::string const, DirectoryContent> const*> entries;
+  for (auto const& p : this->DirectoryContentMap) {
+    DirectoryContent const& dc = p.second;
+    if (dc.Used && dc.Stable && dc.Generated.empty() &&
+        !hasNewline(p.first) &&
+        std::none_of(dc.All.begin(), dc.All.end(), hasNewline)) {
+      entries.push_back(&p);
+    }
+  }
+  if (entries.empty()) {
+    cmSystemTools::RemoveFile(pfile);
+    return;
+  }
+  cmGeneratedFileStream fout(pfile);
+  fout << "# Directories searched by find commands and their content.\n";
+  for (auto const* p : entries) {
+    fout << p->second.LastDiskTime << ' ' << p->first << '\n';
+    for (std::string const& f : p->second.All) {
+      fout << ' ' << f << '\n';
+    }
+  }
+#endif
 }
 
 void cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
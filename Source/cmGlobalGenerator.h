@@ -41,7 +41,10 @@
 class cmDirectoryId;
 class cmExportBuildFileGenerator;
 class cmExternalMakefileProjectGenerator;
+class cmGeneratedFileReplacements;
+class cmGeneratorExpressionParseCache;
 class cmGeneratorTarget;
+class cmInstallHashManifest;
 class cmLinkLineComputer;
 class cmLocalGenerator;
 class cmMakefile;
@@ -376,6 +379,17 @@ public:
   std::set<std::string> const& GetDirectoryContent(std::string const& dir,
                                                    bool needDisk = true);
 
+  /** Return false if the content of a directory shows that it has no
+      entry for the first component of the given relative path.  This
+      lets find commands skip a file system probe per candidate name.
+      Only listings loaded well after the last change of the directory
+      are trusted.  They are kept across configure runs in the build
+      tree, and checked against the disk once per find search.  */
+  bool DirectoryMayContain(std::string const& dir, std::string const& name);
+
+  /** Start the search of a find command.  */
+  void BeginFindSearch() { ++this->FindSearch; }
+
   void IndexTarget(cmTarget* t);
   void IndexGeneratorTarget(cmGeneratorTarget* gt);
 
@@ -476,6 +490,15 @@ public:
   virtual bool SupportsCrossConfigs() const { return false; }
   virtual bool SupportsDefaultConfigs() const { return false; }
 
+  /** Return where generated files that need not be in place until all
+      directories have been generated may record their replacement, or
+      nullptr to replace them on close.  See
+      cmGeneratedFileStream::SetDeferredReplacements.  */
+  cmGeneratedFileReplacements* GetDeferredFileReplacements() const
+  {
+    return this->DeferredFileReplacements;
+  }
+
   static std::string EscapeJSON(const std::string& s);
 
   void ProcessEvaluationFiles();
@@ -502,8 +525,21 @@ public:
   const std::set<const cmGeneratorTarget*>& GetFilenameTargetDepends(
     cmSourceFile* sf) const;
 
+  /** Parsed generator expressions of all directories.  */
+  cmGeneratorExpressionParseCache& GetGeneratorExpressionParseCache()
+  {
+    return *this->GeneratorExpressionParseCache;
+  }
+
 #if !defined(CMAKE_BOOTSTRAP)
   cmFileLockPool& GetFileLockPool() { return this->FileLockPool; }
+
+  /**
+   * Return the install hash manifest loaded from the given file.  It is
+   * saved when another one is requested or this generator is destroyed,
+   * i.e. after the install script ran.
+   */
+  cmInstallHashManifest& GetInstallHashManifest(std::string const& file);
 #endif
 
   bool GetConfigureDoneCMP0026() const
@@ -674,6 +710,9 @@ private:
   void CheckRuleHashes(std::string const& pfile, std::string const& home);
   void WriteRuleHashes(std::string const& pfile);
 
+  void LoadDirectoryContent();
+  void WriteDirectoryContent();
+
   void WriteSummary();
   void WriteSummary(cmGeneratorTarget* target);
   void FinalizeTargetCompileInfo();
@@ -725,8 +764,18 @@ private:
     long LastDiskTime = -1;
     std::set<std::string> All;
     std::set<std::string> Generated;
+    // The listing was loaded well after the last modification of the
+    // directory, so its time stamp reliably tells whether it is current.
+    bool Stable = false;
+    // The listing was used since the last configure started.
+    bool Used = false;
+    // The find search in which DirectoryMayContain last checked the
+    // time stamp.
+    unsigned int CheckedInSearch = 0;
   };
   std::map<std::string, DirectoryContent> DirectoryContentMap;
+  unsigned int FindSearch = 0;
+  void UpdateDirectoryContent(std::string const& dir, DirectoryContent& dc);
 
   // Set of binary directories on disk.
   std::set<std::string> BinaryDirectories;
@@ -743,9 +792,16 @@ private:
 
   std::unordered_set<std::string> GeneratedFiles;
 
+  std::unique_ptr<cmGeneratorExpressionParseCache>
+    GeneratorExpressionParseCache;
+
+  cmGeneratedFileReplacements* DeferredFileReplacements = nullptr;
+
 #if !defined(CMAKE_BOOTSTRAP)
   // Pool of file locks
   cmFileLockPool FileLockPool;
+
+  std::unique_ptr<cmInstallHashManifest> InstallHashManifest;
 #endif
 
 protected:
@@ -103,6 +103,53 @@ bool operator>=(
   return rhs <= lhs;
 }
 
+namespace {
+// Append what cmGlobalNinjaGenerator::WriteComment writes.
+void AppendComment(std::string& out, std::string const& comment)
+{
+  if (comment.empty()) {
+    return;
+  }
+
+  std::string::size_type lpos = 0;
+  std::string::size_type rpos;
+  out += "\n#############################################\n";
+  while ((rpos = comment.find('\n', lpos)) != std::string::npos) {
+    out += "# ";
+    out.append(comment, lpos, rpos - lpos);
+    out += '\n';
+    lpos = rpos + 1;
+  }
+  out += "# ";
+  out.append(comment, lpos, std::string::npos);
+  out += "\n\n";
+}
+
+// Append what cmGlobalNinjaGenerator::WriteVariable writes for a
+// variable of a build statement.
+void AppendVariable(std::string& out, std::string const& name,
+                    std::string const& value)
+{
+  if (name.empty()) {
+    cmSystemTools::Error("No name given for WriteVariable! called "
+                         "with comment: ");
+    return;
+  }
+
+  // Do not add a variable if the value is empty.
+  std::string const val = cmTrimWhitespace(value);
+  if (val.empty()) {
+    return;
+  }
+
+  out += cmGlobalNinjaGenerator::INDENT;
+  out += name;
+  out += " = ";
+  out += val;
+  out += '\n';
+}
+}
+
 void cmGlobalNinjaGenerator::Indent(std::ostream& os, int count)
 {
   for (int i = 0; i < count; ++i) {
@@ -176,17 +223,59 @@ std::string cmGlobalNinjaGenerator::EncodeLiteral(const std::string& lit)
 
 std::string cmGlobalNinjaGenerator::EncodePath(const std::string& path)
 {
-  std::string result = path;
+  std::string result;
+  this->AppendEncodedPath(result, path);
+  return result;
+}
+
+void cmGlobalNinjaGenerator::AppendEncodedPath(std::string& out,
+                                               const std::string& path)
+{
+  // Escape as EncodeLiteral does, and also spaces and colons.  A
+  // reference to the configuration directory is kept unescaped.
+  cm::string_view const cfgIntDir = this->IsMultiConfig()
+    ? cm::string_view(this->GetCMakeCFGIntDir())
+    : cm::string_view();
 #ifdef _WIN32
-  if (this->IsGCCOnWindows())
-    std::replace(result.begin(), result.end(), '\\', '/');
-  else
-    std::replace(result.begin(), result.end(), '/', '\\');
+  bool const forwardSlashes = this->IsGCCOnWindows();
 #endif
-  result = this->EncodeLiteral(result);
-  cmSystemTools::ReplaceString(result, " ", "$ ");
-  cmSystemTools::ReplaceString(result, ":", "$:");
-  return result;
+  out.reserve(out.size() + path.size());
+  for (std::string::size_type i = 0; i < path.size(); ++i) {
+    char c = path[i];
+#ifdef _WIN32
+    if (forwardSlashes) {
+      if (c == '\\') {
+        c = '/';
+      }
+    } else if (c == '/') {
+      c = '\\';
+    }
+#endif
+    switch (c) {
+      case '$':
+        if (!cfgIntDir.empty() &&
+            path.compare(i, cfgIntDir.size(), cfgIntDir.data(),
+                         cfgIntDir.size()) == 0) {
+          out.append(cfgIntDir.data(), cfgIntDir.size());
+          i += cfgIntDir.size() - 1;
+        } else {
+          out += "$$";
+        }
+        break;
+      case '\n':
+        out += "$\n";
+        break;
+      case ' ':
+        out += "$ ";
+        break;
+      case ':':
+        out += "$:";
+        break;
+      default:
+        out += c;
+        break;
+    }
+  }
 }
 
 void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
@@ -208,84 +297,77 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
     return;
   }
 
-  cmGlobalNinjaGenerator::WriteComment(os, build.Comment);
+  // Assemble the whole statement and write it at once.
+  std::string statement;
+  AppendComment(statement, build.Comment);
+  std::string::size_type const start = statement.size();
 
   // Write output files.
-  std::string buildStr("build");
-  {
-    // Write explicit outputs
-    for (std::string const& output : build.Outputs) {
-      buildStr += cmStrCat(' ', this->EncodePath(output));
-      if (this->ComputingUnknownDependencies) {
-        this->CombinedBuildOutputs.insert(output);
-      }
+  statement += "build";
+  // Write explicit outputs
+  for (std::string const& output : build.Outputs) {
+    statement += ' ';
+    this->AppendEncodedPath(statement, output);
+    if (this->ComputingUnknownDependencies) {
+      this->CombinedBuildOutputs.insert(output);
     }
-    // Write implicit outputs
-    if (!build.ImplicitOuts.empty()) {
-      buildStr += " |";
-      for (std::string const& implicitOut : build.ImplicitOuts) {
-        buildStr += cmStrCat(' ', this->EncodePath(implicitOut));
-      }
+  }
+  // Write implicit outputs
+  if (!build.ImplicitOuts.empty()) {
+    statement += " |";
+    for (std::string const& implicitOut : build.ImplicitOuts) {
+      statement += ' ';
+      this->AppendEncodedPath(statement, implicitOut);
     }
-    buildStr += ':';
-
-    // Write the rule.
-    buildStr += cmStrCat(' ', build.Rule);
   }
+  // Write the rule.
+  statement += ": ";
+  statement += build.Rule;
 
-  std::string arguments;
-  {
-    // TODO: Better formatting for when there are multiple input/output files.
+  // TODO: Better formatting for when there are multiple input/output files.
 
-    // Write explicit dependencies.
-    for (std::string const& explicitDep : build.ExplicitDeps) {
-      arguments += cmStrCat(' ', this->EncodePath(explicitDep));
-    }
+  // Write explicit dependencies.
+  for (std::string const& explicitDep : build.ExplicitDeps) {
+    statement += ' ';
+    this->AppendEncodedPath(statement, explicitDep);
+  }
 
-    // Write implicit dependencies.
-    if (!build.ImplicitDeps.empty()) {
-      arguments += " |";
-      for (std::string const& implicitDep : build.ImplicitDeps) {
-        arguments += cmStrCat(' ', this->EncodePath(implicitDep));
-      }
+  // Write implicit dependencies.
+  if (!build.ImplicitDeps.empty()) {
+    statement += " |";
+    for (std::string const& implicitDep : build.ImplicitDeps) {
+      statement += ' ';
+      this->AppendEncodedPath(statement, implicitDep);
     }
+  }
 
-    // Write order-only dependencies.
-    if (!build.OrderOnlyDeps.empty()) {
-      arguments += " ||";
-      for (std::string const& orderOnlyDep : build.OrderOnlyDeps) {
-        arguments += cmStrCat(' ', this->EncodePath(orderOnlyDep));
-      }
+  // Write order-only dependencies.
+  if (!build.OrderOnlyDeps.empty()) {
+    statement += " ||";
+    for (std::string const& orderOnlyDep : build.OrderOnlyDeps) {
+      statement += ' ';
+      this->AppendEncodedPath(statement, orderOnlyDep);
     }
-
-    arguments += '\n';
   }
 
+  statement += '\n';
+
   // Write the variables bound to this build statement.
-  std::string assignments;
-  {
-    std::ostringstream variable_assignments;
-    for (auto const& variable : build.Variables) {
-      cmGlobalNinjaGenerator::WriteVariable(
-        variable_assignments, variable.first, variable.second, "", 1);
-    }
+  for (auto const& variable : build.Variables) {
+    AppendVariable(statement, variable.first, variable.second);
+  }
 
-    // check if a response file rule should be used
-    assignments = variable_assignments.str();
-    bool useResponseFile = false;
-    if (cmdLineLimit < 0 ||
-        (cmdLineLimit > 0 &&
-         (arguments.size() + buildStr.size() + assignments.size() + 1000) >
-           static_cast<size_t>(cmdLineLimit))) {
-      variable_assignments.str(std::string());
-      cmGlobalNinjaGenerator::WriteVariable(variable_assignments, "RSP_FILE",
-                                            build.RspFile, "", 1);
-      assignments += variable_assignments.str();
-      useResponseFile = true;
-    }
-    if (usedResponseFile) {
-      *usedResponseFile = useResponseFile;
-    }
+  // check if a response file rule should be used
+  bool useResponseFile = false;
+  if (cmdLineLimit < 0 ||
+      (cmdLineLimit > 0 &&
+       (statement.size() - start + 1000) >
+         static_cast<size_t>(cmdLineLimit))) {
+    AppendVariable(statement, "RSP_FILE", build.RspFile);
+    useResponseFile = true;
+  }
+  if (usedResponseFile) {
+    *usedResponseFile = useResponseFile;
   }
 
   if (build.Variables.count("dyndep") > 0) {
@@ -294,7 +376,8 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
     this->DisableCleandead = true;
   }
 
-  os << buildStr << arguments << assignments << "\n";
+  statement += '\n';
+  os.write(statement.data(), static_cast<std::streamsize>(statement.size()));
 }
 
 void cmGlobalNinjaGenerator::AddCustomCommandRule()
@@ -1023,8 +1106,11 @@ bool cmGlobalNinjaGenerator::OpenFileStream(
     // Compute Ninja's build file path.
     std::string path =
       cmStrCat(this->GetCMakeInstance()->GetHomeOutputDirectory(), '/', name);
-    stream = cm::make_unique<cmGeneratedFileStream>(
-      path, false, this->GetMakefileEncoding());
+    stream =
+      cm::make_unique<cmGeneratedFileStream>(this->GetMakefileEncoding());
+    // Build files can be very large, so write them in large chunks.
+    stream->SetBufferSize(1024 * 1024);
+    stream->Open(path);
     if (!(*stream)) {
       // An error message is generated by the constructor if it cannot
       // open the file.
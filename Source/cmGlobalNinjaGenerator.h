@@ -79,6 +79,12 @@ public:
   std::string EncodeLiteral(const std::string& lit);
   std::string EncodePath(const std::string& path);
 
+  /**
+   * Append the encoded form of a path to a string.  This does the same
+   * as EncodePath in a single pass and without temporary strings.
+   */
+  void AppendEncodedPath(std::string& out, const std::string& path);
+
   std::unique_ptr<cmLinkLineComputer> CreateLinkLineComputer(
     cmOutputConverter* outputConverter,
     cmStateDirectory const& stateDir) const override;
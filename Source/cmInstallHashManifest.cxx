@@ -0,0 +1,187 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmInstallHashManifest.h"
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include <cm/string_view>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmCryptoHash.h"
+#include "cmFileTime.h"
+#include "cmGeneratedFileStream.h"
+#include "cmMappedFile.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+
+char const* const HeaderLine = "# CMake install hash manifest 1";
+
+std::string HashFile(std::string const& path, unsigned long long size)
+{
+  cmCryptoHash hash(cmCryptoHash::AlgoXXH64);
+  // Empty files cannot be mapped.
+  if (size == 0) {
+    return hash.HashString(cm::string_view());
+  }
+  cmMappedFile mapped;
+  if (!mapped.Open(path)) {
+    return std::string();
+  }
+  return hash.HashString(mapped.View());
+}
+
+bool ParseNumber(std::string const& str, unsigned long long& value)
+{
+  char* end = nullptr;
+  value = std::strtoull(str.c_str(), &end, 10);
+  return !str.empty() && *end == '\0';
+}
+
+bool ParseNumber(std::string const& str, long long& value)
+{
+  char* end = nullptr;
+  value = std::strtoll(str.c_str(), &end, 10);
+  return !str.empty() && *end == '\0';
+}
+
+} // anonymous namespace
+
+cmInstallHashManifest::cmInstallHashManifest(std::string file)
+  : File(std::move(file))
+{
+  this->Load();
+}
+
+cmInstallHashManifest::~cmInstallHashManifest()
+{
+  this->Save();
+}
+
+bool cmInstallHashManifest::IsUpToDate(std::string const& fromFile,
+                                       std::string const& toFile)
+{
+  auto i = this->Entries.find(toFile);
+  if (i == this->Entries.end() || i->second.FromFile != fromFile) {
+    return false;
+  }
+  Entry& entry = i->second;
+
+  // Compare the current content with the recorded one.  Keep the new
+  // times, so unchanged files are not hashed again.
+  FileState source = entry.Source;
+  FileState installed = entry.Installed;
+  if (!Refresh(fromFile, source) || source.Hash != entry.Source.Hash ||
+      !Refresh(toFile, installed) || installed.Hash != entry.Installed.Hash) {
+    return false;
+  }
+  if (source.Time != entry.Source.Time ||
+      installed.Time != entry.Installed.Time) {
+    entry.Source = std::move(source);
+    entry.Installed = std::move(installed);
+    this->Modified = true;
+  }
+  return true;
+}
+
+void cmInstallHashManifest::Record(std::string const& fromFile,
+                                   std::string const& toFile, bool copied)
+{
+  Entry& entry = this->Entries[toFile];
+  if (entry.FromFile != fromFile) {
+    entry = Entry();
+    entry.FromFile = fromFile;
+  }
+  if (copied) {
+    // The installed file may have been edited without changing its size
+    // and time, so always hash it again.
+    entry.Installed = FileState();
+  }
+  entry.Recorded = true;
+  this->Modified = true;
+}
+
+bool cmInstallHashManifest::Refresh(std::string const& path,
+                                    FileState& state)
+{
+  unsigned long long size = 0;
+  cmFileTime time;
+  if (!time.Load(path, size)) {
+    return false;
+  }
+  if (!state.Hash.empty() && state.Size == size &&
+      state.Time == time.GetTime()) {
+    return true;
+  }
+  state.Size = size;
+  state.Time = time.GetTime();
+  state.Hash = HashFile(path, size);
+  return !state.Hash.empty();
+}
+
+bool cmInstallHashManifest::Load()
+{
+  cmsys::ifstream fin(this->File.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if (!fin || !cmSystemTools::GetLineFromStream(fin, line) ||
+      line != HeaderLine) {
+    return false;
+  }
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    // <to> <from> <size> <time> <hash> <size> <time> <hash>
+    std::vector<std::string> fields = cmTokenize(line, "\t");
+    Entry entry;
+    if (fields.size() != 8 ||
+        !ParseNumber(fields[2], entry.Source.Size) ||
+        !ParseNumber(fields[3], entry.Source.Time) ||
+        !ParseNumber(fields[5], entry.Installed.Size) ||
+        !ParseNumber(fields[6], entry.Installed.Time)) {
+      continue;
+    }
+    entry.FromFile = std::move(fields[1]);
+    entry.Source.Hash = std::move(fields[4]);
+    entry.Installed.Hash = std::move(fields[7]);
+    this->Entries[std::move(fields[0])] = std::move(entry);
+  }
+  return true;
+}
+
+bool cmInstallHashManifest::Save()
+{
+  if (!this->Modified) {
+    return true;
+  }
+  this->Modified = false;
+
+  // Hash the files installed by this script, now that it is done editing
+  // them.  Forget files that no longer exist, and unless only some files
+  // were installed, those that are no longer installed.
+  for (auto i = this->Entries.begin(); i != this->Entries.end();) {
+    Entry& entry = i->second;
+    if (entry.Recorded
+          ? (!Refresh(entry.FromFile, entry.Source) ||
+             !Refresh(i->first, entry.Installed))
+          : !this->Partial) {
+      i = this->Entries.erase(i);
+      continue;
+    }
+    entry.Recorded = false;
+    ++i;
+  }
+  this->Partial = false;
+
+  cmGeneratedFileStream fout(this->File);
+  fout << HeaderLine << '\n';
+  for (auto const& i : this->Entries) {
+    Entry const& entry = i.second;
+    fout << i.first << '\t' << entry.FromFile << '\t' << entry.Source.Size
+         << '\t' << entry.Source.Time << '\t' << entry.Source.Hash << '\t'
+         << entry.Installed.Size << '\t' << entry.Installed.Time << '\t'
+         << entry.Installed.Hash << '\n';
+  }
+  return fout.Close();
+}
@@ -0,0 +1,87 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <unordered_map>
+
+/** \class cmInstallHashManifest
+ * \brief Records the content of files installed by an install script.
+ *
+ * For each installed file the manifest records the size, modification
+ * time and XXH64 hash of its source file and of the installed file.
+ * The installed file is hashed when the manifest is saved, after the
+ * install script ran, so the hash covers edits made after copying, like
+ * changing the runtime path or stripping.
+ *
+ * An installed file is up to date if both its source and itself still
+ * have the recorded content.  Files are only hashed again when their
+ * size or modification time changed.  Entries of files that were not
+ * recorded since the manifest was loaded are removed when it is saved.
+ */
+class cmInstallHashManifest
+{
+public:
+  /** Load the manifest from the given file, if it exists.  */
+  cmInstallHashManifest(std::string file);
+
+  /** Save the manifest.  */
+  ~cmInstallHashManifest();
+
+  cmInstallHashManifest(cmInstallHashManifest const&) = delete;
+  cmInstallHashManifest& operator=(cmInstallHashManifest const&) = delete;
+
+  std::string const& GetFile() const { return this->File; }
+
+  /**
+   * Return true if toFile was installed from fromFile and neither of them
+   * changed their content since then.
+   */
+  bool IsUpToDate(std::string const& fromFile, std::string const& toFile);
+
+  /**
+   * Record that toFile is installed from fromFile, and whether it was
+   * copied now.  Both are hashed when the manifest is saved.
+   */
+  void Record(std::string const& fromFile, std::string const& toFile,
+              bool copied);
+
+  /**
+   * Keep the entries of files that are not recorded, because the install
+   * run installs only some of the files, like those of one component.
+   */
+  void KeepUnrecorded() { this->Partial = true; }
+
+  /**
+   * Hash the recorded files and write the manifest.
+   * @return true on success
+   */
+  bool Save();
+
+private:
+  struct FileState
+  {
+    unsigned long long Size = 0;
+    long long Time = 0;
+    std::string Hash;
+  };
+
+  struct Entry
+  {
+    std::string FromFile;
+    FileState Source;
+    FileState Installed;
+    bool Recorded = false;
+  };
+
+  static bool Refresh(std::string const& path, FileState& state);
+
+  bool Load();
+
+  std::string File;
+  std::unordered_map<std::string, Entry> Entries;
+  bool Modified = false;
+  bool Partial = false;
+};
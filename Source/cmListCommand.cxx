@@ -24,6 +24,7 @@
 #include "cmGeneratorExpression.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
+#include "cmPlainList.h"
 #include "cmPolicies.h"
 #include "cmProperty.h"
 #include "cmRange.h"
@@ -138,6 +139,20 @@ bool GetList(std::vector<std::string>& list, const std::string& var,
   return true;
 }
 
+// Return the elements of a list variable without expanding its value, if
+// it is a plain list and policy CMP0007 keeps its empty elements.
+cmPlainList const* GetPlainList(const std::string& var,
+                                const cmMakefile& makefile)
+{
+  if (makefile.GetPolicyStatus(cmPolicies::CMP0007) != cmPolicies::NEW ||
+      !makefile.GetDefinitionList(var)) {
+    return nullptr;
+  }
+  // Notify variable watches, which may change the variable.
+  makefile.GetDefinition(var);
+  return makefile.GetDefinitionList(var);
+}
+
 bool HandleLengthCommand(std::vector<std::string> const& args,
                          cmExecutionStatus& status)
 {
@@ -148,12 +163,17 @@ bool HandleLengthCommand(std::vector<std::string> const& args,
 
   const std::string& listName = args[1];
   const std::string& variableName = args.back();
-  std::vector<std::string> varArgsExpanded;
-  // do not check the return value here
-  // if the list var is not found varArgsExpanded will have size 0
-  // and we will return 0
-  GetList(varArgsExpanded, listName, status.GetMakefile());
-  size_t length = varArgsExpanded.size();
+  size_t length;
+  if (cmPlainList const* list = GetPlainList(listName, status.GetMakefile())) {
+    length = list->size();
+  } else {
+    std::vector<std::string> varArgsExpanded;
+    // do not check the return value here
+    // if the list var is not found varArgsExpanded will have size 0
+    // and we will return 0
+    GetList(varArgsExpanded, listName, status.GetMakefile());
+    length = varArgsExpanded.size();
+  }
   char buffer[1024];
   sprintf(buffer, "%d", static_cast<int>(length));
 
@@ -171,14 +191,16 @@ bool HandleGetCommand(std::vector<std::string> const& args,
 
   const std::string& listName = args[1];
   const std::string& variableName = args.back();
-  // expand the variable
+  // expand the variable unless it is a plain list
   std::vector<std::string> varArgsExpanded;
-  if (!GetList(varArgsExpanded, listName, status.GetMakefile())) {
+  cmPlainList const* list = GetPlainList(listName, status.GetMakefile());
+  if (!list && !GetList(varArgsExpanded, listName, status.GetMakefile())) {
     status.GetMakefile().AddDefinition(variableName, "NOTFOUND");
     return true;
   }
+  size_t nitem = list ? list->size() : varArgsExpanded.size();
   // FIXME: Add policy to make non-existing lists an error like empty lists.
-  if (varArgsExpanded.empty()) {
+  if (nitem == 0) {
     status.SetError("GET given empty list");
     return false;
   }
@@ -186,7 +208,6 @@ bool HandleGetCommand(std::vector<std::string> const& args,
   std::string value;
   size_t cc;
   const char* sep = "";
-  size_t nitem = varArgsExpanded.size();
   for (cc = 2; cc < args.size() - 1; cc++) {
     int item;
     if (!GetIndexArg(args[cc], &item, status.GetMakefile())) {
@@ -203,7 +224,12 @@ bool HandleGetCommand(std::vector<std::string> const& args,
                                ", ", nitem - 1, ")"));
       return false;
     }
-    value += varArgsExpanded[item];
+    if (list) {
+      cm::string_view element = (*list)[item];
+      value.append(element.data(), element.size());
+    } else {
+      value += varArgsExpanded[item];
+    }
   }
 
   status.GetMakefile().AddDefinition(variableName, value);
@@ -222,17 +248,16 @@ bool HandleAppendCommand(std::vector<std::string> const& args,
 
   cmMakefile& makefile = status.GetMakefile();
   std::string const& listName = args[1];
-  // expand the variable
-  std::string listString;
-  GetListString(listString, listName, makefile);
+  cmProp listString = makefile.GetDefinition(listName);
 
-  // If `listString` or `args` is empty, no need to append `;`,
-  // then index is going to be `1` and points to the end-of-string ";"
+  // If `listString` is empty, no need to append `;`, then `offset` is
+  // going to be `1` and points to the end-of-string ";".  The value is
+  // extended in place, so appending many times takes linear time.
   auto const offset =
-    std::string::size_type(listString.empty() || args.empty());
-  listString += &";"[offset] + cmJoin(cmMakeRange(args).advance(2), ";");
-
-  makefile.AddDefinition(listName, listString);
+    std::string::size_type(!listString || listString->empty());
+  makefile.AppendDefinition(
+    listName,
+    cmStrCat(&";"[offset], cmJoin(cmMakeRange(args).advance(2), ";")));
   return true;
 }
 
@@ -370,6 +395,16 @@ bool HandleFindCommand(std::vector<std::string> const& args,
 
   const std::string& listName = args[1];
   const std::string& variableName = args.back();
+  if (cmPlainList const* list = GetPlainList(listName, status.GetMakefile())) {
+    for (size_t i = 0; i < list->size(); ++i) {
+      if ((*list)[i] == args[2]) {
+        status.GetMakefile().AddDefinition(variableName, std::to_string(i));
+        return true;
+      }
+    }
+    status.GetMakefile().AddDefinition(variableName, "-1");
+    return true;
+  }
   // expand the variable
   std::vector<std::string> varArgsExpanded;
   if (!GetList(varArgsExpanded, listName, status.GetMakefile())) {
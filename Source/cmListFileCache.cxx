@@ -7,6 +7,7 @@
 #include <sstream>
 #include <utility>
 
+#include "cmListFileDiskCache.h"
 #include "cmListFileLexer.h"
 #include "cmMessageType.h"
 #include "cmMessenger.h"
@@ -39,6 +40,7 @@ struct cmListFileParser
   std::string FunctionName;
   long FunctionLine;
   std::vector<cmListFileArgument> FunctionArguments;
+  bool IssuedWarning = false;
   enum
   {
     SeparationOkay,
@@ -174,18 +176,29 @@ bool cmListFileParser::Parse()
 }
 
 bool cmListFile::ParseFile(const char* filename, cmMessenger* messenger,
-                           cmListFileBacktrace const& lfbt)
+                           cmListFileBacktrace const& lfbt,
+                           cmListFileDiskCache* diskCache)
 {
   if (!cmSystemTools::FileExists(filename) ||
       cmSystemTools::FileIsDirectory(filename)) {
     return false;
   }
 
+  if (diskCache && diskCache->Load(filename, this->Functions)) {
+    return true;
+  }
+
   bool parseError = false;
 
   {
     cmListFileParser parser(this, lfbt, messenger);
     parseError = !parser.ParseFile(filename);
+
+    // Only clean parses are stored so that diagnostics are always
+    // reported by the parser itself.
+    if (diskCache && !parseError && !parser.IssuedWarning) {
+      diskCache->Store(filename, this->Functions);
+    }
   }
 
   return !parseError;
@@ -326,6 +339,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     return false;
   }
   this->Messenger->IssueMessage(MessageType::AUTHOR_WARNING, m.str(), lfbt);
+  this->IssuedWarning = true;
   return true;
 }
 
@@ -476,8 +490,8 @@ cmListFileBacktrace::cmListFileBacktrace(cmStateSnapshot const& snapshot)
 
 /* NOLINTNEXTLINE(performance-unnecessary-value-param) */
 cmListFileBacktrace::cmListFileBacktrace(std::shared_ptr<Entry const> parent,
-                                         cmListFileContext const& lfc)
-  : TopEntry(std::make_shared<Entry const>(std::move(parent), lfc))
+                                         cmListFileContext lfc)
+  : TopEntry(std::make_shared<Entry const>(std::move(parent), std::move(lfc)))
 {
 }
 
@@ -517,6 +531,13 @@ cmListFileBacktrace cmListFileBacktrace::Push(
   return cmListFileBacktrace(this->TopEntry, lfc);
 }
 
+cmListFileBacktrace cmListFileBacktrace::Push(cmListFileContext&& lfc) const
+{
+  assert(this->TopEntry);
+  assert(!this->TopEntry->IsBottom() || this->TopEntry->Bottom.IsValid());
+  return cmListFileBacktrace(this->TopEntry, std::move(lfc));
+}
+
 cmListFileBacktrace cmListFileBacktrace::Pop() const
 {
   assert(this->TopEntry);
@@ -23,6 +23,7 @@
  * cmake list files.
  */
 
+class cmListFileDiskCache;
 class cmMessenger;
 
 struct cmCommandContext
@@ -70,6 +71,11 @@ struct cmListFileArgument
   std::string Value;
   Delimiter Delim = Unquoted;
   long Line = 0;
+
+  /** The variable references and escapes in Value, parsed by
+      cmMakefile::ExpandArguments when the argument is first expanded.  */
+  struct Expansion;
+  mutable std::shared_ptr<Expansion const> ParsedExpansion;
 };
 
 class cmListFileContext
@@ -182,6 +188,7 @@ public:
   // Get a backtrace with the given call context added to the top.
   // May not be called until after construction with a valid snapshot.
   cmListFileBacktrace Push(cmListFileContext const& lfc) const;
+  cmListFileBacktrace Push(cmListFileContext&& lfc) const;
 
   // Get a backtrace with the top level removed.
   // May not be called until after a matching Push.
@@ -207,7 +214,7 @@ private:
   struct Entry;
   std::shared_ptr<Entry const> TopEntry;
   cmListFileBacktrace(std::shared_ptr<Entry const> parent,
-                      cmListFileContext const& lfc);
+                      cmListFileContext lfc);
   cmListFileBacktrace(std::shared_ptr<Entry const> top);
 };
 
@@ -272,7 +279,8 @@ std::vector<BT<std::string>> ExpandListWithBacktrace(
 struct cmListFile
 {
   bool ParseFile(const char* path, cmMessenger* messenger,
-                 cmListFileBacktrace const& lfbt);
+                 cmListFileBacktrace const& lfbt,
+                 cmListFileDiskCache* diskCache = nullptr);
 
   bool ParseString(const char* str, const char* virtual_filename,
                    cmMessenger* messenger, cmListFileBacktrace const& lfbt);
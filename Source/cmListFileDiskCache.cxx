@@ -0,0 +1,129 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmListFileDiskCache.h"
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include <cm/string_view>
+
+#include "cmBinaryFormat.h"
+#include "cmCryptoHash.h"
+#include "cmListFileCache.h"
+#include "cmMappedFile.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+// Bump the version whenever the entry layout changes.
+char const kMagic[4] = { 'C', 'M', 'L', 'F' };
+std::uint32_t const kVersion = 1;
+}
+
+cmListFileDiskCache::cmListFileDiskCache(std::string directory)
+  : Directory(std::move(directory))
+{
+}
+
+cmListFileDiskCache::~cmListFileDiskCache() = default;
+
+std::string cmListFileDiskCache::GetEntryPath(std::string const& path) const
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoMD5);
+  return cmStrCat(this->Directory, '/', hasher.HashString(path), ".bin");
+}
+
+bool cmListFileDiskCache::Load(std::string const& path,
+                               std::vector<cmListFileFunction>& functions)
+{
+  cmMappedFile file;
+  if (!file.Open(this->GetEntryPath(path))) {
+    return false;
+  }
+  cmBinaryReader r(file.View());
+
+  // Validate the entry against the list file on disk.
+  std::uint32_t version;
+  cm::string_view entryPath;
+  cmBinaryFileStamp recorded;
+  if (!r.Magic(cm::string_view(kMagic, sizeof(kMagic))) || !r.U32(version) ||
+      version != kVersion || !r.String(entryPath) || entryPath != path ||
+      !recorded.Read(r) || !recorded.Matches(path)) {
+    return false;
+  }
+
+  // Decode into a temporary so a truncated entry leaves no partial result.
+  std::uint32_t count;
+  if (!r.U32(count)) {
+    return false;
+  }
+  std::vector<cmListFileFunction> loaded;
+  loaded.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::string name;
+    long long line;
+    std::uint32_t argCount;
+    if (!r.String(name) || !r.I64(line) || !r.U32(argCount)) {
+      return false;
+    }
+    std::vector<cmListFileArgument> args;
+    args.reserve(argCount);
+    for (std::uint32_t j = 0; j < argCount; ++j) {
+      std::string value;
+      unsigned char delim;
+      long long argLine;
+      if (!r.String(value) || !r.U8(delim) ||
+          delim > cmListFileArgument::Bracket || !r.I64(argLine)) {
+        return false;
+      }
+      args.emplace_back(std::move(value),
+                        static_cast<cmListFileArgument::Delimiter>(delim),
+                        static_cast<long>(argLine));
+    }
+    loaded.emplace_back(std::move(name), static_cast<long>(line),
+                        std::move(args));
+  }
+  if (!r.AtEnd()) {
+    return false;
+  }
+
+  functions.insert(functions.end(), std::make_move_iterator(loaded.begin()),
+                   std::make_move_iterator(loaded.end()));
+  return true;
+}
+
+void cmListFileDiskCache::Store(
+  std::string const& path, std::vector<cmListFileFunction> const& functions)
+{
+  cmBinaryFileStamp stamp;
+  if (!stamp.Load(path, true)) {
+    return;
+  }
+
+  cmBinaryWriter w;
+  w.Bytes(cm::string_view(kMagic, sizeof(kMagic)));
+  w.U32(kVersion);
+  w.String(path);
+  stamp.Write(w);
+  w.U32(static_cast<std::uint32_t>(functions.size()));
+  for (cmListFileFunction const& func : functions) {
+    w.String(func.OriginalName());
+    w.I64(func.Line());
+    w.U32(static_cast<std::uint32_t>(func.Arguments().size()));
+    for (cmListFileArgument const& arg : func.Arguments()) {
+      w.String(arg.Value);
+      w.U8(static_cast<unsigned char>(arg.Delim));
+      w.I64(arg.Line);
+    }
+  }
+
+  if (!this->DirectoryCreated) {
+    this->DirectoryCreated = cmSystemTools::MakeDirectory(this->Directory);
+    if (!this->DirectoryCreated) {
+      return;
+    }
+  }
+
+  cmStoreBinaryFile(this->GetEntryPath(path), w.Data);
+}
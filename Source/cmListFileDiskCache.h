@@ -0,0 +1,51 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+class cmListFileFunction;
+
+/** \class cmListFileDiskCache
+ * \brief Persists parsed list files in the build tree.
+ *
+ * Each successfully parsed list file is stored in a compact binary form
+ * in a directory of the build tree.  An entry is reused only when the
+ * size, modification time, and content hash of the list file all match
+ * the values recorded when it was stored.  Files whose parse produced
+ * any diagnostic are never stored, so messages are always reported by
+ * the text parser.
+ */
+class cmListFileDiskCache
+{
+public:
+  cmListFileDiskCache(std::string directory);
+  ~cmListFileDiskCache();
+
+  cmListFileDiskCache(const cmListFileDiskCache&) = delete;
+  cmListFileDiskCache& operator=(const cmListFileDiskCache&) = delete;
+
+  /**
+   * @brief Loads the functions of the list file at the given path.
+   * @return true if a valid entry was found
+   */
+  bool Load(std::string const& path,
+            std::vector<cmListFileFunction>& functions);
+
+  /**
+   * @brief Stores the parsed functions of the list file at the given path.
+   */
+  void Store(std::string const& path,
+             std::vector<cmListFileFunction> const& functions);
+
+  std::string const& GetDirectory() const { return this->Directory; }
+
+private:
+  std::string GetEntryPath(std::string const& path) const;
+
+  std::string Directory;
+  bool DirectoryCreated = false;
+};
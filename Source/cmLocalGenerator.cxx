@@ -97,6 +97,9 @@ cmLocalGenerator::cmLocalGenerator(cmGlobalGenerator* gg, cmMakefile* makefile)
 
   this->AliasTargets = makefile->GetAliasTargets();
 
+  this->GeneratorExpressionResultCache =
+    cm::make_unique<cmGeneratorExpressionResultCache>();
+
   this->EmitUniversalBinaryFlags = true;
   this->BackwardsCompatibility = 0;
   this->BackwardsCompatibilityFinal = false;
@@ -311,6 +314,8 @@ void cmLocalGenerator::GenerateTestFiles()
 
   cmGeneratedFileStream fout(file);
   fout.SetCopyIfDifferent(true);
+  fout.SetDeferredReplacements(
+    this->GlobalGenerator->GetDeferredFileReplacements());
 
   fout << "# CMake generated Testfile for \n"
           "# Source directory: "
@@ -496,6 +501,8 @@ void cmLocalGenerator::GenerateInstallRules()
   file += "/cmake_install.cmake";
   cmGeneratedFileStream fout(file);
   fout.SetCopyIfDifferent(true);
+  fout.SetDeferredReplacements(
+    this->GlobalGenerator->GetDeferredFileReplacements());
 
   // Write the header.
   /* clang-format off */
@@ -582,6 +589,19 @@ void cmLocalGenerator::GenerateInstallRules()
     /* clang-format on */
   }
 
+  // Record the content of installed files next to the install manifest.
+  if (toplevel_install) {
+    /* clang-format off */
+    fout <<
+      "# Set the file recording hashes of installed files.\n"
+      "if(NOT DEFINED CMAKE_INSTALL_HASH_MANIFEST)\n"
+      "  set(CMAKE_INSTALL_HASH_MANIFEST \""
+         << homedir << "/install_manifest_hashes.txt\")\n"
+      "endif()\n"
+      "\n";
+    /* clang-format on */
+  }
+
   // Write out CMAKE_GET_RUNTIME_DEPENDENCIES_PLATFORM so that
   // installed code that uses `file(GET_RUNTIME_DEPENDENCIES)`
   // has same platform variable as when running cmake
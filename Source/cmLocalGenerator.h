@@ -29,6 +29,7 @@ class cmCustomCommand;
 class cmCustomCommandGenerator;
 class cmCustomCommandLines;
 class cmGeneratedFileStream;
+class cmGeneratorExpressionResultCache;
 class cmGeneratorTarget;
 class cmGlobalGenerator;
 class cmImplicitDependsList;
@@ -557,6 +558,12 @@ public:
 
   cmProp GetRuleLauncher(cmGeneratorTarget* target, const std::string& prop);
 
+  /** Results of generator expressions evaluated in this directory.  */
+  cmGeneratorExpressionResultCache& GetGeneratorExpressionResultCache()
+  {
+    return *this->GeneratorExpressionResultCache;
+  }
+
 protected:
   // The default implementation ignores the IncludePathStyle and always
   // uses absolute paths.  A generator may override this to use relative
@@ -610,6 +617,9 @@ protected:
   GeneratorTargetVector OwnedImportedGeneratorTargets;
   std::map<std::string, std::string> AliasTargets;
 
+  std::unique_ptr<cmGeneratorExpressionResultCache>
+    GeneratorExpressionResultCache;
+
   std::map<std::string, std::string> Compilers;
   std::map<std::string, std::string> VariableMappings;
   std::string CompilerSysroot;
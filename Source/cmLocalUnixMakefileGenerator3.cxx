@@ -247,6 +247,8 @@ void cmLocalUnixMakefileGenerator3::WriteLocalMakefile()
   if (!ruleFileStream) {
     return;
   }
+  ruleFileStream.SetDeferredReplacements(
+    this->GlobalGenerator->GetDeferredFileReplacements());
   // always write the top makefile
   if (!this->IsRootMakefile()) {
     ruleFileStream.SetCopyIfDifferent(true);
@@ -466,6 +468,8 @@ void cmLocalUnixMakefileGenerator3::WriteDirectoryInformationFile()
   }
 
   infoFileStream.SetCopyIfDifferent(true);
+  infoFileStream.SetDeferredReplacements(
+    this->GlobalGenerator->GetDeferredFileReplacements());
   // Write the do not edit header.
   this->WriteDisclaimer(infoFileStream);
 
@@ -1471,20 +1475,9 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(
         return false;
       }
 
-      // Open the cmake dependency tracking file.  This should not be
-      // copy-if-different because dependencies are re-scanned when it is
-      // older than the DependInfo.cmake.
-      cmGeneratedFileStream internalRuleFileStream(
-        internalDepFile, false, this->GlobalGenerator->GetMakefileEncoding());
-      if (!internalRuleFileStream) {
-        return false;
-      }
-
       this->WriteDisclaimer(ruleFileStream);
-      this->WriteDisclaimer(internalRuleFileStream);
 
-      depsManager.WriteDependencies(dependencies, ruleFileStream,
-                                    internalRuleFileStream);
+      depsManager.WriteDependencies(dependencies, ruleFileStream);
     }
   }
 
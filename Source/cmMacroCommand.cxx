@@ -2,6 +2,9 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmMacroCommand.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstddef>
 #include <cstdio>
 #include <utility>
 
@@ -22,6 +25,37 @@
 
 namespace {
 
+// A reference to a macro argument in an argument of a command in the body
+// of a macro, like ${ARGN} or a formal parameter.
+struct cmMacroArgumentRef
+{
+  enum KindType
+  {
+    Formal,
+    Argc,
+    Argn,
+    Argv,
+    ArgvN
+  };
+
+  std::string::size_type Begin; // offset of "${"
+  std::string::size_type End;   // offset after "}"
+  KindType Kind;
+  unsigned int Index; // of the formal parameter or ARGV<n>
+};
+
+// The macro argument references in an argument of a command in the body
+// of a macro.  The references are replaced in a single pass.
+struct cmMacroArgumentTemplate
+{
+  std::vector<cmMacroArgumentRef> Refs;
+
+  // Whether the text next to a reference may combine with the replaced
+  // value into another reference, like in ${${name}}.  The references are
+  // then replaced one after the other as macro arguments always were.
+  bool Nested = false;
+};
+
 // define the class for macro commands
 class cmMacroHelperCommand
 {
@@ -33,12 +67,175 @@ public:
   bool operator()(std::vector<cmListFileArgument> const& args,
                   cmExecutionStatus& inStatus) const;
 
+  /** Find the macro argument references in the body of the macro.  */
+  void Compile();
+
   std::vector<std::string> Args;
   std::vector<cmListFileFunction> Functions;
   cmPolicies::PolicyMap Policies;
   std::string FilePath;
+
+private:
+  bool FindRef(cm::string_view name, cmMacroArgumentRef& ref) const;
+
+  void ReplaceRefsInOrder(std::string& value,
+                          std::vector<std::string> const& expandedArgs,
+                          std::string const& argcDef,
+                          std::string const& expandedArgn,
+                          std::string const& expandedArgv) const;
+
+  // The references to the formal parameters, like ${name}.
+  std::vector<std::string> FormalRefs;
+  // The templates of the arguments of each command in the body.
+  std::vector<std::vector<cmMacroArgumentTemplate>> Templates;
+  // Whether a formal parameter name may be part of another reference.
+  bool AlwaysInOrder = false;
 };
 
+bool IsRefChar(char c)
+{
+  return c == '$' || c == '{' || c == '}';
+}
+
+void cmMacroHelperCommand::Compile()
+{
+  this->FormalRefs.clear();
+  this->FormalRefs.reserve(this->Args.size() - 1);
+  for (unsigned int j = 1; j < this->Args.size(); ++j) {
+    this->FormalRefs.push_back("${" + this->Args[j] + "}");
+    if (std::any_of(this->Args[j].begin(), this->Args[j].end(), IsRefChar)) {
+      this->AlwaysInOrder = true;
+    }
+  }
+
+  this->Templates.clear();
+  this->Templates.reserve(this->Functions.size());
+  for (cmListFileFunction const& func : this->Functions) {
+    this->Templates.emplace_back();
+    std::vector<cmMacroArgumentTemplate>& templates = this->Templates.back();
+    templates.resize(func.Arguments().size());
+    for (std::size_t a = 0; a < templates.size(); ++a) {
+      cmListFileArgument const& arg = func.Arguments()[a];
+      if (arg.Delim == cmListFileArgument::Bracket) {
+        continue;
+      }
+      cmMacroArgumentTemplate& t = templates[a];
+      std::string const& value = arg.Value;
+
+      // Whether the text since the last reference ends in "$", or in an
+      // unterminated "${" that a reference could complete.
+      bool dollar = false;
+      bool open = false;
+      std::string::size_type i = 0;
+      while (i < value.size()) {
+        if (value.compare(i, 2, "${") == 0) {
+          std::string::size_type const end = value.find('}', i + 2);
+          cm::string_view const name =
+            end == std::string::npos
+            ? cm::string_view()
+            : cm::string_view(value).substr(i + 2, end - (i + 2));
+          cmMacroArgumentRef ref;
+          if (end != std::string::npos &&
+              std::none_of(name.begin(), name.end(), IsRefChar) &&
+              this->FindRef(name, ref)) {
+            ref.Begin = i;
+            ref.End = end + 1;
+            t.Refs.push_back(ref);
+            if (dollar || open) {
+              t.Nested = true;
+            }
+            dollar = false;
+            open = false;
+            i = end + 1;
+            continue;
+          }
+        }
+        char const c = value[i];
+        if (c == '$') {
+          dollar = true;
+          open = false;
+        } else if (c == '{' && dollar) {
+          dollar = false;
+          open = true;
+        } else {
+          dollar = false;
+          open = open && !IsRefChar(c);
+        }
+        ++i;
+      }
+    }
+  }
+}
+
+bool cmMacroHelperCommand::FindRef(cm::string_view name,
+                                   cmMacroArgumentRef& ref) const
+{
+  // Formal parameters are replaced first.
+  for (unsigned int j = 1; j < this->Args.size(); ++j) {
+    if (name == this->Args[j]) {
+      ref.Kind = cmMacroArgumentRef::Formal;
+      ref.Index = j - 1;
+      return true;
+    }
+  }
+  if (name == "ARGC"_s) {
+    ref.Kind = cmMacroArgumentRef::Argc;
+    return true;
+  }
+  if (name == "ARGN"_s) {
+    ref.Kind = cmMacroArgumentRef::Argn;
+    return true;
+  }
+  if (name == "ARGV"_s) {
+    ref.Kind = cmMacroArgumentRef::Argv;
+    return true;
+  }
+  // Match ${ARGV<n>} as printed by "${ARGV%u}".
+  if (cmHasLiteralPrefix(name, "ARGV") && name.size() > 4 &&
+      name.size() <= 13 && (name[4] != '0' || name.size() == 5)) {
+    unsigned long index = 0;
+    for (char c : name.substr(4)) {
+      if (c < '0' || c > '9') {
+        return false;
+      }
+      index = index * 10 + static_cast<unsigned long>(c - '0');
+    }
+    if (index > UINT_MAX) {
+      return false;
+    }
+    ref.Kind = cmMacroArgumentRef::ArgvN;
+    ref.Index = static_cast<unsigned int>(index);
+    return true;
+  }
+  return false;
+}
+
+void cmMacroHelperCommand::ReplaceRefsInOrder(
+  std::string& value, std::vector<std::string> const& expandedArgs,
+  std::string const& argcDef, std::string const& expandedArgn,
+  std::string const& expandedArgv) const
+{
+  // replace formal arguments
+  for (unsigned int j = 0; j < this->FormalRefs.size(); ++j) {
+    cmSystemTools::ReplaceString(value, this->FormalRefs[j], expandedArgs[j]);
+  }
+  // replace argc
+  cmSystemTools::ReplaceString(value, "${ARGC}", argcDef);
+
+  cmSystemTools::ReplaceString(value, "${ARGN}", expandedArgn);
+  cmSystemTools::ReplaceString(value, "${ARGV}", expandedArgv);
+
+  // if the current argument of the current function has ${ARGV in it
+  // then try replacing ARGV values
+  if (value.find("${ARGV") != std::string::npos) {
+    char argvName[60];
+    for (unsigned int t = 0; t < expandedArgs.size(); ++t) {
+      sprintf(argvName, "${ARGV%u}", t);
+      cmSystemTools::ReplaceString(value, argvName, expandedArgs[t]);
+    }
+  }
+}
+
 bool cmMacroHelperCommand::operator()(
   std::vector<cmListFileArgument> const& args,
   cmExecutionStatus& inStatus) const
@@ -68,48 +265,65 @@ bool cmMacroHelperCommand::operator()(
   auto eit = expandedArgs.begin() + (this->Args.size() - 1);
   std::string expandedArgn = cmJoin(cmMakeRange(eit, expandedArgs.end()), ";");
   std::string expandedArgv = cmJoin(expandedArgs, ";");
-  std::vector<std::string> variables;
-  variables.reserve(this->Args.size() - 1);
-  for (unsigned int j = 1; j < this->Args.size(); ++j) {
-    variables.push_back("${" + this->Args[j] + "}");
-  }
-  std::vector<std::string> argVs;
-  argVs.reserve(expandedArgs.size());
-  char argvName[60];
-  for (unsigned int j = 0; j < expandedArgs.size(); ++j) {
-    sprintf(argvName, "${ARGV%u}", j);
-    argVs.emplace_back(argvName);
-  }
+
+  // Replaced values containing references may be replaced again.
+  bool const inOrder = this->AlwaysInOrder ||
+    std::any_of(expandedArgs.begin(), expandedArgs.end(),
+                [](std::string const& arg) {
+                  return std::any_of(arg.begin(), arg.end(), IsRefChar);
+                });
+
   // Invoke all the functions that were collected in the block.
   // for each function
-  for (cmListFileFunction const& func : this->Functions) {
+  for (std::size_t f = 0; f < this->Functions.size(); ++f) {
+    cmListFileFunction const& func = this->Functions[f];
+    std::vector<cmMacroArgumentTemplate> const& templates = this->Templates[f];
+
     // Replace the formal arguments and then invoke the command.
     std::vector<cmListFileArgument> newLFFArgs;
     newLFFArgs.reserve(func.Arguments().size());
 
     // for each argument of the current function
-    for (cmListFileArgument const& k : func.Arguments()) {
+    for (std::size_t a = 0; a < templates.size(); ++a) {
+      cmListFileArgument const& k = func.Arguments()[a];
+      cmMacroArgumentTemplate const& t = templates[a];
       cmListFileArgument arg;
-      arg.Value = k.Value;
-      if (k.Delim != cmListFileArgument::Bracket) {
-        // replace formal arguments
-        for (unsigned int j = 0; j < variables.size(); ++j) {
-          cmSystemTools::ReplaceString(arg.Value, variables[j],
-                                       expandedArgs[j]);
-        }
-        // replace argc
-        cmSystemTools::ReplaceString(arg.Value, "${ARGC}", argcDef);
-
-        cmSystemTools::ReplaceString(arg.Value, "${ARGN}", expandedArgn);
-        cmSystemTools::ReplaceString(arg.Value, "${ARGV}", expandedArgv);
-
-        // if the current argument of the current function has ${ARGV in it
-        // then try replacing ARGV values
-        if (arg.Value.find("${ARGV") != std::string::npos) {
-          for (unsigned int t = 0; t < expandedArgs.size(); ++t) {
-            cmSystemTools::ReplaceString(arg.Value, argVs[t], expandedArgs[t]);
+      if (t.Refs.empty()) {
+        arg.Value = k.Value;
+        arg.ParsedExpansion = k.ParsedExpansion;
+      } else if (inOrder || t.Nested) {
+        arg.Value = k.Value;
+        this->ReplaceRefsInOrder(arg.Value, expandedArgs, argcDef,
+                                 expandedArgn, expandedArgv);
+      } else {
+        // Splice the values of the references into the text around them.
+        std::string::size_type pos = 0;
+        for (cmMacroArgumentRef const& ref : t.Refs) {
+          arg.Value.append(k.Value, pos, ref.Begin - pos);
+          switch (ref.Kind) {
+            case cmMacroArgumentRef::Formal:
+              arg.Value += expandedArgs[ref.Index];
+              break;
+            case cmMacroArgumentRef::Argc:
+              arg.Value += argcDef;
+              break;
+            case cmMacroArgumentRef::Argn:
+              arg.Value += expandedArgn;
+              break;
+            case cmMacroArgumentRef::Argv:
+              arg.Value += expandedArgv;
+              break;
+            case cmMacroArgumentRef::ArgvN:
+              if (ref.Index < expandedArgs.size()) {
+                arg.Value += expandedArgs[ref.Index];
+              } else {
+                arg.Value.append(k.Value, ref.Begin, ref.End - ref.Begin);
+              }
+              break;
           }
+          pos = ref.End;
         }
+        arg.Value.append(k.Value, pos, std::string::npos);
       }
       arg.Delim = k.Delim;
       arg.Line = k.Line;
@@ -118,7 +332,15 @@ bool cmMacroHelperCommand::operator()(
     cmListFileFunction newLFF{ func.OriginalName(), func.Line(),
                                std::move(newLFFArgs) };
     cmExecutionStatus status(makefile);
-    if (!makefile.ExecuteCommand(newLFF, status) || status.GetNestedError()) {
+    bool const executed = makefile.ExecuteCommand(newLFF, status);
+    // Keep the arguments without references parsed for the next invocation.
+    for (std::size_t a = 0; a < templates.size(); ++a) {
+      if (templates[a].Refs.empty() && !func.Arguments()[a].ParsedExpansion) {
+        func.Arguments()[a].ParsedExpansion =
+          newLFF.Arguments()[a].ParsedExpansion;
+      }
+    }
+    if (!executed || status.GetNestedError()) {
       // The error message should have already included the call stack
       // so we do not need to report an error here.
       macroScope.Quiet();
@@ -170,6 +392,7 @@ bool cmMacroFunctionBlocker::Replay(std::vector<cmListFileFunction> functions,
   f.Args = this->Args;
   f.Functions = std::move(functions);
   f.FilePath = this->GetStartingContext().FilePath;
+  f.Compile();
   mf.RecordPolicies(f.Policies);
   return mf.GetState()->AddScriptedCommand(
     this->Args[0],
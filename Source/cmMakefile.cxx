@@ -64,6 +64,7 @@
 
 #ifndef CMAKE_BOOTSTRAP
 #  include "cmMakefileProfilingData.h"
+#  include "cmTryCompileBatch.h"
 #  include "cmVariableWatch.h"
 #endif
 
@@ -368,16 +369,16 @@ public:
                  cm::optional<std::string> deferId, cmExecutionStatus& status)
     : Makefile(mf)
   {
-    cmListFileContext const& lfc = cmListFileContext::FromCommandContext(
-      lff, this->Makefile->StateSnapshot.GetExecutionListFile(),
-      std::move(deferId));
-    this->Makefile->Backtrace = this->Makefile->Backtrace.Push(lfc);
+    this->Makefile->Backtrace = this->Makefile->Backtrace.Push(
+      cmListFileContext::FromCommandContext(
+        lff, this->Makefile->StateSnapshot.GetExecutionListFile(),
+        std::move(deferId)));
     ++this->Makefile->RecursionDepth;
     this->Makefile->ExecutionStatusStack.push_back(&status);
 #if !defined(CMAKE_BOOTSTRAP)
     if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
-      this->Makefile->GetCMakeInstance()->GetProfilingOutput().StartEntry(lff,
-                                                                          lfc);
+      this->Makefile->GetCMakeInstance()->GetProfilingOutput().StartEntry(
+        lff, this->Makefile->Backtrace.Top());
     }
 #endif
   }
@@ -427,8 +428,10 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   static_cast<void>(stack_manager);
 
   // Check for maximum recursion depth.
+  static std::string const maxRecursionDepth =
+    "CMAKE_MAXIMUM_RECURSION_DEPTH";
   int depth = CMake_DEFAULT_RECURSION_LIMIT;
-  cmProp depthStr = this->GetDefinition("CMAKE_MAXIMUM_RECURSION_DEPTH");
+  cmProp depthStr = this->GetDefinition(maxRecursionDepth);
   if (depthStr) {
     std::istringstream s(*depthStr);
     int d;
@@ -445,8 +448,8 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   }
 
   // Lookup the command prototype.
-  if (cmState::Command command =
-        this->GetState()->GetCommandByExactName(lff.LowerCaseName())) {
+  if (std::shared_ptr<cmState::Command const> command =
+        this->GetState()->GetCommandToInvoke(lff.LowerCaseName())) {
     // Decide whether to invoke the command.
     if (!cmSystemTools::GetFatalErrorOccured()) {
       // if trace is enabled, print out invoke information
@@ -454,7 +457,7 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
         this->PrintCommandTrace(lff, this->Backtrace.Top().DeferId);
       }
       // Try invoking the command.
-      bool invokeSucceeded = command(lff.Arguments(), status);
+      bool invokeSucceeded = (*command)(lff.Arguments(), status);
       bool hadNestedError = status.GetNestedError();
       if (!invokeSucceeded || hadNestedError) {
         if (!hadNestedError) {
@@ -624,7 +627,8 @@ bool cmMakefile::ReadDependentFile(const std::string& filename,
 
   cmListFile listFile;
   if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetCMakeInstance()->GetListFileDiskCache())) {
     return false;
   }
 
@@ -725,7 +729,8 @@ bool cmMakefile::ReadListFile(const std::string& filename)
 
   cmListFile listFile;
   if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetCMakeInstance()->GetListFileDiskCache())) {
     return false;
   }
 
@@ -1650,7 +1655,8 @@ void cmMakefile::Configure()
 
   cmListFile listFile;
   if (!listFile.ParseFile(currentStart.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetCMakeInstance()->GetListFileDiskCache())) {
     return;
   }
   if (this->IsRootMakefile()) {
@@ -1734,6 +1740,14 @@ void cmMakefile::Configure()
   this->Defer = cm::make_unique<DeferCommands>();
   this->RunListFile(listFile, currentStart, this->Defer.get());
   this->Defer.reset();
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->TryCompileBatch) {
+    this->TryCompileBatch.reset();
+    this->IssueMessage(MessageType::FATAL_ERROR,
+                       "try_compile_batch(BEGIN) has no matching "
+                       "try_compile_batch(END) in this directory.");
+  }
+#endif
   if (cmSystemTools::GetFatalErrorOccured()) {
     scope.Quiet();
   }
@@ -1917,6 +1931,26 @@ void cmMakefile::AddDefinition(const std::string& name, cm::string_view value)
 #endif
 }
 
+void cmMakefile::AppendDefinition(const std::string& name,
+                                  cm::string_view suffix)
+{
+  cmProp current = this->StateSnapshot.GetDefinition(name);
+  if (!current) {
+    current = this->GetState()->GetInitializedCacheValue(name);
+  }
+  this->StateSnapshot.AppendDefinition(
+    name, current ? cm::string_view(*current) : cm::string_view(), suffix);
+
+#ifndef CMAKE_BOOTSTRAP
+  cmVariableWatch* vv = this->GetVariableWatch();
+  if (vv) {
+    vv->VariableAccessed(name, cmVariableWatch::VARIABLE_MODIFIED_ACCESS,
+                         this->StateSnapshot.GetDefinition(name)->c_str(),
+                         this);
+  }
+#endif
+}
+
 void cmMakefile::AddDefinitionBool(const std::string& name, bool value)
 {
   this->AddDefinition(name, value ? "ON" : "OFF");
@@ -2558,6 +2592,12 @@ bool cmMakefile::GetDefExpandList(const std::string& name,
   return true;
 }
 
+cmPlainList const* cmMakefile::GetDefinitionList(
+  const std::string& name) const
+{
+  return this->StateSnapshot.GetDefinitionList(name);
+}
+
 std::vector<std::string> cmMakefile::GetDefinitions() const
 {
   std::vector<std::string> res = this->StateSnapshot.ClosureKeys();
@@ -2576,6 +2616,14 @@ const std::string& cmMakefile::ExpandVariablesInString(
   std::string& source, bool escapeQuotes, bool noEscapes, bool atOnly,
   const char* filename, long line, bool removeEmpty, bool replaceAt) const
 {
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(this->GetCMakeInstance()->GetProfilingOutput(),
+                          "expand", "expand variables");
+  }
+#endif
+
   bool compareResults = false;
   MessageType mtype = MessageType::LOG;
   std::string errorstr;
@@ -2798,6 +2846,33 @@ struct t_lookup
   size_t loc = 0;
 };
 
+struct cmListFileArgument::Expansion
+{
+  enum StepKind
+  {
+    Literal,
+    Escape,
+    OpenReference,
+    CloseReference
+  };
+
+  struct Step
+  {
+    StepKind Kind = Literal;
+    // The domain of an OpenReference.
+    t_domain Domain = NORMAL;
+    // The character of an Escape.
+    char Char = 0;
+    // The range of the argument value of a Literal.
+    size_t Begin = 0;
+    size_t Size = 0;
+    // The line of a CloseReference relative to the argument.
+    long Line = 0;
+  };
+
+  std::vector<Step> Steps;
+};
+
 bool cmMakefile::IsProjectFile(const char* filename) const
 {
   return cmSystemTools::IsSubDirectory(filename, this->GetHomeDirectory()) ||
@@ -2880,70 +2955,135 @@ cm::optional<std::string> cmMakefile::DeferGetCall(std::string const& id) const
 MessageType cmMakefile::ExpandVariablesInStringNew(
   std::string& errorstr, std::string& source, bool escapeQuotes,
   bool noEscapes, bool atOnly, const char* filename, long line,
-  bool replaceAt) const
+  bool replaceAt, cmListFileArgument const* arg) const
 {
   // This method replaces ${VAR} and @VAR@ where VAR is looked up
   // with GetDefinition(), if not found in the map, nothing is expanded.
   // It also supports the $ENV{VAR} syntax where VAR is looked up in
   // the current environment variables.
 
-  const char* in = source.c_str();
-  const char* last = in;
   std::string result;
   result.reserve(source.size());
   std::vector<t_lookup> openstack;
+
+  cmState* state = this->GetCMakeInstance()->GetState();
+
+  static const std::string lineVar = "CMAKE_CURRENT_LIST_LINE";
+
+  // Replace the name of the innermost variable reference at the end of
+  // the result with the value of the variable.
+  auto expandReference = [&](long refLine) {
+    t_lookup var = openstack.back();
+    openstack.pop_back();
+    std::string const& lookup = result.substr(var.loc);
+    cmProp value = nullptr;
+    std::string varresult;
+    std::string svalue;
+    switch (var.domain) {
+      case NORMAL:
+        if (filename && lookup == lineVar) {
+          cmListFileContext const& top = this->Backtrace.Top();
+          if (top.DeferId) {
+            varresult = cmStrCat("DEFERRED:"_s, *top.DeferId);
+          } else {
+            varresult = std::to_string(refLine);
+          }
+        } else {
+          value = this->GetDefinition(lookup);
+        }
+        break;
+      case ENVIRONMENT:
+        if (cmSystemTools::GetEnv(lookup, svalue)) {
+          value = &svalue;
+        }
+        break;
+      case CACHE:
+        value = state->GetCacheEntryValue(lookup);
+        break;
+    }
+    // Get the string we're meant to append to.
+    if (value) {
+      if (escapeQuotes) {
+        varresult = cmEscapeQuotes(*value);
+      } else {
+        varresult = *value;
+      }
+    } else if (!this->SuppressSideEffects) {
+      this->MaybeWarnUninitialized(lookup, filename);
+    }
+    result.replace(var.loc, result.size() - var.loc, varresult);
+  };
+
+  // Replay the steps parsed when the argument was first expanded.
+  using Expansion = cmListFileArgument::Expansion;
+  if (arg && arg->ParsedExpansion) {
+    for (Expansion::Step const& step : arg->ParsedExpansion->Steps) {
+      switch (step.Kind) {
+        case Expansion::Literal:
+          result.append(arg->Value, step.Begin, step.Size);
+          break;
+        case Expansion::Escape:
+          result += step.Char;
+          break;
+        case Expansion::OpenReference:
+          openstack.emplace_back();
+          openstack.back().domain = step.Domain;
+          openstack.back().loc = result.size();
+          break;
+        case Expansion::CloseReference:
+          expandReference(line + step.Line);
+          break;
+      }
+    }
+    source = std::move(result);
+    return MessageType::LOG;
+  }
+
+  const char* in = source.c_str();
+  const char* last = in;
   bool error = false;
   bool done = false;
   MessageType mtype = MessageType::LOG;
 
-  cmState* state = this->GetCMakeInstance()->GetState();
+  // Record the steps of the expansion of an argument.
+  std::unique_ptr<Expansion> expansion;
+  if (arg && !replaceAt) {
+    expansion = cm::make_unique<Expansion>();
+  }
+  long const firstLine = line;
+  auto appendLiteral = [&](const char* end) {
+    result.append(last, end - last);
+    if (expansion && end != last) {
+      Expansion::Step step;
+      step.Kind = Expansion::Literal;
+      step.Begin = last - source.c_str();
+      step.Size = end - last;
+      expansion->Steps.push_back(step);
+    }
+  };
+  auto appendEscape = [&](char c) {
+    result += c;
+    if (expansion) {
+      Expansion::Step step;
+      step.Kind = Expansion::Escape;
+      step.Char = c;
+      expansion->Steps.push_back(step);
+    }
+  };
 
-  static const std::string lineVar = "CMAKE_CURRENT_LIST_LINE";
   do {
     char inc = *in;
     switch (inc) {
       case '}':
         if (!openstack.empty()) {
-          t_lookup var = openstack.back();
-          openstack.pop_back();
-          result.append(last, in - last);
-          std::string const& lookup = result.substr(var.loc);
-          cmProp value = nullptr;
-          std::string varresult;
-          std::string svalue;
-          switch (var.domain) {
-            case NORMAL:
-              if (filename && lookup == lineVar) {
-                cmListFileContext const& top = this->Backtrace.Top();
-                if (top.DeferId) {
-                  varresult = cmStrCat("DEFERRED:"_s, *top.DeferId);
-                } else {
-                  varresult = std::to_string(line);
-                }
-              } else {
-                value = this->GetDefinition(lookup);
-              }
-              break;
-            case ENVIRONMENT:
-              if (cmSystemTools::GetEnv(lookup, svalue)) {
-                value = &svalue;
-              }
-              break;
-            case CACHE:
-              value = state->GetCacheEntryValue(lookup);
-              break;
+          appendLiteral(in);
+          if (expansion) {
+            Expansion::Step step;
+            step.Kind = Expansion::CloseReference;
+            step.Line = line - firstLine;
+            expansion->Steps.push_back(step);
           }
-          // Get the string we're meant to append to.
-          if (value) {
-            if (escapeQuotes) {
-              varresult = cmEscapeQuotes(*value);
-            } else {
-              varresult = *value;
-            }
-          } else if (!this->SuppressSideEffects) {
-            this->MaybeWarnUninitialized(lookup, filename);
-          }
-          result.replace(var.loc, result.size() - var.loc, varresult);
+          expandReference(line);
           // Start looking from here on out.
           last = in + 1;
         }
@@ -2960,7 +3100,7 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
             lookup.domain = NORMAL;
           } else if (nextc == '<') {
           } else if (!nextc) {
-            result.append(last, next - last);
+            appendLiteral(next);
             last = next;
           } else if (cmHasLiteralPrefix(next, "ENV{")) {
             // Looking for an environment variable.
@@ -2981,7 +3121,13 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
             }
           }
           if (start) {
-            result.append(last, in - last);
+            appendLiteral(in);
+            if (expansion) {
+              Expansion::Step step;
+              step.Kind = Expansion::OpenReference;
+              step.Domain = lookup.domain;
+              expansion->Steps.push_back(step);
+            }
             last = start;
             in = start - 1;
             lookup.loc = result.size();
@@ -2995,16 +3141,16 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
           const char* next = in + 1;
           char nextc = *next;
           if (nextc == 't') {
-            result.append(last, in - last);
-            result.append("\t");
+            appendLiteral(in);
+            appendEscape('\t');
             last = next + 1;
           } else if (nextc == 'n') {
-            result.append(last, in - last);
-            result.append("\n");
+            appendLiteral(in);
+            appendEscape('\n');
             last = next + 1;
           } else if (nextc == 'r') {
-            result.append(last, in - last);
-            result.append("\r");
+            appendLiteral(in);
+            appendEscape('\r');
             last = next + 1;
           } else if (nextc == ';' && openstack.empty()) {
             // Handled in ExpandListArgument; pass the backslash literally.
@@ -3019,7 +3165,7 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
             error = true;
           } else {
             // Take what we've found so far, skipping the escape character.
-            result.append(last, in - last);
+            appendLiteral(in);
             // Start tracking from the next character.
             last = in + 1;
           }
@@ -3119,9 +3265,12 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
     errorstr = emsg.str();
   } else {
     // Append the rest of the unchanged part of the string.
-    result.append(last);
+    appendLiteral(last + strlen(last));
 
     source = result;
+    if (expansion) {
+      arg->ParsedExpansion = std::move(expansion);
+    }
   }
 
   return mtype;
@@ -3249,6 +3398,42 @@ bool cmMakefile::IsLoopBlock() const
   return !this->LoopBlockCounter.empty() && this->LoopBlockCounter.top() > 0;
 }
 
+void cmMakefile::ExpandArgument(cmListFileArgument const& arg,
+                                std::string const& filename,
+                                std::string& value) const
+{
+  value = arg.Value;
+  if (this->GetPolicyStatus(cmPolicies::CMP0053) != cmPolicies::NEW
+#if !defined(CMAKE_BOOTSTRAP)
+      || this->GetCMakeInstance()->IsProfilingEnabled()
+#endif
+  ) {
+    this->ExpandVariablesInString(value, false, false, false, filename.c_str(),
+                                  arg.Line, false, false);
+    return;
+  }
+
+  // Without variable references or escapes there is nothing to expand.
+  static cm::string_view const special("$\\\0", 3);
+  if (!arg.ParsedExpansion &&
+      cm::string_view(arg.Value).find_first_of(special) ==
+        cm::string_view::npos) {
+    return;
+  }
+
+  // Parse the argument when first expanded and replay that later.
+  std::string errorstr;
+  MessageType mtype = this->ExpandVariablesInStringNew(
+    errorstr, value, false, false, false, filename.c_str(), arg.Line, false,
+    &arg);
+  if (mtype != MessageType::LOG) {
+    if (mtype == MessageType::FATAL_ERROR) {
+      cmSystemTools::SetFatalErrorOccured();
+    }
+    this->IssueMessage(mtype, errorstr);
+  }
+}
+
 bool cmMakefile::ExpandArguments(std::vector<cmListFileArgument> const& inArgs,
                                  std::vector<std::string>& outArgs) const
 {
@@ -3262,9 +3447,7 @@ bool cmMakefile::ExpandArguments(std::vector<cmListFileArgument> const& inArgs,
       continue;
     }
     // Expand the variables in the argument.
-    value = i.Value;
-    this->ExpandVariablesInString(value, false, false, false, filename.c_str(),
-                                  i.Line, false, false);
+    this->ExpandArgument(i, filename, value);
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
@@ -3291,9 +3474,7 @@ bool cmMakefile::ExpandArguments(
       continue;
     }
     // Expand the variables in the argument.
-    value = i.Value;
-    this->ExpandVariablesInString(value, false, false, false, filename.c_str(),
-                                  i.Line, false, false);
+    this->ExpandArgument(i, filename, value);
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
@@ -3486,6 +3667,32 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                            const std::string& targetName, bool fast, int jobs,
                            const std::vector<std::string>* cmakeArgs,
                            std::string& output)
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(this->GetCMakeInstance()->GetProfilingOutput(),
+                          "try_compile", "try_compile project");
+  }
+#endif
+
+  int ret = this->PrepareTryCompile(srcdir, bindir, fast, cmakeArgs);
+  if (ret != 0) {
+    return ret;
+  }
+
+  // finally call the generator to actually build the resulting project
+  this->IsSourceFileTryCompile = fast;
+  ret = this->GetGlobalGenerator()->TryCompile(
+    jobs, srcdir, bindir, projectName, targetName, fast, output, this);
+
+  this->IsSourceFileTryCompile = false;
+  return ret;
+}
+
+int cmMakefile::PrepareTryCompile(const std::string& srcdir,
+                                  const std::string& bindir, bool fast,
+                                  const std::vector<std::string>* cmakeArgs)
 {
   this->IsSourceFileTryCompile = fast;
   // does the binary directory exist ? If not create it...
@@ -3600,12 +3807,8 @@ int cmMakefile::TryCompile(const std::string& srcdir,
     return 1;
   }
 
-  // finally call the generator to actually build the resulting project
-  int ret = this->GetGlobalGenerator()->TryCompile(
-    jobs, srcdir, bindir, projectName, targetName, fast, output, this);
-
   this->IsSourceFileTryCompile = false;
-  return ret;
+  return 0;
 }
 
 bool cmMakefile::GetIsSourceFileTryCompile() const
@@ -3613,6 +3816,18 @@ bool cmMakefile::GetIsSourceFileTryCompile() const
   return this->IsSourceFileTryCompile;
 }
 
+#if !defined(CMAKE_BOOTSTRAP)
+void cmMakefile::SetTryCompileBatch(std::unique_ptr<cmTryCompileBatch> batch)
+{
+  this->TryCompileBatch = std::move(batch);
+}
+
+std::unique_ptr<cmTryCompileBatch> cmMakefile::TakeTryCompileBatch()
+{
+  return std::move(this->TryCompileBatch);
+}
+#endif
+
 cmake* cmMakefile::GetCMakeInstance() const
 {
   return this->GlobalGenerator->GetCMakeInstance();
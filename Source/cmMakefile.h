@@ -54,10 +54,12 @@ class cmImplicitDependsList;
 class cmInstallGenerator;
 class cmLocalGenerator;
 class cmMessenger;
+class cmPlainList;
 class cmSourceFile;
 class cmState;
 class cmTest;
 class cmTestGenerator;
+class cmTryCompileBatch;
 class cmVariableWatch;
 class cmake;
 
@@ -132,8 +134,27 @@ public:
                  const std::vector<std::string>* cmakeArgs,
                  std::string& output);
 
+  /**
+   * Configure and generate the project of a TryCompile without building
+   * it.  Returns 0 on success.
+   */
+  int PrepareTryCompile(const std::string& srcdir, const std::string& bindir,
+                        bool fast, const std::vector<std::string>* cmakeArgs);
+
   bool GetIsSourceFileTryCompile() const;
 
+#if !defined(CMAKE_BOOTSTRAP)
+  /**
+   * The try_compile batch started in this directory, if any.
+   */
+  cmTryCompileBatch* GetTryCompileBatch() const
+  {
+    return this->TryCompileBatch.get();
+  }
+  void SetTryCompileBatch(std::unique_ptr<cmTryCompileBatch> batch);
+  std::unique_ptr<cmTryCompileBatch> TakeTryCompileBatch();
+#endif
+
   /**
    * Help enforce global target name uniqueness.
    */
@@ -282,6 +303,11 @@ public:
    * can be used in CMake to refer to lists, directories, etc.
    */
   void AddDefinition(const std::string& name, cm::string_view value);
+  /**
+   * Append a suffix to the value of a variable definition, or to the
+   * cache entry it shadows.  The suffix is appended in place if possible.
+   */
+  void AppendDefinition(const std::string& name, cm::string_view suffix);
   /**
    * Add bool variable definition to the build.
    */
@@ -488,6 +514,13 @@ public:
   bool IsDefinitionSet(const std::string&) const;
   bool GetDefExpandList(const std::string& name, std::vector<std::string>& out,
                         bool emptyArgs = false) const;
+  /**
+   * Return the elements of a variable definition whose value is a plain
+   * list, or nullptr.  Cache entries are not considered.  Variable
+   * watches are not notified, so call GetDefinition first.  The result
+   * is valid until the variable is changed.
+   */
+  cmPlainList const* GetDefinitionList(const std::string& name) const;
   /**
    * Get the list of all variables in the current space. If argument
    * cacheonly is specified and is greater than 0, then only cache
@@ -979,6 +1012,7 @@ protected:
 #if !defined(CMAKE_BOOTSTRAP)
   std::vector<cmSourceGroup> SourceGroups;
   size_t ObjectLibrariesSourceGroupIndex;
+  std::unique_ptr<cmTryCompileBatch> TryCompileBatch;
 #endif
 
   cmGlobalGenerator* GlobalGenerator;
@@ -1076,11 +1110,15 @@ private:
                                          long line, bool removeEmpty,
                                          bool replaceAt) const;
   // CMP0053 == new
-  MessageType ExpandVariablesInStringNew(std::string& errorstr,
-                                         std::string& source,
-                                         bool escapeQuotes, bool noEscapes,
-                                         bool atOnly, const char* filename,
-                                         long line, bool replaceAt) const;
+  // If arg is given, source is its value.  The steps of the expansion
+  // are parsed when the argument is first expanded and replayed later.
+  MessageType ExpandVariablesInStringNew(
+    std::string& errorstr, std::string& source, bool escapeQuotes,
+    bool noEscapes, bool atOnly, const char* filename, long line,
+    bool replaceAt, cmListFileArgument const* arg = nullptr) const;
+
+  void ExpandArgument(cmListFileArgument const& arg,
+                      std::string const& filename, std::string& value) const;
 
   bool ValidateCustomCommand(const cmCustomCommandLines& commandLines) const;
 
@@ -2,9 +2,10 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmMakefileProfilingData.h"
 
-#include <chrono>
+#include <algorithm>
+#include <iomanip>
 #include <stdexcept>
-#include <vector>
+#include <utility>
 
 #include <cm3p/json/value.h>
 #include <cm3p/json/writer.h>
@@ -16,8 +17,19 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
+namespace {
+// Entries of this category are aggregated but not traced.
+const char* const kExpandCategory = "expand";
+
+double ToMilliseconds(std::chrono::steady_clock::duration d)
+{
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+}
+
 cmMakefileProfilingData::cmMakefileProfilingData(
-  const std::string& profileStream)
+  const std::string& profileStream, Format format)
+  : OutputFormat(format)
 {
   std::ios::openmode omode = std::ios::out | std::ios::trunc;
   this->ProfileStream.open(profileStream.c_str(), omode);
@@ -28,14 +40,26 @@ cmMakefileProfilingData::cmMakefileProfilingData(
     throw std::runtime_error(std::string("Unable to open: ") + profileStream);
   }
 
-  this->ProfileStream << "[";
+  if (this->OutputFormat == Format::GoogleTrace) {
+    this->ProfileStream << "[";
+  }
 };
 
 cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 {
   if (this->ProfileStream.good()) {
     try {
-      this->ProfileStream << "]";
+      switch (this->OutputFormat) {
+        case Format::GoogleTrace:
+          this->ProfileStream << "]";
+          break;
+        case Format::Folded:
+          this->WriteFolded();
+          break;
+        case Format::Summary:
+          this->WriteSummary();
+          break;
+      }
       this->ProfileStream.close();
     } catch (...) {
       cmSystemTools::Error("Error writing profiling output!");
@@ -46,8 +70,10 @@ cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
                                          cmListFileContext const& lfc)
 {
+  this->PushFrame("cmake", lff.LowerCaseName(), lfc.FilePath, true);
+
   /* Do not try again if we previously failed to write to output. */
-  if (!this->ProfileStream.good()) {
+  if (!this->Frames.back().Traced || !this->ProfileStream.good()) {
     return;
   }
 
@@ -62,7 +88,7 @@ void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
     v["cat"] = "cmake";
     v["ts"] = Json::Value::UInt64(
       std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::steady_clock::now().time_since_epoch())
+        this->Frames.back().Start.time_since_epoch())
         .count());
     v["pid"] = static_cast<int>(info.GetProcessId());
     v["tid"] = 0;
@@ -86,10 +112,89 @@ void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
   }
 }
 
+void cmMakefileProfilingData::StartEntry(const std::string& category,
+                                         const std::string& name)
+{
+  std::string file;
+  if (!this->Frames.empty()) {
+    file = this->Frames.back().File;
+  }
+  this->PushFrame(category, name, std::move(file), false);
+
+  /* Do not try again if we previously failed to write to output. */
+  if (!this->Frames.back().Traced || !this->ProfileStream.good()) {
+    return;
+  }
+
+  try {
+    if (this->ProfileStream.tellp() > 1) {
+      this->ProfileStream << ",";
+    }
+    cmsys::SystemInformation info;
+    Json::Value v;
+    v["ph"] = "B";
+    v["name"] = name;
+    v["cat"] = category;
+    v["ts"] = Json::Value::UInt64(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        this->Frames.back().Start.time_since_epoch())
+        .count());
+    v["pid"] = static_cast<int>(info.GetProcessId());
+    v["tid"] = 0;
+    this->JsonWriter->write(v, &this->ProfileStream);
+  } catch (std::ios_base::failure& fail) {
+    cmSystemTools::Error(
+      cmStrCat("Failed to write to profiling output: ", fail.what()));
+  } catch (...) {
+    cmSystemTools::Error("Error writing profiling output!");
+  }
+}
+
+void cmMakefileProfilingData::PushFrame(std::string category,
+                                        std::string name, std::string file,
+                                        bool command)
+{
+  Frame frame;
+  if (this->OutputFormat == Format::Folded) {
+    // Semicolons separate the labels of a folded stack.
+    std::string label = name;
+    std::replace(label.begin(), label.end(), ';', ',');
+    if (!this->Frames.empty()) {
+      frame.Stack = cmStrCat(this->Frames.back().Stack, ';', label);
+    } else {
+      frame.Stack = std::move(label);
+    }
+  }
+  frame.Category = std::move(category);
+  frame.Name = std::move(name);
+  frame.File = std::move(file);
+  frame.Command = command;
+  frame.Traced = this->OutputFormat == Format::GoogleTrace &&
+    frame.Category != kExpandCategory;
+  frame.Start = Clock::now();
+  this->Frames.push_back(std::move(frame));
+}
+
 void cmMakefileProfilingData::StopEntry()
 {
+  if (this->Frames.empty()) {
+    return;
+  }
+  Clock::time_point const now = Clock::now();
+  Frame const frame = std::move(this->Frames.back());
+  this->Frames.pop_back();
+
+  Clock::duration const total = now - frame.Start;
+  Clock::duration const self = total - frame.Children;
+  if (!this->Frames.empty()) {
+    this->Frames.back().Children += total;
+  }
+  if (this->OutputFormat != Format::GoogleTrace) {
+    this->Aggregate(frame, total, self);
+  }
+
   /* Do not try again if we previously failed to write to output. */
-  if (!this->ProfileStream.good()) {
+  if (!frame.Traced || !this->ProfileStream.good()) {
     return;
   }
 
@@ -100,7 +205,7 @@ void cmMakefileProfilingData::StopEntry()
     v["ph"] = "E";
     v["ts"] = Json::Value::UInt64(
       std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::steady_clock::now().time_since_epoch())
+        now.time_since_epoch())
         .count());
     v["pid"] = static_cast<int>(info.GetProcessId());
     v["tid"] = 0;
@@ -112,3 +217,109 @@ void cmMakefileProfilingData::StopEntry()
     cmSystemTools::Error("Error writing profiling output!");
   }
 }
+
+void cmMakefileProfilingData::Aggregate(Frame const& frame,
+                                        Clock::duration total,
+                                        Clock::duration self)
+{
+  // The total time of an entry nested in another one with the same key is
+  // already part of the outer total.
+  auto isNested = [this](bool (*same)(Frame const&, Frame const&),
+                         Frame const& f) -> bool {
+    return std::any_of(this->Frames.begin(), this->Frames.end(),
+                       [&](Frame const& outer) { return same(outer, f); });
+  };
+
+  Totals& category = this->Categories[frame.Category];
+  ++category.Count;
+  category.Self += self;
+  if (!isNested(
+        [](Frame const& a, Frame const& b) {
+          return a.Category == b.Category;
+        },
+        frame)) {
+    category.Total += total;
+  }
+  if (frame.Command) {
+    Totals& command = this->Commands[frame.Name];
+    ++command.Count;
+    command.Self += self;
+    if (!isNested(
+          [](Frame const& a, Frame const& b) {
+            return a.Command && a.Name == b.Name;
+          },
+          frame)) {
+      command.Total += total;
+    }
+  }
+  if (!frame.File.empty()) {
+    Totals& file = this->Files[frame.File];
+    file.Self += self;
+    if (frame.Command) {
+      ++file.Count;
+      if (!isNested(
+            [](Frame const& a, Frame const& b) {
+              return a.Command && a.File == b.File;
+            },
+            frame)) {
+        file.Total += total;
+      }
+    }
+  }
+  if (this->OutputFormat == Format::Folded) {
+    this->Stacks[frame.Stack] += self;
+  }
+}
+
+void cmMakefileProfilingData::WriteFolded()
+{
+  // One line per distinct stack with its self time in microseconds, as
+  // expected by flame graph tools.
+  for (auto const& s : this->Stacks) {
+    auto const us =
+      std::chrono::duration_cast<std::chrono::microseconds>(s.second).count();
+    if (us > 0) {
+      this->ProfileStream << s.first << ' ' << us << '\n';
+    }
+  }
+}
+
+void cmMakefileProfilingData::WriteSummary()
+{
+  using Row = std::pair<std::string, Totals>;
+  auto writeTable = [this](const char* title, const char* column,
+                           std::map<std::string, Totals> const& totals) {
+    std::vector<Row> rows(totals.begin(), totals.end());
+    std::stable_sort(rows.begin(), rows.end(), [](Row const& a, Row const& b) {
+      return a.second.Self > b.second.Self;
+    });
+    std::ostream& os = this->ProfileStream;
+    os << title << ":\n"
+       << std::setw(14) << "Self [ms]" << std::setw(14) << "Total [ms]"
+       << std::setw(10) << "Calls"
+       << "  " << column << '\n';
+    os << std::fixed << std::setprecision(3);
+    for (Row const& row : rows) {
+      os << std::setw(14) << ToMilliseconds(row.second.Self) << std::setw(14)
+         << ToMilliseconds(row.second.Total) << std::setw(10)
+         << row.second.Count << "  " << row.first << '\n';
+    }
+    os << '\n';
+  };
+  writeTable("Categories", "Category", this->Categories);
+  writeTable("Commands", "Command", this->Commands);
+  writeTable("List files", "File", this->Files);
+}
+
+cmMakefileProfilingData::RAII::RAII(cmMakefileProfilingData& data,
+                                    const std::string& category,
+                                    const std::string& name)
+  : Data(data)
+{
+  this->Data.StartEntry(category, name);
+}
+
+cmMakefileProfilingData::RAII::~RAII()
+{
+  this->Data.StopEntry();
+}
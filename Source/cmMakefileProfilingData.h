@@ -1,8 +1,11 @@
 /* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #pragma once
+#include <chrono>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cmsys/FStream.hxx"
 
@@ -13,15 +16,85 @@ class StreamWriter;
 class cmListFileContext;
 class cmListFileFunction;
 
+/** \class cmMakefileProfilingData
+ * \brief Records where cmake spends its time.
+ *
+ * Entries are started and stopped in nested order for every command
+ * invocation and for other work of interest such as the generate step.
+ * In the google-trace format each entry is written as a pair of events.
+ * Variable expansions are too frequent to be written that way.  The
+ * folded and summary formats instead aggregate the time of all entries
+ * and write the result when profiling ends.
+ */
 class cmMakefileProfilingData
 {
 public:
-  cmMakefileProfilingData(const std::string&);
+  enum class Format
+  {
+    GoogleTrace,
+    Folded,
+    Summary,
+  };
+
+  cmMakefileProfilingData(const std::string&,
+                          Format format = Format::GoogleTrace);
   ~cmMakefileProfilingData() noexcept;
   void StartEntry(const cmListFileFunction& lff, cmListFileContext const& lfc);
+  void StartEntry(const std::string& category, const std::string& name);
   void StopEntry();
 
+  /** Start an entry for the lifetime of this object.  */
+  class RAII
+  {
+  public:
+    RAII(cmMakefileProfilingData& data, const std::string& category,
+         const std::string& name);
+    ~RAII();
+
+    RAII(RAII const&) = delete;
+    RAII& operator=(RAII const&) = delete;
+
+  private:
+    cmMakefileProfilingData& Data;
+  };
+
 private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Frame
+  {
+    Clock::time_point Start;
+    Clock::duration Children = Clock::duration::zero();
+    std::string Category;
+    std::string Name;
+    // Path of the list file for commands, or of the enclosing command
+    std::string File;
+    // Labels of this and all enclosing entries, separated by ';'
+    std::string Stack;
+    bool Command = false;
+    bool Traced = false;
+  };
+
+  struct Totals
+  {
+    unsigned long long Count = 0;
+    Clock::duration Total = Clock::duration::zero();
+    Clock::duration Self = Clock::duration::zero();
+  };
+
+  void PushFrame(std::string category, std::string name, std::string file,
+                 bool command);
+  void Aggregate(Frame const& frame, Clock::duration total,
+                 Clock::duration self);
+  void WriteFolded();
+  void WriteSummary();
+
+  Format OutputFormat;
   cmsys::ofstream ProfileStream;
   std::unique_ptr<Json::StreamWriter> JsonWriter;
+  std::vector<Frame> Frames;
+  std::map<std::string, Totals> Commands;
+  std::map<std::string, Totals> Files;
+  std::map<std::string, Totals> Categories;
+  std::map<std::string, Clock::duration> Stacks;
 };
@@ -173,6 +173,8 @@ void cmMakefileTargetGenerator::CreateRuleFile()
     return;
   }
   this->BuildFileStream->SetCopyIfDifferent(true);
+  this->BuildFileStream->SetDeferredReplacements(
+    this->GlobalGenerator->GetDeferredFileReplacements());
   this->LocalGenerator->WriteDisclaimer(*this->BuildFileStream);
   if (this->GlobalGenerator->AllowDeleteOnError()) {
     std::vector<std::string> no_depends;
@@ -416,6 +418,8 @@ void cmMakefileTargetGenerator::WriteCommonCodeRules()
     return;
   }
   this->FlagFileStream->SetCopyIfDifferent(true);
+  this->FlagFileStream->SetDeferredReplacements(
+    this->GlobalGenerator->GetDeferredFileReplacements());
   this->LocalGenerator->WriteDisclaimer(*this->FlagFileStream);
 
   // Include the flags for the target.
@@ -1349,6 +1353,8 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     return;
   }
   this->InfoFileStream->SetCopyIfDifferent(true);
+  this->InfoFileStream->SetDeferredReplacements(
+    this->GlobalGenerator->GetDeferredFileReplacements());
   this->LocalGenerator->WriteDependLanguageInfo(*this->InfoFileStream,
                                                 this->GeneratorTarget);
 
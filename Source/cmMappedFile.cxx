@@ -0,0 +1,94 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmMappedFile.h"
+
+#if defined(_WIN32)
+#  include <windows.h>
+
+#  include "cmsys/Encoding.hxx"
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+#if defined(_WIN32)
+bool cmMappedFile::Open(std::string const& path)
+{
+  this->Close();
+  HANDLE file =
+    CreateFileW(cmsys::Encoding::ToWindowsExtendedPath(path).c_str(),
+                GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+    CloseHandle(file);
+    return false;
+  }
+  this->Mapping =
+    CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!this->Mapping) {
+    return false;
+  }
+  void* base = MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!base) {
+    CloseHandle(this->Mapping);
+    this->Mapping = nullptr;
+    return false;
+  }
+  this->Base = static_cast<char const*>(base);
+  this->Length = static_cast<std::size_t>(size.QuadPart);
+  return true;
+}
+
+void cmMappedFile::Close()
+{
+  if (this->Base) {
+    UnmapViewOfFile(this->Base);
+    this->Base = nullptr;
+  }
+  if (this->Mapping) {
+    CloseHandle(this->Mapping);
+    this->Mapping = nullptr;
+  }
+  this->Length = 0;
+}
+#else
+bool cmMappedFile::Open(std::string const& path)
+{
+  this->Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  std::size_t const length = static_cast<std::size_t>(st.st_size);
+  void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+  this->Base = static_cast<char const*>(base);
+  this->Length = length;
+  return true;
+}
+
+void cmMappedFile::Close()
+{
+  if (this->Base) {
+    munmap(const_cast<char*>(this->Base), this->Length);
+    this->Base = nullptr;
+  }
+  this->Length = 0;
+}
+#endif
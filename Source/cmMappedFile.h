@@ -0,0 +1,42 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <string>
+
+#include <cm/string_view>
+
+/** \class cmMappedFile
+ * \brief Read-only view of a whole file, mapped into memory.
+ *
+ * Empty files cannot be mapped and fail to open.
+ */
+class cmMappedFile
+{
+public:
+  cmMappedFile() = default;
+  ~cmMappedFile() { this->Close(); }
+
+  cmMappedFile(cmMappedFile const&) = delete;
+  cmMappedFile& operator=(cmMappedFile const&) = delete;
+
+  bool Open(std::string const& path);
+  void Close();
+
+  char const* Data() const { return this->Base; }
+  std::size_t Size() const { return this->Length; }
+  cm::string_view View() const
+  {
+    return cm::string_view(this->Base, this->Length);
+  }
+
+private:
+  char const* Base = nullptr;
+  std::size_t Length = 0;
+#if defined(_WIN32)
+  void* Mapping = nullptr;
+#endif
+};
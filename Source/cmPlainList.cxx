@@ -0,0 +1,42 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmPlainList.h"
+
+cmPlainList::cmPlainList(cm::string_view value)
+  : Value(value)
+{
+  this->Plain = this->Split(0);
+}
+
+void cmPlainList::Append(cm::string_view value)
+{
+  std::size_t const pos = this->Value.size();
+  this->Value = value;
+  if (this->Plain) {
+    this->Plain = this->Split(pos);
+  }
+}
+
+cm::string_view cmPlainList::operator[](std::size_t i) const
+{
+  std::size_t const begin = i == 0 ? 0 : this->Separators[i - 1] + 1;
+  std::size_t const end =
+    i < this->Separators.size() ? this->Separators[i] : this->Value.size();
+  return this->Value.substr(begin, end - begin);
+}
+
+bool cmPlainList::Split(std::size_t pos)
+{
+  for (pos = this->Value.find_first_of(";[]\\", pos);
+       pos != cm::string_view::npos;
+       pos = this->Value.find_first_of(";[]\\", pos + 1)) {
+    if (this->Value[pos] != ';') {
+      // Elements may contain escaped or bracketed semicolons.
+      this->Separators.clear();
+      this->Separators.shrink_to_fit();
+      return false;
+    }
+    this->Separators.push_back(pos);
+  }
+  return true;
+}
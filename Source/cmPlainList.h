@@ -0,0 +1,51 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <vector>
+
+#include <cm/string_view>
+
+/** \class cmPlainList
+ * \brief Elements of a variable value used as a list.
+ *
+ * A value without square brackets or backslashes is a plain list.  It is
+ * split at every semicolon, like cmExpandList does with empty elements,
+ * so its elements can be referenced by the offsets of the semicolons.
+ * cmDefinitions keeps them with the value to give list operations
+ * constant time access to the elements.
+ */
+class cmPlainList
+{
+public:
+  /** Split the given value, which must outlive this instance.  */
+  explicit cmPlainList(cm::string_view value);
+
+  /** Return whether the value is a plain list.  */
+  bool IsPlain() const { return this->Plain; }
+
+  /**
+   * Account for text appended to the value.  The given value must start
+   * with the previous one but may have moved.
+   */
+  void Append(cm::string_view value);
+
+  /** Return the number of elements.  An empty value has none.  */
+  std::size_t size() const
+  {
+    return this->Value.empty() ? 0 : this->Separators.size() + 1;
+  }
+
+  /** Return the element at the given index, which must be valid.  */
+  cm::string_view operator[](std::size_t i) const;
+
+private:
+  bool Split(std::size_t pos);
+
+  cm::string_view Value;
+  std::vector<std::size_t> Separators;
+  bool Plain = true;
+};
@@ -410,7 +410,8 @@ void cmState::AddBuiltinCommand(std::string const& name, Command command)
 {
   assert(name == cmSystemTools::LowerCase(name));
   assert(this->BuiltinCommands.find(name) == this->BuiltinCommands.end());
-  this->BuiltinCommands.emplace(name, std::move(command));
+  this->BuiltinCommands.emplace(
+    name, std::make_shared<Command const>(std::move(command)));
 }
 
 static bool InvokeBuiltinCommand(cmState::BuiltinCommand command,
@@ -511,11 +512,13 @@ bool cmState::AddScriptedCommand(std::string const& name, BT<Command> command,
   }
 
   // if the command already exists, give a new name to the old command.
-  if (Command oldCmd = this->GetCommandByExactName(sName)) {
-    this->ScriptedCommands["_" + sName] = oldCmd;
+  if (std::shared_ptr<Command const> oldCmd =
+        this->GetCommandToInvoke(sName)) {
+    this->ScriptedCommands["_" + sName] = std::move(oldCmd);
   }
 
-  this->ScriptedCommands[sName] = std::move(command.Value);
+  this->ScriptedCommands[sName] =
+    std::make_shared<Command const>(std::move(command.Value));
   return true;
 }
 
@@ -525,6 +528,16 @@ cmState::Command cmState::GetCommand(std::string const& name) const
 }
 
 cmState::Command cmState::GetCommandByExactName(std::string const& name) const
+{
+  if (std::shared_ptr<Command const> command =
+        this->GetCommandToInvoke(name)) {
+    return *command;
+  }
+  return nullptr;
+}
+
+std::shared_ptr<cmState::Command const> cmState::GetCommandToInvoke(
+  std::string const& name) const
 {
   auto pos = this->ScriptedCommands.find(name);
   if (pos != this->ScriptedCommands.end()) {
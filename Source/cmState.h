@@ -156,6 +156,10 @@ public:
   Command GetCommand(std::string const& name) const;
   // Returns a command from its name, or nullptr
   Command GetCommandByExactName(std::string const& name) const;
+  // Returns a command from its name, or nullptr, without copying it.
+  // The command stays alive while in use even if it is redefined.
+  std::shared_ptr<Command const> GetCommandToInvoke(
+    std::string const& name) const;
 
   void AddBuiltinCommand(std::string const& name,
                          std::unique_ptr<cmCommand> command);
@@ -228,8 +232,10 @@ private:
 
   cmPropertyDefinitionMap PropertyDefinitions;
   std::vector<std::string> EnabledLanguages;
-  std::unordered_map<std::string, Command> BuiltinCommands;
-  std::unordered_map<std::string, Command> ScriptedCommands;
+  std::unordered_map<std::string, std::shared_ptr<Command const>>
+    BuiltinCommands;
+  std::unordered_map<std::string, std::shared_ptr<Command const>>
+    ScriptedCommands;
   std::unordered_set<std::string> FlowControlCommands;
   cmPropertyMap GlobalProperties;
   std::unique_ptr<cmCacheManager> CacheManager;
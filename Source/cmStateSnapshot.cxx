@@ -208,6 +208,14 @@ std::string const* cmStateSnapshot::GetDefinition(
   return cmDefinitions::Get(name, this->Position->Vars, this->Position->Root);
 }
 
+cmPlainList const* cmStateSnapshot::GetDefinitionList(
+  std::string const& name) const
+{
+  assert(this->Position->Vars.IsValid());
+  return cmDefinitions::GetList(name, this->Position->Vars,
+                                this->Position->Root);
+}
+
 bool cmStateSnapshot::IsInitialized(std::string const& name) const
 {
   return cmDefinitions::HasKey(name, this->Position->Vars,
@@ -220,6 +228,13 @@ void cmStateSnapshot::SetDefinition(std::string const& name,
   this->Position->Vars->Set(name, value);
 }
 
+void cmStateSnapshot::AppendDefinition(std::string const& name,
+                                       cm::string_view current,
+                                       cm::string_view suffix)
+{
+  this->Position->Vars->Append(name, current, suffix);
+}
+
 void cmStateSnapshot::RemoveDefinition(std::string const& name)
 {
   this->Position->Vars->Unset(name);
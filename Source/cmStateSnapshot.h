@@ -14,6 +14,7 @@
 #include "cmPolicies.h"
 #include "cmStateTypes.h"
 
+class cmPlainList;
 class cmState;
 class cmStateDirectory;
 
@@ -24,8 +25,11 @@ public:
   cmStateSnapshot(cmState* state, cmStateDetail::PositionType position);
 
   std::string const* GetDefinition(std::string const& name) const;
+  cmPlainList const* GetDefinitionList(std::string const& name) const;
   bool IsInitialized(std::string const& name) const;
   void SetDefinition(std::string const& name, cm::string_view value);
+  void AppendDefinition(std::string const& name, cm::string_view current,
+                        cm::string_view suffix);
   void RemoveDefinition(std::string const& name);
   std::vector<std::string> ClosureKeys() const;
   bool RaiseScope(std::string const& var, const char* varDef);
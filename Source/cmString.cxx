@@ -23,6 +23,27 @@ void String::internally_mutate_to_stable_string()
   *this = String(this->data(), this->size());
 }
 
+void String::internally_append(string_view v)
+{
+  // Our buffer was allocated as a mutable std::string.  If nobody else
+  // shares it and it does not hold the appended text, extend it.
+  if (this->string_ && this->string_.use_count() == 1 &&
+      this->data() == this->string_->data() &&
+      this->size() == this->string_->size() &&
+      (v.data() < this->data() || v.data() > this->data() + this->size())) {
+    std::string& s = const_cast<std::string&>(*this->string_);
+    s.append(v.data(), v.size());
+    this->view_ = string_view(s.data(), s.size());
+    return;
+  }
+
+  std::string r;
+  r.reserve(this->size() + v.size());
+  r.assign(this->data(), this->size());
+  r.append(v.data(), v.size());
+  *this = std::move(r);
+}
+
 bool String::is_stable() const
 {
   return this->str_if_stable() != nullptr;
@@ -406,17 +406,14 @@ public:
   const_reverse_iterator crend() const noexcept { return this->rend(); }
 
   /** Append to the string using any type that implements the
-      AsStringView trait.  */
+      AsStringView trait.  If this instance is the only owner of the
+      buffer it views entirely, the buffer is extended in place.  */
   template <typename T>
   typename std::enable_if<AsStringView<T>::value, String&>::type operator+=(
     T&& s)
   {
-    string_view v = AsStringView<T>::view(std::forward<T>(s));
-    std::string r;
-    r.reserve(this->size() + v.size());
-    r.assign(this->data(), this->size());
-    r.append(v.data(), v.size());
-    return *this = std::move(r);
+    this->internally_append(AsStringView<T>::view(std::forward<T>(s)));
+    return *this;
   }
 
   /** Assign to an empty string.  */
@@ -656,6 +653,8 @@ private:
 
   void internally_mutate_to_stable_string();
 
+  void internally_append(string_view v);
+
   std::shared_ptr<std::string const> string_;
   string_view view_;
 };
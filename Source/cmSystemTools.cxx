@@ -6,6 +6,11 @@
 // NOLINTNEXTLINE(bugprone-reserved-identifier)
 #  define _POSIX_C_SOURCE 200809L
 #endif
+#if defined(__linux__)
+// For syscall
+// NOLINTNEXTLINE(bugprone-reserved-identifier)
+#  define _DEFAULT_SOURCE
+#endif
 #if defined(__OpenBSD__) || defined(__FreeBSD__) || defined(__NetBSD__) ||    \
   defined(__QNX__)
 // For isascii
@@ -99,6 +104,14 @@
 #  include <mach-o/dyld.h>
 #endif
 
+#if defined(__linux__)
+#  include <linux/fs.h>
+#  include <sys/ioctl.h>
+#  include <sys/sendfile.h>
+#  include <sys/stat.h>
+#  include <sys/syscall.h>
+#endif
+
 #ifdef __QNX__
 #  include <malloc.h> /* for malloc/free on QNX */
 #endif
@@ -173,6 +186,110 @@ void ReportError(std::string* err)
   *err = strerror(errno);
 #endif
 }
+
+#if defined(__linux__)
+// Copy the rest of a file from the current offsets with the fastest
+// method that works, continuing with the next one if a method fails.
+// The in-kernel methods are used only for files of known size because
+// they may report an early end for others, like those in /proc.
+bool CopyFileDescriptorContent(int in, int out, off_t size)
+{
+  ssize_t n = 1;
+  if (size > 0) {
+    size_t const chunk = 1 << 30;
+#  if defined(__NR_copy_file_range)
+    while (n > 0) {
+      n = syscall(__NR_copy_file_range, in, nullptr, out, nullptr, chunk, 0u);
+    }
+#  endif
+    if (n != 0) {
+      n = 1;
+      while (n > 0) {
+        n = sendfile(out, in, nullptr, chunk);
+      }
+    }
+    if (n == 0 && lseek(out, 0, SEEK_CUR) >= size) {
+      return true;
+    }
+  }
+
+  char buffer[65536];
+  while ((n = read(in, buffer, sizeof(buffer))) != 0) {
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    char const* data = buffer;
+    while (n > 0) {
+      ssize_t const written = write(out, data, static_cast<size_t>(n));
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      data += written;
+      n -= written;
+    }
+  }
+  return true;
+}
+#endif
+
+// Copy the content of a file, cloning it where the file system supports
+// that and otherwise copying it within the kernel where possible.
+bool CopyFileContent(std::string const& oldname, std::string const& newname)
+{
+#if defined(__linux__)
+  int const in = open(oldname.c_str(), O_RDONLY | O_CLOEXEC);
+  if (in < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(in, &st) != 0) {
+    int const e = errno;
+    close(in);
+    errno = e;
+    return false;
+  }
+
+  // Try to remove the destination so that read-only files can be
+  // replaced.  Opening it may still succeed if removing it fails.
+  cmSystemTools::RemoveFile(newname);
+
+  int const out = open(newname.c_str(),
+                       O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                       S_IRUSR | S_IWUSR);
+  if (out < 0) {
+    int const e = errno;
+    close(in);
+    errno = e;
+    return false;
+  }
+
+  off_t const size = S_ISREG(st.st_mode) ? st.st_size : 0;
+  bool success = false;
+#  if defined(FICLONE)
+  success = size > 0 && ioctl(out, FICLONE, in) == 0;
+#  endif
+  if (!success) {
+    success = CopyFileDescriptorContent(in, out, size);
+  }
+  int const e = errno;
+  close(in);
+  if (close(out) != 0 && success) {
+    return false;
+  }
+  errno = e;
+  return success;
+#else
+  // if cloning did not succeed, fall back to blockwise copy
+  return cmsys::SystemTools::CloneFileContent(oldname, newname) ||
+    cmsys::SystemTools::CopyFileContentBlockwise(oldname, newname);
+#endif
+}
 }
 
 bool cmSystemTools::s_RunCommandHideConsole = false;
@@ -1024,12 +1141,9 @@ cmSystemTools::CopyResult cmSystemTools::CopySingleFile(
     return CopyResult::Success;
   }
 
-  if (!cmsys::SystemTools::CloneFileContent(oldname, newname)) {
-    // if cloning did not succeed, fall back to blockwise copy
-    if (!cmsys::SystemTools::CopyFileContentBlockwise(oldname, newname)) {
-      ReportError(err);
-      return CopyResult::Failure;
-    }
+  if (!CopyFileContent(oldname, newname)) {
+    ReportError(err);
+    return CopyResult::Failure;
   }
   if (perms) {
     if (!SystemTools::SetPermissions(newname, perm)) {
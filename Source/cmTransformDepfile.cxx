@@ -11,52 +11,33 @@
 
 #include "cmsys/FStream.hxx"
 
-#include "cmGccDepfileReader.h"
 #include "cmGccDepfileReaderTypes.h"
-#include "cmLocalGenerator.h"
 #include "cmSystemTools.h"
 
 namespace {
-void WriteFilenameGcc(cmsys::ofstream& fout, const std::string& filename)
+bool PathEqOrSubDir(std::string const& a, std::string const& b)
+{
+  return (cmSystemTools::ComparePath(a, b) ||
+          cmSystemTools::IsSubDirectory(a, b));
+}
+
+void WriteFilenameGcc(std::string& out, const std::string& filename)
 {
   for (auto c : filename) {
     switch (c) {
       case ' ':
-        fout << "\\ ";
+        out += "\\ ";
         break;
       case '\\':
-        fout << "\\\\";
+        out += "\\\\";
         break;
       default:
-        fout << c;
+        out += c;
         break;
     }
   }
 }
 
-void WriteGccDepfile(cmsys::ofstream& fout, const cmLocalGenerator& lg,
-                     const cmGccDepfileContent& content)
-{
-  const auto& binDir = lg.GetBinaryDirectory();
-
-  for (auto const& dep : content) {
-    bool first = true;
-    for (auto const& rule : dep.rules) {
-      if (!first) {
-        fout << " \\\n  ";
-      }
-      first = false;
-      WriteFilenameGcc(fout, lg.MaybeConvertToRelativePath(binDir, rule));
-    }
-    fout << ':';
-    for (auto const& path : dep.paths) {
-      fout << " \\\n  ";
-      WriteFilenameGcc(fout, lg.MaybeConvertToRelativePath(binDir, path));
-    }
-    fout << '\n';
-  }
-}
-
 // tlog format : always windows paths on Windows regardless the generator
 std::string ConvertToTLogOutputPath(const std::string& path)
 {
@@ -66,57 +47,101 @@ std::string ConvertToTLogOutputPath(const std::string& path)
   return cmSystemTools::ConvertToOutputPath(path);
 #endif
 }
+}
 
-void WriteVsTlog(cmsys::ofstream& fout, const cmLocalGenerator& lg,
-                 const cmGccDepfileContent& content)
+cmDepfileTransformer::cmDepfileTransformer(cmDepfileFormat format,
+                                           std::string homeDir,
+                                           std::string homeOutDir,
+                                           std::string startOutDir)
+  : Format(format)
+  , HomeDirectory(std::move(homeDir))
+  , HomeOutputDirectory(std::move(homeOutDir))
+  , StartOutputDirectory(std::move(startOutDir))
+  , BinaryInSource(
+      PathEqOrSubDir(this->HomeOutputDirectory, this->HomeDirectory))
 {
-  const auto& binDir = lg.GetBinaryDirectory();
+}
 
-  for (auto const& dep : content) {
-    fout << '^';
-    bool first = true;
-    for (auto const& rule : dep.rules) {
-      if (!first) {
-        fout << '|';
-      }
-      first = false;
-      fout << ConvertToTLogOutputPath(
-        lg.MaybeConvertToRelativePath(binDir, rule));
-    }
-    fout << "\r\n";
-    for (auto const& path : dep.paths) {
-      fout << ConvertToTLogOutputPath(
-                lg.MaybeConvertToRelativePath(binDir, path))
-           << "\r\n";
-    }
+std::string const& cmDepfileTransformer::ConvertToRelativePath(
+  std::string const& path)
+{
+  auto it = this->RelativePaths.find(path);
+  if (it != this->RelativePaths.end()) {
+    return it->second;
   }
-}
+
+  // Follow cmStateDirectory::ConvertToRelPathIfNotContained for a
+  // directory whose relative path tops are the top source and build
+  // directories, converting relative to the top build directory.
+  std::string const& binDir = this->HomeOutputDirectory;
+  std::string result;
+  if (PathEqOrSubDir(path, binDir) ||
+      (this->BinaryInSource && PathEqOrSubDir(path, this->HomeDirectory))) {
+    result = cmSystemTools::ForceToRelativePath(binDir, path);
+  } else {
+    result = path;
+  }
+  return this->RelativePaths.emplace(path, std::move(result)).first->second;
 }
 
-bool cmTransformDepfile(cmDepfileFormat format, const cmLocalGenerator& lg,
-                        const std::string& infile, const std::string& outfile)
+bool cmDepfileTransformer::Transform(std::string const& infile,
+                                     std::string const& outfile)
 {
   cmGccDepfileContent content;
   if (cmSystemTools::FileExists(infile)) {
     auto result =
-      cmReadGccDepfile(infile.c_str(), lg.GetCurrentBinaryDirectory());
+      this->Reader.Read(infile.c_str(), this->StartOutputDirectory);
     if (!result) {
       return false;
     }
     content = *std::move(result);
   }
 
-  cmsys::ofstream fout(outfile.c_str());
-  if (!fout) {
-    return false;
-  }
-  switch (format) {
+  // Assemble the whole file and write it at once.
+  std::string out;
+  switch (this->Format) {
     case cmDepfileFormat::GccDepfile:
-      WriteGccDepfile(fout, lg, content);
+      for (auto const& dep : content) {
+        bool first = true;
+        for (auto const& rule : dep.rules) {
+          if (!first) {
+            out += " \\\n  ";
+          }
+          first = false;
+          WriteFilenameGcc(out, this->ConvertToRelativePath(rule));
+        }
+        out += ':';
+        for (auto const& path : dep.paths) {
+          out += " \\\n  ";
+          WriteFilenameGcc(out, this->ConvertToRelativePath(path));
+        }
+        out += '\n';
+      }
       break;
     case cmDepfileFormat::VsTlog:
-      WriteVsTlog(fout, lg, content);
+      for (auto const& dep : content) {
+        out += '^';
+        bool first = true;
+        for (auto const& rule : dep.rules) {
+          if (!first) {
+            out += '|';
+          }
+          first = false;
+          out += ConvertToTLogOutputPath(this->ConvertToRelativePath(rule));
+        }
+        out += "\r\n";
+        for (auto const& path : dep.paths) {
+          out += ConvertToTLogOutputPath(this->ConvertToRelativePath(path));
+          out += "\r\n";
+        }
+      }
       break;
   }
-  return true;
+
+  cmsys::ofstream fout(outfile.c_str());
+  if (!fout) {
+    return false;
+  }
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return static_cast<bool>(fout);
 }
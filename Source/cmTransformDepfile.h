@@ -3,6 +3,9 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+
+#include "cmGccDepfileReader.h"
 
 enum class cmDepfileFormat
 {
@@ -10,7 +13,30 @@ enum class cmDepfileFormat
   VsTlog,
 };
 
-class cmLocalGenerator;
+/** \class cmDepfileTransformer
+ * \brief Rewrites depfiles of custom commands for the native build tool.
+ *
+ * Paths are converted relative to the top of the build tree the same way
+ * a local generator of the given directories would convert them, but
+ * without creating a cmake instance.  One transformer may process many
+ * depfiles and reuses the paths it has already converted.
+ */
+class cmDepfileTransformer
+{
+public:
+  cmDepfileTransformer(cmDepfileFormat format, std::string homeDir,
+                       std::string homeOutDir, std::string startOutDir);
+
+  bool Transform(std::string const& infile, std::string const& outfile);
 
-bool cmTransformDepfile(cmDepfileFormat format, const cmLocalGenerator& lg,
-                        const std::string& infile, const std::string& outfile);
+private:
+  std::string const& ConvertToRelativePath(std::string const& path);
+
+  cmDepfileFormat Format;
+  std::string HomeDirectory;
+  std::string HomeOutputDirectory;
+  std::string StartOutputDirectory;
+  bool BinaryInSource;
+  cmGccDepfileReader Reader;
+  std::unordered_map<std::string, std::string> RelativePaths;
+};
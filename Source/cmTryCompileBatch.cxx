@@ -0,0 +1,217 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmTryCompileBatch.h"
+
+#include <utility>
+
+#include <cm/memory>
+#include <cm/optional>
+
+#include "cmDuration.h"
+#include "cmExecutionStatus.h"
+#include "cmMakefile.h"
+#include "cmMakefileProfilingData.h"
+#include "cmState.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmWorkerPool.h"
+#include "cmake.h"
+
+namespace {
+/** Runs the build commands of one test project.  */
+class BuildJob : public cmWorkerPool::JobT
+{
+public:
+  BuildJob(std::string const& bindir,
+           std::vector<cmGlobalGenerator::GeneratedMakeCommand> const& cmds,
+           std::string& output, int& result, cmDuration timeout)
+    : BinaryDirectory(bindir)
+    , Commands(cmds)
+    , Output(output)
+    , Result(result)
+    , Timeout(timeout)
+  {
+  }
+
+private:
+  void Process() override;
+
+  std::string const& BinaryDirectory;
+  std::vector<cmGlobalGenerator::GeneratedMakeCommand> const& Commands;
+  std::string& Output;
+  int& Result;
+  cmDuration Timeout;
+};
+
+void BuildJob::Process()
+{
+  // Match the output of cmGlobalGenerator::Build.
+  this->Output += cmStrCat("Change Dir: ", this->BinaryDirectory,
+                           "\n\nRun Build Command(s):");
+  this->Result = 0;
+  cmWorkerPool::ProcessResultT result;
+  for (auto const& command : this->Commands) {
+    std::string const printable = command.Printable();
+    this->Output += cmStrCat(printable, " && ");
+    result.reset();
+    if (!this->RunProcess(result, command.PrimaryCommand,
+                          this->BinaryDirectory, this->Timeout) ||
+        !result.ErrorMessage.empty()) {
+      this->Output +=
+        cmStrCat(result.StdOut, result.StdErr,
+                 "\nGenerator: execution of make failed. Make command was: ",
+                 printable, '\n', result.ErrorMessage);
+      this->Result = 1;
+      return;
+    }
+    this->Output += cmStrCat(result.StdOut, result.StdErr);
+    if (result.error()) {
+      this->Result = 1;
+      break;
+    }
+  }
+  this->Output += '\n';
+}
+
+/** Ends processing once all builds are done.  */
+class EndJob : public cmWorkerPool::JobFenceT
+{
+  void Process() override { this->Pool()->Abort(); }
+};
+}
+
+cmTryCompileBatch::cmTryCompileBatch(cmMakefile* mf)
+  : Makefile(mf)
+{
+}
+
+cmTryCompileBatch::~cmTryCompileBatch() = default;
+
+std::string cmTryCompileBatch::NextBinaryDirectory(
+  std::string const& binaryDirectory)
+{
+  return cmStrCat(binaryDirectory, "/CMakeFiles/CMakeTmpBatch",
+                  ++this->Count);
+}
+
+void cmTryCompileBatch::Add(std::string const& srcdir,
+                            std::string const& bindir,
+                            std::string const& projectName,
+                            std::string const& targetName,
+                            std::vector<std::string> const& cmakeFlags,
+                            FinishCallback finish)
+{
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(
+      this->Makefile->GetCMakeInstance()->GetProfilingOutput(), "try_compile",
+      "try_compile project");
+  }
+
+  Probe probe;
+  probe.BinaryDirectory = bindir;
+  probe.Finish = std::move(finish);
+
+  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+  cmSystemTools::ResetErrorOccuredFlag();
+  int const res =
+    this->Makefile->PrepareTryCompile(srcdir, bindir, true, &cmakeFlags);
+  probe.Clean = !cmSystemTools::GetErrorOccuredFlag() &&
+    !cmSystemTools::GetFatalErrorOccured();
+  if (erroroc) {
+    cmSystemTools::SetErrorOccured();
+  }
+
+  if (res == 0) {
+    cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+    std::string config =
+      this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+    if (config.empty()) {
+      config = gg->GetDefaultBuildConfig();
+    }
+    probe.Commands = gg->GenerateBuildCommand(
+      std::string(), projectName, bindir, { targetName }, config, true,
+      cmake::NO_BUILD_PARALLEL_LEVEL, false);
+  }
+  this->Probes.push_back(std::move(probe));
+}
+
+void cmTryCompileBatch::AddResult(std::string const& bindir, int result,
+                                  std::string output, FinishCallback finish)
+{
+  Probe probe;
+  probe.BinaryDirectory = bindir;
+  probe.Finish = std::move(finish);
+  probe.Output = std::move(output);
+  probe.Result = result;
+  this->Probes.push_back(std::move(probe));
+}
+
+void cmTryCompileBatch::AddCall(cmListFileFunction call,
+                                cm::optional<std::string> check)
+{
+  Probe probe;
+  probe.Call = std::move(call);
+  probe.CheckMessage = std::move(check);
+  this->Probes.push_back(std::move(probe));
+}
+
+void cmTryCompileBatch::Run(unsigned int jobs)
+{
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
+    profilingRAII.emplace(
+      this->Makefile->GetCMakeInstance()->GetProfilingOutput(), "try_compile",
+      "try_compile batch");
+  }
+
+  cmDuration const timeout =
+    this->Makefile->GetGlobalGenerator()->TryCompileTimeout;
+  cmWorkerPool pool;
+  pool.SetThreadCount(jobs);
+  bool anyJob = false;
+  for (Probe& probe : this->Probes) {
+    if (!probe.Commands.empty()) {
+      pool.EmplaceJob<BuildJob>(probe.BinaryDirectory, probe.Commands,
+                                probe.Output, probe.Result, timeout);
+      anyJob = true;
+    }
+  }
+  if (anyJob) {
+    pool.EmplaceJob<EndJob>();
+    pool.Process();
+  }
+
+  bool const useWatcom = this->Makefile->GetState()->UseWatcomWMake();
+  for (Probe const& probe : this->Probes) {
+    if (probe.Call) {
+      if (probe.CheckMessage) {
+        this->Makefile->GetCMakeInstance()->PushCheckInProgressMessage(
+          *probe.CheckMessage);
+      }
+      cmExecutionStatus status(*this->Makefile);
+      this->Makefile->ExecuteCommand(*probe.Call, status);
+      if (cmSystemTools::GetFatalErrorOccured()) {
+        break;
+      }
+      continue;
+    }
+    int result = probe.Result;
+    // The OpenWatcom tools do not return an error code when a link
+    // library is not found!
+    if (useWatcom && result == 0 &&
+        probe.Output.find("W1008: cannot open") != std::string::npos) {
+      result = 1;
+    }
+    probe.Finish(result, probe.Output, probe.Clean);
+  }
+
+  if (!this->Makefile->GetCMakeInstance()->GetDebugTryCompile()) {
+    for (Probe const& probe : this->Probes) {
+      if (!probe.BinaryDirectory.empty()) {
+        cmSystemTools::RemoveADirectory(probe.BinaryDirectory);
+      }
+    }
+  }
+  this->Probes.clear();
+}
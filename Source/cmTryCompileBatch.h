@@ -0,0 +1,97 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <cm/optional>
+
+#include "cmGlobalGenerator.h"
+#include "cmListFileCache.h"
+
+class cmMakefile;
+
+/** \class cmTryCompileBatch
+ * \brief Builds the test projects of several try_compile calls at once.
+ *
+ * The test projects are configured and generated when they are added,
+ * one after the other, because that happens in this process.  Their
+ * builds only run external tools and are independent of each other, so
+ * Run() executes them concurrently and then reports all results,
+ * including those known without a build, in the order they were added.
+ */
+class cmTryCompileBatch
+{
+public:
+  /**
+   * Called with the result and output of the build of a test project.
+   * The last argument tells whether generating the project reported no
+   * errors.
+   */
+  using FinishCallback =
+    std::function<void(int result, std::string const& output, bool clean)>;
+
+  cmTryCompileBatch(cmMakefile* mf);
+  ~cmTryCompileBatch();
+
+  cmTryCompileBatch(cmTryCompileBatch const&) = delete;
+  cmTryCompileBatch& operator=(cmTryCompileBatch const&) = delete;
+
+  /**
+   * Return a binary directory for the next test project below the given
+   * build tree.  It is separate from the CMakeTmp directory that other
+   * try_compile calls clean up after themselves.
+   */
+  std::string NextBinaryDirectory(std::string const& binaryDirectory);
+
+  /**
+   * Configure and generate a test project and queue its build.
+   */
+  void Add(std::string const& srcdir, std::string const& bindir,
+           std::string const& projectName, std::string const& targetName,
+           std::vector<std::string> const& cmakeFlags, FinishCallback finish);
+
+  /**
+   * Queue the result of a test project that needs no build, such as one
+   * reused from a previous build, so that it is reported in order.
+   */
+  void AddResult(std::string const& bindir, int result, std::string output,
+                 FinishCallback finish);
+
+  /**
+   * Queue a command call that handles the results added before it.  The
+   * given message of a check started by message(CHECK_START) is restored
+   * before the call, so that the call can complete the check.
+   */
+  void AddCall(cmListFileFunction call, cm::optional<std::string> check);
+
+  /**
+   * Build all queued test projects with up to the given number of builds
+   * at a time, then call their callbacks and the queued commands in the
+   * order they were added.
+   * Builds that take longer than the try_compile timeout of the global
+   * generator are stopped and fail.
+   */
+  void Run(unsigned int jobs);
+
+private:
+  struct Probe
+  {
+    std::string BinaryDirectory;
+    std::vector<cmGlobalGenerator::GeneratedMakeCommand> Commands;
+    FinishCallback Finish;
+    cm::optional<cmListFileFunction> Call;
+    cm::optional<std::string> CheckMessage;
+    std::string Output;
+    int Result = 1;
+    bool Clean = false;
+  };
+
+  cmMakefile* Makefile;
+  std::vector<Probe> Probes;
+  unsigned int Count = 0;
+};
@@ -0,0 +1,141 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmTryCompileBatchCommand.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include <cm/memory>
+#include <cm/optional>
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include "cmsys/SystemInformation.hxx"
+
+#include "cmExecutionStatus.h"
+#include "cmListFileCache.h"
+#include "cmMakefile.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmTryCompileBatch.h"
+#include "cmake.h"
+
+namespace {
+std::array<cm::static_string_view, 15> const InvalidCommands{
+  { // clang-format off
+  "function"_s, "endfunction"_s,
+  "macro"_s, "endmacro"_s,
+  "if"_s, "elseif"_s, "else"_s, "endif"_s,
+  "while"_s, "endwhile"_s,
+  "foreach"_s, "endforeach"_s,
+  "break"_s, "continue"_s, "return"_s
+  } // clang-format on
+};
+
+bool HandleDefer(std::vector<std::string> const& args,
+                 cmExecutionStatus& status)
+{
+  std::size_t i = 1;
+  bool const moveCheck = i < args.size() && args[i] == "MOVE_CHECK";
+  if (moveCheck) {
+    ++i;
+  }
+  if (i + 1 >= args.size() || args[i] != "CALL") {
+    status.SetError("DEFER requires CALL followed by a command name.");
+    return false;
+  }
+  std::string const& command = args[++i];
+  if (std::find(InvalidCommands.cbegin(), InvalidCommands.cend(),
+                cmSystemTools::LowerCase(command)) != InvalidCommands.cend()) {
+    status.SetError(
+      cmStrCat("DEFER given invalid command \"", command, "\"."));
+    return false;
+  }
+
+  // The arguments are already expanded, so keep them as they are.
+  cmMakefile& mf = status.GetMakefile();
+  long const line = mf.GetBacktrace().Top().Line;
+  std::vector<cmListFileArgument> callArgs;
+  for (++i; i < args.size(); ++i) {
+    callArgs.emplace_back(args[i], cmListFileArgument::Bracket, line);
+  }
+  cmListFileFunction call{ command, line, std::move(callArgs) };
+
+  cmTryCompileBatch* batch = mf.GetTryCompileBatch();
+  if (!batch) {
+    return mf.ExecuteCommand(call, status);
+  }
+  cm::optional<std::string> check;
+  if (moveCheck && mf.GetCMakeInstance()->HasCheckInProgress()) {
+    check = mf.GetCMakeInstance()->GetTopCheckInProgressMessage();
+  }
+  batch->AddCall(std::move(call), std::move(check));
+  return true;
+}
+}
+
+bool cmTryCompileBatchCommand(std::vector<std::string> const& args,
+                              cmExecutionStatus& status)
+{
+  if (args.empty()) {
+    status.SetError("must be called with BEGIN, END, or DEFER.");
+    return false;
+  }
+
+  cmMakefile& mf = status.GetMakefile();
+  if (mf.GetCMakeInstance()->GetWorkingMode() == cmake::FIND_PACKAGE_MODE) {
+    status.SetError("is not supported in --find-package mode.");
+    return false;
+  }
+
+  if (args[0] == "BEGIN") {
+    if (args.size() > 1) {
+      status.SetError(cmStrCat("BEGIN given unknown argument \"", args[1],
+                               "\"."));
+      return false;
+    }
+    if (mf.GetTryCompileBatch()) {
+      status.SetError("BEGIN called while a batch is already started.");
+      return false;
+    }
+    mf.SetTryCompileBatch(cm::make_unique<cmTryCompileBatch>(&mf));
+    return true;
+  }
+
+  if (args[0] == "END") {
+    unsigned long jobs = 0;
+    for (std::size_t i = 1; i < args.size(); ++i) {
+      if (args[i] == "PARALLEL_LEVEL" && i + 1 < args.size()) {
+        if (!cmStrToULong(args[++i], &jobs) || jobs == 0) {
+          status.SetError(cmStrCat("PARALLEL_LEVEL given invalid value \"",
+                                   args[i], "\"."));
+          return false;
+        }
+      } else {
+        status.SetError(cmStrCat("END given unknown argument \"", args[i],
+                                 "\"."));
+        return false;
+      }
+    }
+    std::unique_ptr<cmTryCompileBatch> batch = mf.TakeTryCompileBatch();
+    if (!batch) {
+      status.SetError("END called without a matching BEGIN.");
+      return false;
+    }
+    if (jobs == 0) {
+      cmsys::SystemInformation info;
+      info.RunCPUCheck();
+      jobs = info.GetNumberOfLogicalCPU();
+    }
+    batch->Run(static_cast<unsigned int>(jobs));
+    return true;
+  }
+
+  if (args[0] == "DEFER") {
+    return HandleDefer(args, status);
+  }
+
+  status.SetError(cmStrCat("given unknown mode \"", args[0], "\"."));
+  return false;
+}
@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <condition_variable>
+#include <csignal>
 #include <cstddef>
 #include <deque>
 #include <functional>
@@ -150,6 +152,7 @@ public:
     std::vector<std::string> Command;
     cmWorkerPool::ProcessResultT* Result = nullptr;
     bool MergedOutput = false;
+    cmDuration Timeout = cmDuration::zero();
   };
 
   // -- Const accessors
@@ -161,12 +164,14 @@ public:
   // -- Runtime
   void setup(cmWorkerPool::ProcessResultT* result, bool mergedOutput,
              std::vector<std::string> const& command,
-             std::string const& workingDirectory = std::string());
+             std::string const& workingDirectory = std::string(),
+             cmDuration timeout = cmDuration::zero());
   bool start(uv_loop_t* uv_loop, std::function<void()> finishedCallback);
 
 private:
   // -- Libuv callbacks
   static void UVExit(uv_process_t* handle, int64_t exitStatus, int termSignal);
+  static void UVTimeout(uv_timer_t* handle);
   void UVPipeOutData(cmUVPipeBuffer::DataRange data) const;
   void UVPipeOutEnd(ssize_t error);
   void UVPipeErrData(cmUVPipeBuffer::DataRange data) const;
@@ -183,6 +188,7 @@ private:
   std::array<uv_stdio_container_t, 3> UVOptionsStdIO_;
   uv_process_options_t UVOptions_;
   cm::uv_process_ptr UVProcess_;
+  cm::uv_timer_ptr UVTimer_;
   cmUVPipeBuffer UVPipeOut_;
   cmUVPipeBuffer UVPipeErr_;
 };
@@ -190,12 +196,14 @@ private:
 void cmUVReadOnlyProcess::setup(cmWorkerPool::ProcessResultT* result,
                                 bool mergedOutput,
                                 std::vector<std::string> const& command,
-                                std::string const& workingDirectory)
+                                std::string const& workingDirectory,
+                                cmDuration timeout)
 {
   this->Setup_.WorkingDirectory = workingDirectory;
   this->Setup_.Command = command;
   this->Setup_.Result = result;
   this->Setup_.MergedOutput = mergedOutput;
+  this->Setup_.Timeout = timeout;
 }
 
 bool cmUVReadOnlyProcess::start(uv_loop_t* uv_loop,
@@ -251,6 +259,13 @@ bool cmUVReadOnlyProcess::start(uv_loop_t* uv_loop,
     this->UVOptions_.args = const_cast<char**>(this->CommandPtr_.data());
     this->UVOptions_.cwd = this->Setup_.WorkingDirectory.c_str();
     this->UVOptions_.flags = UV_PROCESS_WINDOWS_HIDE;
+#ifndef _WIN32
+    // Start a process with a timeout in a new process group, so that the
+    // timeout kills the tools it runs as well.
+    if (this->Setup().Timeout > cmDuration::zero()) {
+      this->UVOptions_.flags |= UV_PROCESS_DETACHED;
+    }
+#endif
     this->UVOptions_.stdio_count =
       static_cast<int>(this->UVOptionsStdIO_.size());
     this->UVOptions_.stdio = this->UVOptionsStdIO_.data();
@@ -287,11 +302,26 @@ bool cmUVReadOnlyProcess::start(uv_loop_t* uv_loop,
     }
   }
 
+  // -- Start the timeout timer
+  if (!this->Result()->error() && this->Setup().Timeout > cmDuration::zero()) {
+    auto const ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        this->Setup().Timeout)
+        .count();
+    if (this->UVTimer_.init(*uv_loop, this) != 0 ||
+        this->UVTimer_.start(&cmUVReadOnlyProcess::UVTimeout,
+                             static_cast<uint64_t>(ms > 0 ? ms : 1),
+                             0) != 0) {
+      this->Result()->ErrorMessage = "libuv timer initialization failed";
+    }
+  }
+
   if (!this->Result()->error()) {
     this->IsStarted_ = true;
     this->FinishedCallback_ = std::move(finishedCallback);
   } else {
     // Clear libuv handles and finish
+    this->UVTimer_.reset();
     this->UVProcess_.reset();
     this->UVPipeOut_.reset();
     this->UVPipeErr_.reset();
@@ -319,13 +349,34 @@ void cmUVReadOnlyProcess::UVExit(uv_process_t* handle, int64_t exitStatus,
       }
     }
 
-    // Reset process handle
+    // Reset process and timer handles
     proc.UVProcess_.reset();
+    proc.UVTimer_.reset();
     // Try finish
     proc.UVTryFinish();
   }
 }
 
+void cmUVReadOnlyProcess::UVTimeout(uv_timer_t* handle)
+{
+  auto& proc = *reinterpret_cast<cmUVReadOnlyProcess*>(handle->data);
+  if (proc.IsStarted() && !proc.IsFinished() &&
+      (proc.UVProcess_.get() != nullptr)) {
+    if (!proc.Result()->error()) {
+      proc.Result()->ErrorMessage = "Process terminated due to timeout";
+    }
+    // Children that escaped the process group may keep the pipes open, so
+    // stop reading and finish as soon as the process itself has exited.
+    proc.UVPipeOut_.reset();
+    proc.UVPipeErr_.reset();
+#ifdef _WIN32
+    uv_process_kill(proc.UVProcess_, SIGKILL);
+#else
+    uv_kill(-proc.UVProcess_->pid, SIGKILL);
+#endif
+  }
+}
+
 void cmUVReadOnlyProcess::UVPipeOutData(cmUVPipeBuffer::DataRange data) const
 {
   this->Result()->StdOut.append(data.begin(), data.end());
@@ -396,7 +447,7 @@ public:
    */
   bool RunProcess(cmWorkerPool::ProcessResultT& result,
                   std::vector<std::string> const& command,
-                  std::string const& workingDirectory);
+                  std::string const& workingDirectory, cmDuration timeout);
 
 private:
   // -- Libuv callbacks
@@ -429,7 +480,8 @@ cmWorkerPoolWorker::~cmWorkerPoolWorker()
 
 bool cmWorkerPoolWorker::RunProcess(cmWorkerPool::ProcessResultT& result,
                                     std::vector<std::string> const& command,
-                                    std::string const& workingDirectory)
+                                    std::string const& workingDirectory,
+                                    cmDuration timeout)
 {
   if (command.empty()) {
     return false;
@@ -438,7 +490,8 @@ bool cmWorkerPoolWorker::RunProcess(cmWorkerPool::ProcessResultT& result,
   {
     std::lock_guard<std::mutex> lock(this->Proc_.Mutex);
     this->Proc_.ROP = cm::make_unique<cmUVReadOnlyProcess>();
-    this->Proc_.ROP->setup(&result, true, command, workingDirectory);
+    this->Proc_.ROP->setup(&result, true, command, workingDirectory,
+                           timeout);
   }
   // Send asynchronous process start request to libuv loop
   this->Proc_.Request.send();
@@ -737,11 +790,12 @@ cmWorkerPool::JobT::~JobT() = default;
 
 bool cmWorkerPool::JobT::RunProcess(ProcessResultT& result,
                                     std::vector<std::string> const& command,
-                                    std::string const& workingDirectory)
+                                    std::string const& workingDirectory,
+                                    cmDuration timeout)
 {
   // Get worker by index
   auto* wrk = this->Pool_->Int_->Workers.at(this->WorkerIndex_).get();
-  return wrk->RunProcess(result, command, workingDirectory);
+  return wrk->RunProcess(result, command, workingDirectory, timeout);
 }
 
 cmWorkerPool::cmWorkerPool()
@@ -11,6 +11,8 @@
 
 #include <cm/memory>
 
+#include "cmDuration.h"
+
 // -- Types
 class cmWorkerPoolInternal;
 
@@ -100,11 +102,15 @@ public:
 
     /**
      * Run an external read only process.
+     * A positive timeout kills the process if it runs longer.  On POSIX
+     * systems the process then runs in its own process group, and the
+     * whole group is killed.
      * Use only during JobT::Process() call!
      */
     bool RunProcess(ProcessResultT& result,
                     std::vector<std::string> const& command,
-                    std::string const& workingDirectory);
+                    std::string const& workingDirectory,
+                    cmDuration timeout = cmDuration::zero());
 
   private:
     //! Needs access to Work()
@@ -42,6 +42,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmGlobalGeneratorFactory.h"
 #include "cmLinkLineComputer.h"
+#include "cmListFileDiskCache.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #if !defined(CMAKE_BOOTSTRAP)
@@ -1024,6 +1025,20 @@ void cmake::SetArgs(const std::vector<std::string>& args)
       cmSystemTools::ConvertToUnixSlashes(profilingOutput);
       return true;
     });
+  arguments.emplace_back(
+    "--parallel-file-replace",
+    "No number of jobs specified for --parallel-file-replace",
+    CommandArgument::Values::One,
+    [](std::string const& value, cmake* state) -> bool {
+      unsigned long jobs = 0;
+      if (!cmStrToULong(value, &jobs) || jobs == 0) {
+        cmSystemTools::Error(
+          "Invalid number of jobs specified for --parallel-file-replace");
+        return false;
+      }
+      state->ParallelFileReplaceJobs = static_cast<unsigned int>(jobs);
+      return true;
+    });
   arguments.emplace_back("--preset", "No preset specified for --preset",
                          CommandArgument::Values::One,
                          [&](std::string const& value, cmake*) -> bool {
@@ -1128,19 +1143,24 @@ void cmake::SetArgs(const std::vector<std::string>& args)
         "--profiling-format specified but no --profiling-output!");
       return;
     }
+    cmMakefileProfilingData::Format format;
     if (profilingFormat == "google-trace"_s) {
-      try {
-        this->ProfilingOutput =
-          cm::make_unique<cmMakefileProfilingData>(profilingOutput);
-      } catch (std::runtime_error& e) {
-        cmSystemTools::Error(
-          cmStrCat("Could not start profiling: ", e.what()));
-        return;
-      }
+      format = cmMakefileProfilingData::Format::GoogleTrace;
+    } else if (profilingFormat == "folded"_s) {
+      format = cmMakefileProfilingData::Format::Folded;
+    } else if (profilingFormat == "summary"_s) {
+      format = cmMakefileProfilingData::Format::Summary;
     } else {
       cmSystemTools::Error("Invalid format specified for --profiling-format");
       return;
     }
+    try {
+      this->ProfilingOutput =
+        cm::make_unique<cmMakefileProfilingData>(profilingOutput, format);
+    } catch (std::runtime_error& e) {
+      cmSystemTools::Error(cmStrCat("Could not start profiling: ", e.what()));
+      return;
+    }
   }
 #endif
 
@@ -1918,6 +1938,14 @@ int cmake::Configure()
   value = this->State->GetCacheEntryValue("CMAKE_SUPPRESS_DEVELOPER_ERRORS");
   this->Messenger->SetDevWarningsAsErrors(value && cmIsOff(*value));
 
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->IsProfilingEnabled()) {
+    profilingRAII.emplace(this->GetProfilingOutput(), "configure",
+                          "configure");
+  }
+#endif
+
   int ret = this->ActualConfigure();
   cmProp delCacheVars =
     this->State->GetGlobalProperty("__CMAKE_DELETE_CACHE_CHANGE_VARS_");
@@ -2060,6 +2088,15 @@ int cmake::ActualConfigure()
   this->FileAPI->ReadQueries();
 #endif
 
+  // Reuse list files parsed by a previous run if the user asked for it.
+  this->UnwatchUnusedCli("CMAKE_LISTFILE_CACHE");
+  if (cmIsOn(this->State->GetInitializedCacheValue("CMAKE_LISTFILE_CACHE"))) {
+    this->ListFileDiskCache = cm::make_unique<cmListFileDiskCache>(
+      cmStrCat(this->GetHomeOutputDirectory(), "/CMakeFiles/ListFileCache"));
+  } else {
+    this->ListFileDiskCache.reset();
+  }
+
   // actually do the configure
   this->GlobalGenerator->Configure();
   // Before saving the cache
@@ -2324,6 +2361,14 @@ int cmake::Generate()
   if (!this->GlobalGenerator) {
     return -1;
   }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  cm::optional<cmMakefileProfilingData::RAII> profilingRAII;
+  if (this->IsProfilingEnabled()) {
+    profilingRAII.emplace(this->GetProfilingOutput(), "generate", "generate");
+  }
+#endif
+
   if (!this->GlobalGenerator->Compute()) {
     return -1;
   }
@@ -39,6 +39,7 @@ class cmFileAPI;
 class cmFileTimeCache;
 class cmGlobalGenerator;
 class cmGlobalGeneratorFactory;
+class cmListFileDiskCache;
 class cmMakefile;
 #if !defined(CMAKE_BOOTSTRAP)
 class cmMakefileProfilingData;
@@ -424,6 +425,15 @@ public:
    */
   cmFileTimeCache* GetFileTimeCache() { return this->FileTimeCache.get(); }
 
+  /**
+   * Get the persistent cache of parsed list files, if enabled by the
+   * CMAKE_LISTFILE_CACHE cache entry.
+   */
+  cmListFileDiskCache* GetListFileDiskCache()
+  {
+    return this->ListFileDiskCache.get();
+  }
+
   bool WasLogLevelSetViaCLI() const { return this->LogLevelWasSetViaCLI; }
 
   //! Get the selected log level for `message()` commands during the cmake run.
@@ -581,6 +591,12 @@ public:
   bool IsProfilingEnabled() const;
 #endif
 
+  //! Get the number of threads requested by --parallel-file-replace.
+  unsigned int GetParallelFileReplaceJobs() const
+  {
+    return this->ParallelFileReplaceJobs;
+  }
+
 protected:
   void RunCheckForUnusedVariables();
   int HandleDeleteCacheVariables(const std::string& var);
@@ -656,7 +672,9 @@ private:
   bool ClearBuildSystem = false;
   bool DebugTryCompile = false;
   bool RegenerateDuringBuild = false;
+  unsigned int ParallelFileReplaceJobs = 0;
   std::unique_ptr<cmFileTimeCache> FileTimeCache;
+  std::unique_ptr<cmListFileDiskCache> ListFileDiskCache;
   std::string GraphVizFile;
   InstalledFilesMap InstalledFiles;
 #ifndef CMAKE_BOOTSTRAP
@@ -34,6 +34,8 @@
 #ifndef CMAKE_BOOTSTRAP
 #  include "cmDocumentation.h"
 #  include "cmDynamicLoader.h"
+
+#  include "cmsys/SystemInformation.hxx"
 #endif
 
 #include "cmsys/Encoding.hxx"
@@ -102,10 +104,12 @@ const char* cmDocumentationOptions[][2] = {
 #  if !defined(CMAKE_BOOTSTRAP)
   { "--profiling-format=<fmt>",
     "Output data for profiling CMake scripts. Supported formats: "
-    "google-trace" },
+    "google-trace, folded, summary" },
   { "--profiling-output=<file>",
     "Select an output path for the profiling data enabled through "
     "--profiling-format." },
+  { "--parallel-file-replace=<jobs>",
+    "Replace changed build files using the given number of threads." },
 #  endif
   { nullptr, nullptr }
 };
@@ -754,6 +758,7 @@ int do_install(int ac, char const* const* av)
   std::string defaultDirectoryPermissions;
   std::string prefix;
   std::string dir;
+  int jobs = cmake::NO_BUILD_PARALLEL_LEVEL;
   bool strip = false;
   bool verbose = cmSystemTools::HasEnv("VERBOSE");
 
@@ -761,6 +766,20 @@ int do_install(int ac, char const* const* av)
     verbose = true;
     return true;
   };
+  auto jLambda = [&](std::string const& value) -> bool {
+    jobs = extract_job_number("-j", value);
+    if (jobs < 0) {
+      dir.clear();
+    }
+    return true;
+  };
+  auto parallelLambda = [&](std::string const& value) -> bool {
+    jobs = extract_job_number("--parallel", value);
+    if (jobs < 0) {
+      dir.clear();
+    }
+    return true;
+  };
 
   using CommandArgument =
     cmCommandLineArgument<bool(std::string const& value)>;
@@ -792,6 +811,9 @@ int do_install(int ac, char const* const* av)
                        strip = true;
                        return true;
                      } },
+    CommandArgument{ "-j", CommandArgument::Values::ZeroOrOne, jLambda },
+    CommandArgument{ "--parallel", CommandArgument::Values::ZeroOrOne,
+                     parallelLambda },
     CommandArgument{ "-v", CommandArgument::Values::Zero, verboseLambda },
     CommandArgument{ "--verbose", CommandArgument::Values::Zero,
                      verboseLambda }
@@ -826,6 +848,9 @@ int do_install(int ac, char const* const* av)
       "     Default install permission. Use default permission <permission>.\n"
       "  --prefix <prefix>  = The installation prefix CMAKE_INSTALL_PREFIX.\n"
       "  --strip            = Performing install/strip.\n"
+      "  --parallel [<jobs>], -j [<jobs>]\n"
+      "                     = Copy files using the given number of threads.\n"
+      "                       Without <jobs>, the number of CPUs is used.\n"
       "  -v --verbose       = Enable verbose output.\n"
       ;
     /* clang-format on */
@@ -876,6 +901,15 @@ int do_install(int ac, char const* const* av)
                       parsedPermissionsVar);
   }
 
+  if (jobs == cmake::DEFAULT_BUILD_PARALLEL_LEVEL) {
+    cmsys::SystemInformation info;
+    info.RunCPUCheck();
+    jobs = static_cast<int>(info.GetNumberOfLogicalCPU());
+  }
+  if (jobs > 0) {
+    args.emplace_back(cmStrCat("-DCMAKE_INSTALL_PARALLEL_LEVEL=", jobs));
+  }
+
   args.emplace_back("-P");
   args.emplace_back(dir + "/cmake_install.cmake");
 
@@ -941,6 +975,10 @@ int main(int ac, char const* const* av)
   av = args.argv();
 
   cmSystemTools::InitializeLibUV();
+  if (ac > 2 && strcmp(av[1], "-E") == 0 &&
+      cmcmd::IsStandaloneCommand(av[2])) {
+    return do_command(ac, av, std::move(consoleBuf));
+  }
   cmSystemTools::FindCMakeResources(av[0]);
   if (ac > 1) {
     if (strcmp(av[1], "--build") == 0) {
@@ -34,8 +34,6 @@
 #endif
 
 #if !defined(CMAKE_BOOTSTRAP) || defined(CMAKE_BOOTSTRAP_MAKEFILES)
-#  include <algorithm>
-
 #  include "cmCMakePath.h"
 #  include "cmProcessTools.h"
 #endif
@@ -44,6 +42,7 @@
 #  include "cmVisualStudioWCEPlatformParser.h"
 #endif
 
+#include <algorithm>
 #include <array>
 #include <cstdio>
 #include <cstdlib>
@@ -60,6 +59,7 @@
 #  include <stdio.h> // for std{out,err} and fileno
 #endif
 
+#include <cm/iterator>
 #include <cm/string_view>
 
 #include "cmsys/Directory.hxx"
@@ -622,6 +622,77 @@ int cmcmd::HandleCoCompileCommands(std::vector<std::string> const& args)
   return ret;
 }
 
+namespace {
+// The commands that need neither a cmake instance nor the resources found
+// by cmSystemTools::FindCMakeResources, sorted for binary search.
+cm::string_view const StandaloneCommands[] = {
+  "cat"_s,
+  "chdir"_s,
+  "cmake_echo_color"_s,
+  "cmake_progress_report"_s,
+  "cmake_progress_start"_s,
+  "cmake_symlink_executable"_s,
+  "cmake_symlink_library"_s,
+  "cmake_transform_depfile"_s,
+  "compare_files"_s,
+  "copy"_s,
+  "copy_directory"_s,
+  "copy_if_different"_s,
+  "create_hardlink"_s,
+  "create_symlink"_s,
+  "echo"_s,
+  "echo_append"_s,
+  "env"_s,
+  "false"_s,
+  "make_directory"_s,
+  "md5sum"_s,
+  "remove"_s,
+  "remove_directory"_s,
+  "rename"_s,
+  "rm"_s,
+  "sha1sum"_s,
+  "sha224sum"_s,
+  "sha256sum"_s,
+  "sha384sum"_s,
+  "sha512sum"_s,
+  "sleep"_s,
+  "tar"_s,
+  "time"_s,
+  "touch"_s,
+  "touch_nocreate"_s,
+  "true"_s,
+};
+}
+
+bool cmcmd::IsStandaloneCommand(cm::string_view command)
+{
+  return std::binary_search(cm::cbegin(StandaloneCommands),
+                            cm::cend(StandaloneCommands), command);
+}
+
+namespace {
+// Copy a file or into a directory like cmsys::SystemTools does, but copy
+// the content of regular files with cmSystemTools::CopySingleFile.
+bool CopyFileTo(std::string const& source, std::string const& destination,
+                cmSystemTools::CopyWhen when)
+{
+  if (cmSystemTools::FileIsDirectory(source)) {
+    return when == cmSystemTools::CopyWhen::Always
+      ? cmsys::SystemTools::CopyFileAlways(source, destination)
+      : cmsys::SystemTools::CopyFileIfDifferent(source, destination);
+  }
+  std::string target = destination;
+  if (cmSystemTools::FileIsDirectory(destination)) {
+    target =
+      cmStrCat(destination, '/', cmSystemTools::GetFilenameName(source));
+  } else {
+    cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(destination));
+  }
+  return cmSystemTools::CopySingleFile(source, target, when) ==
+    cmSystemTools::CopyResult::Success;
+}
+}
+
 int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args,
                                std::unique_ptr<cmConsoleBuf> consoleBuf)
 {
@@ -640,7 +711,7 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args,
       // If error occurs we want to continue copying next files.
       bool return_value = false;
       for (auto const& arg : cmMakeRange(args).advance(2).retreat(1)) {
-        if (!cmsys::SystemTools::CopyFileAlways(arg, args.back())) {
+        if (!CopyFileTo(arg, args.back(), cmSystemTools::CopyWhen::Always)) {
           std::cerr << "Error copying file \"" << arg << "\" to \""
                     << args.back() << "\".\n";
           return_value = true;
@@ -662,7 +733,8 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args,
       // If error occurs we want to continue copying next files.
       bool return_value = false;
       for (auto const& arg : cmMakeRange(args).advance(2).retreat(1)) {
-        if (!cmSystemTools::CopyFileIfDifferent(arg, args.back())) {
+        if (!CopyFileTo(arg, args.back(),
+                        cmSystemTools::CopyWhen::OnlyIfDifferent)) {
           std::cerr << "Error copying file (if different) from \"" << arg
                     << "\" to \"" << args.back() << "\".\n";
           return_value = true;
@@ -1520,8 +1592,10 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args,
     }
 #endif
 
-    // Internal depfile transformation
-    if (args[1] == "cmake_transform_depfile" && args.size() == 10) {
+    // Internal depfile transformation.  Further pairs of depfile and
+    // output may follow the first one to transform several at once.
+    if (args[1] == "cmake_transform_depfile" && args.size() >= 10 &&
+        args.size() % 2 == 0) {
       auto format = cmDepfileFormat::GccDepfile;
       if (args[3] == "gccdepfile") {
         format = cmDepfileFormat::GccDepfile;
@@ -1530,33 +1604,18 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args,
       } else {
         return 1;
       }
-      // Create a cmake object instance to process dependencies.
-      // All we need is the `set` command.
-      cmake cm(cmake::RoleScript, cmState::Unknown);
-      std::string homeDir;
-      std::string startDir;
-      std::string homeOutDir;
-      std::string startOutDir;
-      homeDir = cmSystemTools::CollapseFullPath(args[4]);
-      startDir = cmSystemTools::CollapseFullPath(args[5]);
-      homeOutDir = cmSystemTools::CollapseFullPath(args[6]);
-      startOutDir = cmSystemTools::CollapseFullPath(args[7]);
-      cm.SetHomeDirectory(homeDir);
-      cm.SetHomeOutputDirectory(homeOutDir);
-      cm.GetCurrentSnapshot().SetDefaultDefinitions();
-      if (auto ggd = cm.CreateGlobalGenerator(args[2])) {
-        cm.SetGlobalGenerator(std::move(ggd));
-        cmStateSnapshot snapshot = cm.GetCurrentSnapshot();
-        snapshot.GetDirectory().SetCurrentBinary(startOutDir);
-        snapshot.GetDirectory().SetCurrentSource(startDir);
-        snapshot.GetDirectory().SetRelativePathTopSource(homeDir.c_str());
-        snapshot.GetDirectory().SetRelativePathTopBinary(homeOutDir.c_str());
-        cmMakefile mf(cm.GetGlobalGenerator(), snapshot);
-        auto lgd = cm.GetGlobalGenerator()->CreateLocalGenerator(&mf);
-
-        return cmTransformDepfile(format, *lgd, args[8], args[9]) ? 0 : 2;
+      // The transformation needs only the directories, so do not create
+      // a cmake instance and generators just to convert paths.
+      cmDepfileTransformer transformer(
+        format, cmSystemTools::CollapseFullPath(args[4]),
+        cmSystemTools::CollapseFullPath(args[6]),
+        cmSystemTools::CollapseFullPath(args[7]));
+      for (auto i = args.begin() + 8; i != args.end(); i += 2) {
+        if (!transformer.Transform(*i, *(i + 1))) {
+          return 2;
+        }
       }
-      return 1;
+      return 0;
     }
   }
 
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include <cm/string_view>
+
 #include "cmCryptoHash.h"
 
 class cmConsoleBuf;
@@ -22,6 +24,13 @@ public:
   static int ExecuteCMakeCommand(std::vector<std::string> const&,
                                  std::unique_ptr<cmConsoleBuf> consoleBuf);
 
+  /**
+   * Return whether a command runs without the resources that
+   * cmSystemTools::FindCMakeResources looks up, so that the build tools
+   * invoking it frequently need not wait for that lookup.
+   */
+  static bool IsStandaloneCommand(cm::string_view command);
+
 protected:
   static int HandleCoCompileCommands(std::vector<std::string> const& args);
   static int HashSumFile(std::vector<std::string> const& args,
@@ -0,0 +1,66 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Measure the run time of a benchmark script in script mode, once for
+// each value of a variable that selects what the script exercises.
+//
+// Usage: benchCMakeScript <cmake> <script> <var>=<value>[,<value>...]
+//                         [<var>=<value>...]
+//
+// The first assignment lists the values to run the script with.  The
+// others are passed unchanged to every run.  For example:
+//
+//   benchCMakeScript bin/cmake benchListCommand.cmake
+//     OP=append,get,length,find,foreach N=100000
+//
+// Timing depends on the machine, so this is run by hand rather than as
+// a test.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+int main(int argc, char* argv[])
+{
+  std::string::size_type const eq =
+    argc > 3 ? std::string(argv[3]).find('=') : std::string::npos;
+  if (eq == std::string::npos) {
+    std::cerr << "usage: benchCMakeScript <cmake> <script> "
+                 "<var>=<value>[,<value>...] [<var>=<value>...]\n";
+    return 1;
+  }
+  std::string const varied = argv[3];
+  std::string const var = varied.substr(0, eq);
+
+  std::vector<std::string> command = { argv[1], std::string() };
+  for (int i = 4; i < argc; ++i) {
+    command.push_back(cmStrCat("-D", argv[i]));
+  }
+  command.emplace_back("-P");
+  command.emplace_back(argv[2]);
+
+  for (std::string const& value :
+       cmTokenize(varied.substr(eq + 1), ",")) {
+    command[1] = cmStrCat("-D", var, '=', value);
+    int retVal = 1;
+    std::string output;
+    auto const start = std::chrono::steady_clock::now();
+    if (!cmSystemTools::RunSingleCommand(command, &output, &output, &retVal,
+                                         nullptr,
+                                         cmSystemTools::OUTPUT_NONE) ||
+        retVal != 0) {
+      std::cerr << "Running " << argv[2] << " with " << var << '=' << value
+                << " failed:\n"
+                << output;
+      return 1;
+    }
+    std::chrono::duration<double, std::milli> const time =
+      std::chrono::steady_clock::now() - start;
+    std::cout << var << '=' << value << ": " << time.count() << " ms\n";
+  }
+  return 0;
+}
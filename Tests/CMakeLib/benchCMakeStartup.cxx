@@ -0,0 +1,76 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Measure the median time of running `cmake -E true`, which bounds the
+// cost of every `cmake -E` command that generated build systems run.
+//
+// Usage: benchCMakeStartup <cmake> [runs [max-median-ms]]
+//
+// Fails if the median exceeds the given number of milliseconds.  Timing
+// depends on the machine, so this is run by hand rather than as a test.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmSystemTools.h"
+
+namespace {
+
+// Return the median run time in milliseconds, or a negative value if the
+// command failed.
+double measure(std::vector<std::string> const& command, int runs)
+{
+  std::vector<double> times;
+  times.reserve(static_cast<std::size_t>(runs));
+  for (int i = 0; i < runs; ++i) {
+    int retVal = 1;
+    auto const start = std::chrono::steady_clock::now();
+    if (!cmSystemTools::RunSingleCommand(command, nullptr, nullptr, &retVal,
+                                         nullptr,
+                                         cmSystemTools::OUTPUT_NONE) ||
+        retVal != 0) {
+      return -1;
+    }
+    std::chrono::duration<double, std::milli> const time =
+      std::chrono::steady_clock::now() - start;
+    times.push_back(time.count());
+  }
+  auto median = times.begin() + times.size() / 2;
+  std::nth_element(times.begin(), median, times.end());
+  return *median;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "usage: benchCMakeStartup <cmake> [runs [max-median-ms]]\n";
+    return 1;
+  }
+  std::string const cmake = argv[1];
+  int const runs = argc > 2 ? std::atoi(argv[2]) : 100;
+  double const maxMedian = argc > 3 ? std::atof(argv[3]) : 0;
+  if (runs <= 0 || (argc > 3 && maxMedian <= 0)) {
+    std::cerr << "usage: benchCMakeStartup <cmake> [runs [max-median-ms]]\n";
+    return 1;
+  }
+
+  double const median = measure({ cmake, "-E", "true" }, runs);
+  if (median < 0) {
+    std::cerr << "Running \"" << cmake << " -E true\" failed\n";
+    return 1;
+  }
+  std::cout << "cmake -E true: median " << median << " ms of " << runs
+            << " runs\n";
+  if (maxMedian > 0 && median > maxMedian) {
+    std::cerr << "The median exceeds " << maxMedian << " ms\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,73 @@
+# Run control flow commands in a loop.  KIND selects the commands:
+# if, while, function, or macro.
+#
+# Run as:
+#
+#   benchCMakeScript <cmake> benchControlFlow.cmake \
+#     KIND=if,while,function,macro ITERATIONS=<iterations>
+cmake_minimum_required(VERSION 3.20)
+
+function(classify_function value)
+  if(value LESS 10)
+    set(kind small PARENT_SCOPE)
+  elseif(value LESS 100 AND NOT value EQUAL 50)
+    set(kind medium PARENT_SCOPE)
+  else()
+    set(kind large PARENT_SCOPE)
+  endif()
+endfunction()
+
+macro(classify_macro value)
+  if(${value} LESS 10)
+    set(kind small)
+  elseif(${value} LESS 100 AND NOT ${value} EQUAL 50)
+    set(kind medium)
+  else()
+    set(kind large)
+  endif()
+endmacro()
+
+set(count 0)
+foreach(i RANGE 1 ${ITERATIONS})
+  if(KIND STREQUAL "if")
+    if(i LESS 10)
+      set(kind small)
+    elseif(i LESS 100 AND NOT i EQUAL 50)
+      set(kind medium)
+    else()
+      set(kind large)
+    endif()
+  elseif(KIND STREQUAL "while")
+    set(j 0)
+    while(TRUE)
+      math(EXPR j "${j} + 1")
+      if(j EQUAL 2)
+        continue()
+      elseif(j GREATER 3)
+        break()
+      endif()
+    endwhile()
+    set(kind medium)
+  elseif(KIND STREQUAL "function")
+    classify_function(${i})
+  else()
+    classify_macro(i)
+  endif()
+  if(kind STREQUAL "medium")
+    math(EXPR count "${count} + 1")
+  endif()
+endforeach()
+
+if(KIND STREQUAL "while")
+  set(expected ${ITERATIONS})
+else()
+  set(expected 0)
+  foreach(i RANGE 10 99)
+    if(i LESS_EQUAL ITERATIONS AND NOT i EQUAL 50)
+      math(EXPR expected "${expected} + 1")
+    endif()
+  endforeach()
+endif()
+if(NOT count EQUAL expected)
+  message(FATAL_ERROR "Unexpected count ${count}, expected ${expected}")
+endif()
@@ -0,0 +1,153 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Compare the flex generated lexer for dependencies files with the
+// hand-written parser, and the reading of many files with and without a
+// shared cmGccDepfileReader.
+//
+// Usage: benchGccDepfileReader [iterations [paths-per-file]]
+//
+// Timing depends on the machine, so this is run by hand rather than as a
+// test.  testGccDepfileReader checks the parsed results.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmGccDepfileLexerHelper.h"
+#include "cmGccDepfileReader.h"
+#include "cmGccDepfileReaderTypes.h"
+#include "cmMappedFile.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+
+// Write a dependencies file like those of header-heavy C++ sources.
+bool writeDepfile(std::string const& path, int paths)
+{
+  cmsys::ofstream fout(path.c_str());
+  fout << "CMakeFiles/bench.dir/src/bench.cxx.o: \\\n"
+       << " /home/user/src/bench.cxx \\\n";
+  for (int i = 0; i < paths; ++i) {
+    switch (i % 4) {
+      case 0:
+        fout << " /usr/include/c++/10/bits/header_" << i << ".h";
+        break;
+      case 1:
+        fout << " /usr/lib/gcc/x86_64-linux-gnu/10/../../../../include/"
+             << "c++/10/ext/detail_" << i << ".hpp";
+        break;
+      case 2:
+        fout << " /home/user/src/with\\ space/dir_" << i << "/file.h";
+        break;
+      default:
+        fout << " ../src/relative/./path_" << i << "/file$$.h";
+        break;
+    }
+    fout << (i + 1 < paths ? " \\\n" : "\n");
+  }
+  return static_cast<bool>(fout);
+}
+
+template <typename F>
+double measure(int iterations, F const& f)
+{
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    if (!f()) {
+      return -1;
+    }
+  }
+  std::chrono::duration<double, std::milli> const total =
+    std::chrono::steady_clock::now() - start;
+  return total.count() / iterations;
+}
+
+bool report(const char* label, double ms)
+{
+  if (ms < 0) {
+    std::cerr << label << ": reading failed\n";
+    return false;
+  }
+  std::cout << label << ": " << ms << " ms per file\n";
+  return true;
+}
+
+bool sameContent(cmGccDepfileContent const& a, cmGccDepfileContent const& b)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (a[i].rules != b[i].rules || a[i].paths != b[i].paths) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  int const iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+  int const paths = argc > 2 ? std::atoi(argv[2]) : 2000;
+  if (iterations <= 0 || paths <= 0) {
+    std::cerr << "usage: benchGccDepfileReader [iterations [paths]]\n";
+    return 1;
+  }
+
+  std::string const depfile = cmStrCat(
+    cmSystemTools::GetCurrentWorkingDirectory(), "/benchGccDepfileReader.d");
+  if (!writeDepfile(depfile, paths)) {
+    std::cerr << "Cannot write " << depfile << '\n';
+    return 1;
+  }
+  std::cout << "Reading " << depfile << " with " << paths << " paths, "
+            << iterations << " times\n";
+
+  // Both lexers must produce the same content.
+  cmGccDepfileLexerHelper flex;
+  cmGccDepfileLexerHelper hand;
+  cmMappedFile file;
+  if (!flex.readFile(depfile.c_str()) || !file.Open(depfile) ||
+      !hand.parseContent(file.View()) ||
+      !sameContent(std::move(flex).extractContent(),
+                   std::move(hand).extractContent())) {
+    std::cerr << "The lexers disagree on " << depfile << '\n';
+    return 1;
+  }
+  file.Close();
+
+  bool ok = report("flex lexer", measure(iterations, [&depfile]() {
+                     cmGccDepfileLexerHelper helper;
+                     return helper.readFile(depfile.c_str());
+                   }));
+  ok = report("hand-written parser", measure(iterations, [&depfile]() {
+                cmMappedFile mapped;
+                cmGccDepfileLexerHelper helper;
+                return mapped.Open(depfile) &&
+                  helper.parseContent(mapped.View());
+              })) &&
+    ok;
+  ok = report("cmReadGccDepfile", measure(iterations, [&depfile]() {
+                return static_cast<bool>(
+                  cmReadGccDepfile(depfile.c_str(), "/home/user/build"));
+              })) &&
+    ok;
+  cmGccDepfileReader reader;
+  ok = report("shared cmGccDepfileReader", measure(iterations, [&]() {
+                return static_cast<bool>(
+                  reader.Read(depfile.c_str(), "/home/user/build"));
+              })) &&
+    ok;
+
+  cmSystemTools::RemoveFile(depfile);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+# Build a list of N elements with list(APPEND) and then use it as OP says:
+#
+#   append  - Nothing more.
+#   get     - list(GET) every element.
+#   length  - list(LENGTH) N times.
+#   find    - list(FIND) the last element 100 times.
+#   foreach - foreach(IN LISTS) over the list.
+#
+# The time of building the list is part of every operation.  Run as:
+#
+#   benchCMakeScript <cmake> benchListCommand.cmake \
+#     OP=append,get,length,find,foreach N=<n>
+cmake_minimum_required(VERSION 3.20)
+
+math(EXPR last "${N} - 1")
+set(list)
+foreach(i RANGE ${last})
+  list(APPEND list "src/module_${i}/source_${i}.cxx")
+endforeach()
+
+if(OP STREQUAL "get")
+  foreach(i RANGE ${last})
+    list(GET list ${i} item)
+  endforeach()
+elseif(OP STREQUAL "length")
+  foreach(i RANGE ${last})
+    list(LENGTH list length)
+  endforeach()
+elseif(OP STREQUAL "find")
+  foreach(i RANGE 99)
+    list(FIND list "src/module_${last}/source_${last}.cxx" index)
+  endforeach()
+  if(NOT index EQUAL last)
+    message(FATAL_ERROR "list(FIND) returned ${index} instead of ${last}")
+  endif()
+elseif(OP STREQUAL "foreach")
+  foreach(item IN LISTS list)
+    set(found "${item}")
+  endforeach()
+elseif(NOT OP STREQUAL "append")
+  message(FATAL_ERROR "Unknown OP \"${OP}\"")
+endif()
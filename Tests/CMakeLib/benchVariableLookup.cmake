@@ -0,0 +1,36 @@
+# Call functions nested DEPTH deep.  The innermost function reads
+# variables set at the top level and in every enclosing function, and
+# each function returns a result to its caller with PARENT_SCOPE.
+#
+# Run as:
+#
+#   benchCMakeScript <cmake> benchVariableLookup.cmake \
+#     DEPTH=1,10,50,200 CALLS=<calls>
+cmake_minimum_required(VERSION 3.20)
+
+foreach(i RANGE 49)
+  set(global_${i} "value_${i}")
+endforeach()
+
+function(nested level)
+  set(local_${level} "${level}")
+  if(level LESS DEPTH)
+    math(EXPR next "${level} + 1")
+    nested(${next})
+  else()
+    foreach(i RANGE 49)
+      if(global_${i} AND "${global_${i}}" STREQUAL "value_${i}")
+        set(found "${local_1}${local_${level}}${global_${i}}")
+      endif()
+    endforeach()
+    set(nested_result "${found}")
+  endif()
+  set(nested_result "${nested_result}" PARENT_SCOPE)
+endfunction()
+
+foreach(call RANGE 1 ${CALLS})
+  nested(1)
+endforeach()
+if(NOT nested_result STREQUAL "1${DEPTH}value_49")
+  message(FATAL_ERROR "Unexpected result \"${nested_result}\"")
+endif()
@@ -0,0 +1,118 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmCacheBinaryFile.h"
+#include "cmCacheManager.h"
+#include "cmMessenger.h"
+#include "cmStateTypes.h"
+#include "cmSystemTools.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+
+std::string const dir = "testCacheManager";
+std::string const cacheFile = dir + "/CMakeCache.txt";
+std::string const binaryFile = dir + "/CMakeFiles/CMakeCache.bin";
+
+std::string LoadValue()
+{
+  cmCacheManager manager;
+  std::set<std::string> excludes;
+  std::set<std::string> includes;
+  if (!manager.LoadCache(dir, true, excludes, includes)) {
+    return "<not loaded>";
+  }
+  cmProp value = manager.GetCacheEntryValue("VAR");
+  return value ? *value : "<not set>";
+}
+
+bool testSaveStoresBinaryCopy()
+{
+  std::cout << "testSaveStoresBinaryCopy()\n";
+
+  cmSystemTools::RemoveADirectory(dir);
+  cmSystemTools::MakeDirectory(dir);
+  cmMessenger messenger;
+  {
+    cmCacheManager manager;
+    manager.AddCacheEntry("VAR", "text", "A variable.", cmStateEnums::STRING);
+    ASSERT_TRUE(manager.SaveCache(dir, &messenger));
+  }
+  ASSERT_TRUE(cmSystemTools::FileExists(binaryFile));
+  ASSERT_TRUE(LoadValue() == "text");
+  return true;
+}
+
+bool testLoadUsesBinaryCopy()
+{
+  std::cout << "testLoadUsesBinaryCopy()\n";
+
+  // Give the binary copy a value that is not in the text file, but keep
+  // it valid for the unchanged text file.  Loading the cache again must
+  // then see that value.
+  std::vector<cmCacheBinaryFile::Entry> entries;
+  ASSERT_TRUE(cmCacheBinaryFile::Load(binaryFile, cacheFile, entries));
+  bool found = false;
+  for (cmCacheBinaryFile::Entry& e : entries) {
+    if (e.Key == "VAR") {
+      e.Value = "binary";
+      found = true;
+    }
+  }
+  ASSERT_TRUE(found);
+  cmCacheBinaryFile::Store(binaryFile, cacheFile, entries);
+  ASSERT_TRUE(LoadValue() == "binary");
+  ASSERT_TRUE(LoadValue() == "binary");
+  return true;
+}
+
+bool testEditedTextWins()
+{
+  std::cout << "testEditedTextWins()\n";
+
+  // An edit of the same size must still be noticed.
+  std::string content;
+  {
+    cmsys::ifstream fin(cacheFile.c_str());
+    std::string line;
+    while (cmSystemTools::GetLineFromStream(fin, line)) {
+      if (line == "VAR:STRING=text") {
+        line = "VAR:STRING=edit";
+      }
+      content += line;
+      content += '\n';
+    }
+  }
+  {
+    cmsys::ofstream fout(cacheFile.c_str());
+    fout << content;
+  }
+  ASSERT_TRUE(LoadValue() == "edit");
+  return true;
+}
+
+} // namespace
+
+int testCacheManager(int /*unused*/, char* /*unused*/ [])
+{
+  int result = 0;
+  if (!testSaveStoresBinaryCopy() || !testLoadUsesBinaryCopy() ||
+      !testEditedTextWins()) {
+    result = 1;
+  }
+  cmSystemTools::RemoveADirectory(dir);
+  return result;
+}
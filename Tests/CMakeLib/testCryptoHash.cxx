@@ -0,0 +1,64 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <cmConfigure.h> // IWYU pragma: keep
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <cm/string_view>
+
+#include "cmCryptoHash.h"
+
+int testCryptoHash(int /*unused*/, char* /*unused*/ [])
+{
+  int failed = 0;
+
+  auto assert_string = [&failed](std::string const& generated,
+                                 cm::string_view expected,
+                                 cm::string_view title) {
+    if (generated == expected) {
+      std::cout << "Passed: " << title << "\n";
+    } else {
+      std::cout << "Failed: " << title << "\n";
+      std::cout << "Expected: " << expected << "\n";
+      std::cout << "Got: " << generated << "\n";
+      ++failed;
+    }
+  };
+
+  // ----------------------------------------------------------------------
+  // Test AlgoXXH64 with the reference values
+  {
+    cmCryptoHash hash(cmCryptoHash::AlgoXXH64);
+    assert_string(hash.HashString(""), "ef46db3751d8e999", "XXH64 empty");
+    assert_string(hash.HashString("a"), "d24ec4f1a98c6e5b", "XXH64 a");
+    assert_string(hash.HashString("abc"), "44bc2cf5ad770999", "XXH64 abc");
+    assert_string(
+      hash.HashString("The quick brown fox jumps over the lazy dog"),
+      "0b242d361fda71bc", "XXH64 long input");
+  }
+
+  // ----------------------------------------------------------------------
+  // Test AlgoXXH64 with input appended in pieces
+  {
+    std::string input;
+    for (int i = 0; i < 200; ++i) {
+      input += static_cast<char>(i * 7);
+    }
+    cmCryptoHash whole(cmCryptoHash::AlgoXXH64);
+    std::string const expected = whole.HashString(input);
+    for (std::size_t piece : { 1, 3, 31, 32, 33, 64 }) {
+      cmCryptoHash hash(cmCryptoHash::AlgoXXH64);
+      hash.Initialize();
+      for (std::size_t pos = 0; pos < input.size(); pos += piece) {
+        hash.Append(cm::string_view(input).substr(pos, piece));
+      }
+      assert_string(hash.FinalizeHex(), expected,
+                    "XXH64 in pieces of " + std::to_string(piece));
+    }
+  }
+
+  return failed;
+}
@@ -1,8 +1,11 @@
 /* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include <iostream>
+#include <iterator>
 #include <string>
 
+#include "cmsys/FStream.hxx"
+
 #include "cmGeneratedFileStream.h"
 #include "cmSystemTools.h"
 
@@ -75,6 +78,31 @@ int testGeneratedFileStream(int /*unused*/, char* /*unused*/ [])
     cmFailed("Something wrong with cmGeneratedFileStream. Cannot find file: ",
              file1.c_str());
   }
+
+  // Write more than a custom buffer holds and let the destructor flush
+  // the rest of the buffer.
+  std::string file5 = "generatedFile5";
+  std::string content5;
+  for (int i = 0; i < 1000; ++i) {
+    content5 += "This is line " + std::to_string(i) + " of file 5\n";
+  }
+  {
+    cmGeneratedFileStream buffered;
+    buffered.SetBufferSize(1024);
+    buffered.Open(file5);
+    buffered << content5;
+  }
+  {
+    cmsys::ifstream fin(file5.c_str());
+    std::string actual((std::istreambuf_iterator<char>(fin)),
+                       std::istreambuf_iterator<char>());
+    if (actual != content5) {
+      cmFailed("Something wrong with cmGeneratedFileStream. Content differs "
+               "after writing through a custom buffer: ",
+               file5.c_str());
+    }
+  }
+
   cmSystemTools::RemoveFile(file1);
   cmSystemTools::RemoveFile(file2);
   cmSystemTools::RemoveFile(file3);
@@ -83,6 +111,7 @@ int testGeneratedFileStream(int /*unused*/, char* /*unused*/ [])
   cmSystemTools::RemoveFile(file2tmp);
   cmSystemTools::RemoveFile(file3tmp);
   cmSystemTools::RemoveFile(file4tmp);
+  cmSystemTools::RemoveFile(file5);
 
   return failed;
 }
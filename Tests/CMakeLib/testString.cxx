@@ -407,6 +407,21 @@ static bool testOperatorPlusEqual()
   ASSERT_TRUE(str.size() == 7);
   ASSERT_TRUE(std::strncmp(str.data(), "abcdefg", 7) == 0);
   ASSERT_TRUE(str.is_stable());
+  {
+    // Appending to a shared buffer does not change the other owners.
+    cm::String copy = str;
+    str += "h";
+    ASSERT_TRUE(copy == "abcdefg");
+    ASSERT_TRUE(str == "abcdefgh");
+    // Appending to a substring does not change the rest of the buffer.
+    cm::String sub = str.substr(0, 2);
+    sub += "x";
+    ASSERT_TRUE(sub == "abx");
+    ASSERT_TRUE(str == "abcdefgh");
+    // Appending a view of the buffer to itself.
+    str += str.view();
+    ASSERT_TRUE(str == "abcdefghabcdefgh");
+  }
   return true;
 }
 
@@ -0,0 +1,210 @@
+# Drive the compiler_depend.internal database of a few fake targets with
+# 'cmake -E cmake_depends' and compiler generated dependencies files.
+set(dir "${CMAKE_CURRENT_BINARY_DIR}")
+
+file(WRITE "${dir}/a.d" "obj.o: ${dir}/src.c ${dir}/a.h\n")
+file(WRITE "${dir}/b.d" "obj.o: ${dir}/src.c ${dir}/b.h\n")
+
+# Write the DependInfo.cmake file of a target.  The arguments are pairs
+# of an object and the dependencies file read for it.
+function(write_depend_info target)
+  set(files "")
+  while(ARGN)
+    list(POP_FRONT ARGN object depfile)
+    string(APPEND files "  \"${dir}/src.c\" \"${object}\" \"gcc\" \"${dir}/${depfile}\"\n")
+  endwhile()
+  file(WRITE "${dir}/${target}.dir/DependInfo.cmake"
+    "set(CMAKE_DEPENDS_DEPENDENCY_FILES\n${files})\n")
+endfunction()
+
+# Touch the dependencies files so that they are newer than the database.
+function(touch_depfiles)
+  file(WRITE "${dir}/a.d" "obj.o: ${dir}/src.c ${dir}/a.h\n")
+  file(WRITE "${dir}/b.d" "obj.o: ${dir}/src.c ${dir}/b.h\n")
+endfunction()
+
+# Update the dependencies of a target.  Check whether they were
+# consolidated into compiler_depend.make and whether the database is
+# valid.
+function(check_depends step target consolidated)
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E cmake_depends "Unix Makefiles"
+            ${dir} ${dir} ${dir} ${dir} ${dir}/${target}.dir/DependInfo.cmake
+    OUTPUT_VARIABLE out
+    ERROR_VARIABLE err
+    RESULT_VARIABLE res
+    )
+  if(NOT res EQUAL 0 OR NOT err STREQUAL "")
+    message(SEND_ERROR "${step}: cmake_depends failed (${res}):\n${err}")
+  endif()
+  if(out MATCHES "Consolidate compiler generated dependencies of target ${target}")
+    set(actual TRUE)
+  else()
+    set(actual FALSE)
+  endif()
+  if(NOT actual STREQUAL consolidated)
+    message(SEND_ERROR "${step}: expected consolidated '${consolidated}' "
+      "but got '${actual}':\n${out}")
+  endif()
+  file(READ "${dir}/${target}.dir/compiler_depend.internal" magic
+    LIMIT 4 HEX)
+  if(NOT magic STREQUAL "434d4444") # CMDD
+    message(SEND_ERROR "${step}: database of '${target}' is not binary.")
+  endif()
+endfunction()
+
+function(check_make_depends step target dep)
+  file(READ "${dir}/${target}.dir/compiler_depend.make" content)
+  if(NOT content MATCHES "obj\\.o: .*[ /]${dep}\n")
+    message(SEND_ERROR "${step}: '${dep}' not listed in compiler_depend.make:\n"
+      "${content}")
+  endif()
+endfunction()
+
+function(database_size target var)
+  file(SIZE "${dir}/${target}.dir/compiler_depend.internal" size)
+  set(${var} ${size} PARENT_SCOPE)
+endfunction()
+
+# A new database holds the dependencies.
+write_depend_info(append obj.o a.d)
+check_depends(fresh append TRUE)
+check_make_depends(fresh append a.h)
+database_size(append fresh_size)
+
+# Reading unchanged dependencies writes nothing.
+touch_depfiles()
+file(REMOVE "${dir}/append.dir/compiler_depend.make")
+check_depends(unchanged append FALSE)
+database_size(append size)
+if(NOT size EQUAL fresh_size)
+  message(SEND_ERROR "unchanged: database size ${size}, not ${fresh_size}.")
+endif()
+if(EXISTS "${dir}/append.dir/compiler_depend.make")
+  message(SEND_ERROR "unchanged: compiler_depend.make was written.")
+endif()
+
+# Changed dependencies are appended.
+write_depend_info(append obj.o b.d)
+touch_depfiles()
+check_depends(append append TRUE)
+check_make_depends(append append b.h)
+database_size(append size)
+if(NOT size GREATER fresh_size)
+  message(SEND_ERROR "append: database size ${size} did not grow.")
+endif()
+
+# The database of a single object holds 2 records now.  Fewer than 1000
+# records are not compacted.
+set(pairs "")
+foreach(i RANGE 1 997)
+  if(i MATCHES "[13579]$")
+    list(APPEND pairs obj.o a.d)
+  else()
+    list(APPEND pairs obj.o b.d)
+  endif()
+endforeach()
+write_depend_info(append ${pairs})
+touch_depfiles()
+check_depends(append-999 append TRUE)
+check_make_depends(append-999 append a.h)
+database_size(append appended_size)
+if(NOT appended_size GREATER size)
+  message(SEND_ERROR "append-999: database size ${appended_size} did not grow.")
+endif()
+
+# The 1000th record compacts it.
+write_depend_info(append obj.o b.d)
+touch_depfiles()
+check_depends(compact-1000 append TRUE)
+check_make_depends(compact-1000 append b.h)
+database_size(append size)
+if(NOT size EQUAL fresh_size)
+  message(SEND_ERROR "compact-1000: database size ${size}, not ${fresh_size}.")
+endif()
+
+# A database is compacted only when it holds more than 3 records per
+# object.  Start with 1 record for each of 500 objects.
+function(write_ratio_depend_info)
+  set(pairs "")
+  foreach(i RANGE 1 500)
+    foreach(depfile IN LISTS ARGN)
+      list(APPEND pairs obj${i}.o ${depfile})
+    endforeach()
+  endforeach()
+  write_depend_info(ratio ${pairs})
+endfunction()
+write_ratio_depend_info(a.d)
+check_depends(ratio-500 ratio TRUE)
+database_size(ratio fresh_size)
+
+# 1500 records are kept.
+write_ratio_depend_info(b.d a.d)
+touch_depfiles()
+check_depends(ratio-1500 ratio TRUE)
+database_size(ratio size)
+if(NOT size GREATER fresh_size)
+  message(SEND_ERROR "ratio-1500: database size ${size} did not grow.")
+endif()
+
+# 2000 records are compacted.
+write_ratio_depend_info(b.d)
+touch_depfiles()
+check_depends(ratio-2000 ratio TRUE)
+database_size(ratio size)
+if(NOT size EQUAL fresh_size)
+  message(SEND_ERROR "ratio-2000: database size ${size}, not ${fresh_size}.")
+endif()
+
+# An invalid database is replaced by one with all dependencies.
+write_depend_info(corrupt obj.o a.d)
+foreach(content "garbage" "CMDD" "CMDD....")
+  file(WRITE "${dir}/corrupt.dir/compiler_depend.internal" "${content}")
+  touch_depfiles()
+  check_depends("corrupt '${content}'" corrupt TRUE)
+  check_make_depends("corrupt '${content}'" corrupt a.h)
+endforeach()
+find_program(HEAD_EXECUTABLE head)
+if(HEAD_EXECUTABLE)
+  database_size(corrupt size)
+  math(EXPR size "${size} - 1")
+  execute_process(
+    COMMAND ${HEAD_EXECUTABLE} -c ${size}
+            "${dir}/corrupt.dir/compiler_depend.internal"
+    OUTPUT_FILE "${dir}/corrupt.dir/truncated"
+    )
+  file(RENAME "${dir}/corrupt.dir/truncated"
+    "${dir}/corrupt.dir/compiler_depend.internal")
+  touch_depfiles()
+  check_depends(truncated corrupt TRUE)
+  check_make_depends(truncated corrupt a.h)
+  database_size(corrupt truncated_size)
+  math(EXPR size "${size} + 1")
+  if(NOT truncated_size EQUAL size)
+    message(SEND_ERROR "truncated: database size ${truncated_size}, not ${size}.")
+  endif()
+endif()
+
+# A text database of an older CMake is kept while no dependencies file
+# is newer, and then replaced.
+write_depend_info(legacy obj.o a.d)
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.125) # handle 1s resolution
+file(WRITE "${dir}/legacy.dir/compiler_depend.internal"
+  "# CMAKE generated file: DO NOT EDIT!\n"
+  "# Generated by \"Unix Makefiles\" Generator, CMake Version 3.20\n"
+  "\n"
+  "obj.o\n"
+  " ${dir}/src.c\n"
+  " ${dir}/a.h\n"
+  "\n")
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E cmake_depends "Unix Makefiles"
+          ${dir} ${dir} ${dir} ${dir} ${dir}/legacy.dir/DependInfo.cmake
+  OUTPUT_VARIABLE out
+  )
+if(out MATCHES "Consolidate")
+  message(SEND_ERROR "legacy: up-to-date text database was replaced:\n${out}")
+endif()
+touch_depfiles()
+check_depends(legacy legacy TRUE)
+check_make_depends(legacy legacy a.h)
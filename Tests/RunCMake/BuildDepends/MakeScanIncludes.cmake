@@ -0,0 +1,93 @@
+# Scan the include directives of a C source of a fake target with
+# 'cmake -E cmake_depends'.
+set(dir "${CMAKE_CURRENT_BINARY_DIR}")
+
+file(WRITE "${dir}/CMakeFiles/CMakeDirectoryInformation.cmake" "")
+file(WRITE "${dir}/scan.dir/DependInfo.cmake" "
+set(CMAKE_DEPENDS_LANGUAGES C)
+set(CMAKE_DEPENDS_CHECK_C \"${dir}/src/main.c\" \"${dir}/main.o\")
+set(CMAKE_C_TARGET_INCLUDE_PATH \"${dir}/inc\")
+")
+
+file(WRITE "${dir}/src/main.c"
+  "#  include \"spaced.h\"\n"
+  "%import \"imported.h\"\n"
+  " \t#\tinclude\t<tabbed.h>\n"
+  "#include \"local.h\"\n"
+  "#include <angle.h>\n"
+  "#include \"crlf.h\"\r\n"
+  "#include \"chain.h\"\n"
+  "#include_next \"next.h\"\n"
+  "#include \"unterminated.h\n"
+  "#include \"\"\n"
+  "#define NAME \"define.h\"\n"
+  "int main(void) { return 0; }\n"
+  )
+foreach(h spaced imported local angle crlf next unterminated define a b)
+  file(WRITE "${dir}/src/${h}.h" "")
+endforeach()
+foreach(h tabbed local angle)
+  file(WRITE "${dir}/inc/${h}.h" "")
+endforeach()
+file(WRITE "${dir}/src/chain.h" "#include \"a.h\"\n")
+
+function(check_depends step)
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E cmake_depends "Unix Makefiles"
+            ${dir} ${dir} ${dir} ${dir} ${dir}/scan.dir/DependInfo.cmake
+    OUTPUT_VARIABLE out
+    ERROR_VARIABLE err
+    RESULT_VARIABLE res
+    )
+  if(NOT res EQUAL 0 OR NOT err STREQUAL "")
+    message(SEND_ERROR "${step}: cmake_depends failed (${res}):\n${err}")
+  endif()
+  if(NOT out MATCHES "Scanning dependencies of target scan")
+    message(SEND_ERROR "${step}: dependencies not scanned:\n${out}")
+  endif()
+
+  file(READ "${dir}/scan.dir/depend.internal" internal)
+  foreach(dep IN LISTS ARGN)
+    if(dep MATCHES "^!(.*)$")
+      if(internal MATCHES "\n ${dir}/${CMAKE_MATCH_1}\n")
+        message(SEND_ERROR "${step}: '${CMAKE_MATCH_1}' is a dependency:\n"
+          "${internal}")
+      endif()
+    elseif(NOT internal MATCHES "\n ${dir}/${dep}\n")
+      message(SEND_ERROR "${step}: '${dep}' is not a dependency:\n"
+        "${internal}")
+    endif()
+  endforeach()
+
+  file(READ "${dir}/scan.dir/C.includecache" magic LIMIT 4 HEX)
+  if(NOT magic STREQUAL "434d4943") # CMIC
+    message(SEND_ERROR "${step}: C.includecache is not binary.")
+  endif()
+endfunction()
+
+check_depends(scan
+  src/main.c
+  src/spaced.h
+  src/imported.h
+  inc/tabbed.h
+  src/local.h
+  !inc/local.h
+  inc/angle.h
+  !src/angle.h
+  src/crlf.h
+  src/chain.h
+  src/a.h
+  !src/b.h
+  !src/next.h
+  !src/unterminated.h
+  !src/define.h
+  )
+
+# A header that changes without changing its size is scanned again.
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.125) # handle 1s resolution
+file(WRITE "${dir}/src/chain.h" "#include \"b.h\"\n")
+check_depends(rescan
+  src/chain.h
+  src/b.h
+  !src/a.h
+  )
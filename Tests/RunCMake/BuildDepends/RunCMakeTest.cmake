@@ -74,6 +74,7 @@ unset(RunCMake_TEST_SOURCE_DIR)
 
 if(RunCMake_GENERATOR MATCHES "Make")
   run_BuildDepends(MakeCustomIncludes)
+  run_cmake_script(MakeScanIncludes)
   if(NOT "${RunCMake_BINARY_DIR}" STREQUAL "${RunCMake_SOURCE_DIR}")
     run_BuildDepends(MakeInProjectOnly)
   endif()
@@ -163,4 +164,5 @@ endif()
 
 if(RunCMake_GENERATOR MATCHES "Make")
   run_BuildDepends(MakeDependencies)
+  run_cmake_script(CompilerDependDatabase)
 endif()
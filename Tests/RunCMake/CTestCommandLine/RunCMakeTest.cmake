@@ -193,6 +193,24 @@ add_test(Echo \"${CMAKE_COMMAND}\" -E echo \"EchoTest\")
 endfunction()
 run_SerialFailed()
 
+function(run_CriticalPath)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CriticalPath)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(Setup \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(Setup PROPERTIES COST 0.5)
+add_test(Check \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(Check PROPERTIES COST 0.5 DEPENDS Setup)
+add_test(Long \"${CMAKE_COMMAND}\" -E true)
+set_tests_properties(Long PROPERTIES COST 10)
+")
+
+  run_cmake_command(CriticalPath ${CMAKE_CTEST_COMMAND} -j2 -V)
+endfunction()
+run_CriticalPath()
+
 function(run_TestLoad name load)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestLoad)
   set(RunCMake_TEST_NO_CLEAN 1)
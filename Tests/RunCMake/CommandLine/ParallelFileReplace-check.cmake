@@ -0,0 +1,24 @@
+# Record every file of the build tree with its content hash.
+file(GLOB_RECURSE files RELATIVE "${RunCMake_TEST_BINARY_DIR}"
+  "${RunCMake_TEST_BINARY_DIR}/*")
+list(SORT files)
+set(manifest "")
+foreach(f IN LISTS files)
+  if(f MATCHES "\\.tmp[0-9a-f]*$")
+    string(APPEND RunCMake_TEST_FAILED "Temporary file left behind:\n  ${f}\n")
+  endif()
+  file(SHA256 "${RunCMake_TEST_BINARY_DIR}/${f}" hash)
+  string(APPEND manifest "${hash} ${f}\n")
+endforeach()
+
+# The parallel run must produce exactly the files of the serial run.
+if(EXISTS "${ParallelFileReplace_MANIFEST}")
+  file(READ "${ParallelFileReplace_MANIFEST}" expect)
+  if(NOT manifest STREQUAL expect)
+    string(APPEND RunCMake_TEST_FAILED
+      "Generated files differ from the serial run.\n"
+      "Expected:\n${expect}\nActual:\n${manifest}")
+  endif()
+else()
+  file(WRITE "${ParallelFileReplace_MANIFEST}" "${manifest}")
+endif()
@@ -0,0 +1,4 @@
+enable_testing()
+foreach(i RANGE 1 8)
+  add_subdirectory(ParallelFileReplace ParallelFileReplace-${i})
+endforeach()
@@ -0,0 +1,15 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+# Stacks contain semicolons so do not read the output as a list.
+file(READ "${ProfilingTestOutput}" folded)
+if (NOT folded MATCHES "^([^\n]+ [0-9]+\n)+$")
+  set(RunCMake_TEST_FAILED "Unexpected folded output:\n${folded}")
+  return()
+endif()
+if (NOT folded MATCHES "(^|\n)configure;")
+  set(RunCMake_TEST_FAILED "Expected stacks below configure in:\n${folded}")
+  return()
+endif()
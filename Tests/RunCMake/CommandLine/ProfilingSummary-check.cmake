@@ -0,0 +1,24 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+file(READ "${ProfilingTestOutput}" summary)
+foreach(table IN ITEMS "Categories" "Commands" "List files")
+  if (NOT summary MATCHES "(^|\n)${table}:\n +Self \\[ms\\] +Total \\[ms\\] +Calls  ")
+    set(RunCMake_TEST_FAILED "Expected table \"${table}\" in:\n${summary}")
+    return()
+  endif()
+endforeach()
+foreach(row IN ITEMS
+    " +1  __testing_command_case\n"
+    " +1  configure\n"
+    "  generate\n"
+    "  expand\n"
+    "ProfilingSummary\\.cmake\n"
+    )
+  if (NOT summary MATCHES "${row}")
+    set(RunCMake_TEST_FAILED "Expected row matching \"${row}\" in:\n${summary}")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1,7 @@
+function(__testing_command_case)
+  foreach(i RANGE 100)
+    string(APPEND s "${i}")
+  endforeach()
+endfunction()
+
+__testing_command_case()
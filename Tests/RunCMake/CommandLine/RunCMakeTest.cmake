@@ -71,6 +71,12 @@ run_cmake_command(install-bad-dir
 run_cmake_command(install-options-to-vars
   ${CMAKE_COMMAND} --install ${RunCMake_SOURCE_DIR}/dir-install-options-to-vars
   --strip --prefix /var/test --config sample --component pack)
+run_cmake_command(install-parallel
+  ${CMAKE_COMMAND} --install ${RunCMake_SOURCE_DIR}/dir-install-options-to-vars
+  --parallel 3)
+run_cmake_command(install-parallel-bad
+  ${CMAKE_COMMAND} --install ${RunCMake_SOURCE_DIR}/dir-install-options-to-vars
+  -j 0)
 run_cmake_command(install-default-dir-permissions-all
   ${CMAKE_COMMAND} --install ${RunCMake_SOURCE_DIR}/dir-permissions-install-options-to-vars
   --default-directory-permissions u=rwx,g=rx,o=rx)
@@ -833,3 +839,28 @@ set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output.json)
 set(RunCMake_TEST_OPTIONS --profiling-format=google-trace --profiling-output=${ProfilingTestOutput})
 run_cmake(ProfilingTest)
 unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-summary")
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/summary.txt)
+set(RunCMake_TEST_OPTIONS --profiling-format=summary --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingSummary)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-folded")
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/folded.txt)
+set(RunCMake_TEST_OPTIONS --profiling-format=folded --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingFolded)
+unset(RunCMake_TEST_OPTIONS)
+unset(RunCMake_TEST_BINARY_DIR)
+
+run_cmake_with_options(parallel-file-replace-invalid --parallel-file-replace=0)
+
+function(run_ParallelFileReplace)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ParallelFileReplace-build)
+  set(ParallelFileReplace_MANIFEST ${RunCMake_BINARY_DIR}/ParallelFileReplace.txt)
+  file(REMOVE "${ParallelFileReplace_MANIFEST}")
+  run_cmake(ParallelFileReplace)
+  set(RunCMake_TEST_VARIANT_DESCRIPTION "-parallel")
+  run_cmake_with_options(ParallelFileReplace --parallel-file-replace=4)
+endfunction()
+run_ParallelFileReplace()
@@ -13,3 +13,7 @@ endif()
 if(CMAKE_INSTALL_DO_STRIP)
   message("CMAKE_INSTALL_DO_STRIP is ${CMAKE_INSTALL_DO_STRIP}")
 endif()
+
+if(CMAKE_INSTALL_PARALLEL_LEVEL)
+  message("CMAKE_INSTALL_PARALLEL_LEVEL is ${CMAKE_INSTALL_PARALLEL_LEVEL}")
+endif()
@@ -0,0 +1,2 @@
+set(CACHE_BINARY_VAR "a" CACHE STRING "Value edited in CMakeCache.txt")
+message(STATUS "CACHE_BINARY_VAR='${CACHE_BINARY_VAR}'")
@@ -51,6 +51,23 @@ run_cmake(RemoveCache)
 file(REMOVE "${RunCMake_TEST_BINARY_DIR}/CMakeCache.txt")
 run_cmake(RemoveCache)
 
+# Use a single build tree for a few tests without cleaning.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CacheBinary-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+run_cmake(CacheBinary)
+run_cmake_command(CacheBinary-rerun ${CMAKE_COMMAND} .)
+# The text file stays authoritative, even if its size does not change.
+set(cache "${RunCMake_TEST_BINARY_DIR}/CMakeCache.txt")
+file(READ "${cache}" content)
+string(REPLACE "CACHE_BINARY_VAR:STRING=a" "CACHE_BINARY_VAR:STRING=b"
+  content "${content}")
+file(WRITE "${cache}" "${content}")
+run_cmake_command(CacheBinary-edit ${CMAKE_COMMAND} .)
+unset(RunCMake_TEST_BINARY_DIR)
+unset(RunCMake_TEST_NO_CLEAN)
+
 if(NOT RunCMake_GENERATOR MATCHES "^Ninja Multi-Config$")
   run_cmake(NoCMAKE_CROSS_CONFIGS)
   run_cmake(NoCMAKE_DEFAULT_BUILD_TYPE)
@@ -0,0 +1,27 @@
+if(RunCMake_GENERATOR_IS_MULTI_CONFIG)
+  set(configs Debug Release)
+else()
+  set(configs Debug)
+endif()
+
+set(value_first 1)
+set(value_second 0)
+foreach(tgt IN ITEMS first second)
+  foreach(n IN ITEMS 1 2)
+    foreach(config IN LISTS configs)
+      if(config STREQUAL "Debug")
+        set(prefix debug)
+      else()
+        set(prefix other)
+      endif()
+      string(TOUPPER "${config}" upper)
+      set(expected "${prefix}|${upper}|${tgt}|${value_${tgt}}")
+      set(file "${RunCMake_TEST_BINARY_DIR}/ResultCache-${tgt}-${n}-${config}.txt")
+      file(READ "${file}" content)
+      if(NOT content STREQUAL expected)
+        string(APPEND RunCMake_TEST_FAILED
+          "${file} contains\n [[${content}]]\nbut expected\n [[${expected}]]\n")
+      endif()
+    endforeach()
+  endforeach()
+endforeach()
@@ -0,0 +1,14 @@
+cmake_policy(SET CMP0070 NEW)
+
+# Evaluate the same expressions for several targets and configurations.
+# Results reused across evaluations must match those computed directly.
+set(content "$<IF:$<CONFIG:Debug>,debug,other>|$<UPPER_CASE:$<CONFIG>>|$<TARGET_PROPERTY:NAME>|$<BOOL:$<TARGET_PROPERTY:VALUE>>")
+foreach(tgt IN ITEMS first second)
+  add_custom_target(${tgt})
+  foreach(n IN ITEMS 1 2)
+    file(GENERATE OUTPUT "ResultCache-${tgt}-${n}-$<CONFIG>.txt"
+      CONTENT "${content}" TARGET ${tgt})
+  endforeach()
+endforeach()
+set_property(TARGET first PROPERTY VALUE ON)
+set_property(TARGET second PROPERTY VALUE OFF)
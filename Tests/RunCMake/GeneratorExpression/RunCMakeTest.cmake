@@ -70,3 +70,11 @@ run_cmake(CMP0085-WARN)
 set(RunCMake_TEST_OPTIONS -DCMAKE_POLICY_DEFAULT_CMP0085:STRING=NEW)
 run_cmake(CMP0085-NEW)
 unset(RunCMake_TEST_OPTIONS)
+
+if(RunCMake_GENERATOR_IS_MULTI_CONFIG)
+  set(RunCMake_TEST_OPTIONS [==[-DCMAKE_CONFIGURATION_TYPES=Debug;Release]==])
+else()
+  set(RunCMake_TEST_OPTIONS -DCMAKE_BUILD_TYPE=Debug)
+endif()
+run_cmake(ResultCache)
+unset(RunCMake_TEST_OPTIONS)
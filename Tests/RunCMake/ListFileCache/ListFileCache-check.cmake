@@ -0,0 +1,19 @@
+set(cache_dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileCache")
+file(GLOB entries "${cache_dir}/*.bin")
+list(LENGTH entries count)
+if(count LESS 3)
+  set(RunCMake_TEST_FAILED "Expected cached list files, found ${count}.")
+endif()
+
+foreach(f CMakeLists.txt ListFileCache.cmake)
+  string(MD5 key "${RunCMake_SOURCE_DIR}/${f}")
+  if(NOT EXISTS "${cache_dir}/${key}.bin")
+    string(APPEND RunCMake_TEST_FAILED "\n${f} was not cached.")
+  endif()
+endforeach()
+
+# Files whose parse produced a warning must not be stored.
+string(MD5 key "${RunCMake_SOURCE_DIR}/SyntaxWarning.cmake")
+if(EXISTS "${cache_dir}/${key}.bin")
+  string(APPEND RunCMake_TEST_FAILED "\nSyntaxWarning.cmake was cached.")
+endif()
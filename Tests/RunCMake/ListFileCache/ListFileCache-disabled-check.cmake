@@ -0,0 +1,3 @@
+if(EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileCache")
+  set(RunCMake_TEST_FAILED "ListFileCache directory created without CMAKE_LISTFILE_CACHE.")
+endif()
@@ -0,0 +1,6 @@
+include(${CMAKE_CURRENT_LIST_DIR}/SyntaxWarning.cmake)
+include(${CMAKE_CURRENT_BINARY_DIR}/Generated.cmake)
+function(warn_from_function)
+  message(AUTHOR_WARNING "Warning from function")
+endfunction()
+warn_from_function()
@@ -0,0 +1,22 @@
+include(RunCMake)
+
+function(run_ListFileCache)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ListFileCache-build)
+  set(generated "${RunCMake_TEST_BINARY_DIR}/Generated.cmake")
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${generated}" "message(STATUS \"Generated version 1\")\n")
+
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_with_options(ListFileCache -DCMAKE_LISTFILE_CACHE=ON)
+
+  # A second run loads unchanged files from the cache and must report
+  # the same diagnostics and backtraces as the first.
+  run_cmake_command(ListFileCache-rerun ${CMAKE_COMMAND} .)
+
+  # A modified file must be parsed again.
+  file(WRITE "${generated}" "message(STATUS \"Generated version 2 (modified)\")\n")
+  run_cmake_command(ListFileCache-modified ${CMAKE_COMMAND} .)
+endfunction()
+run_ListFileCache()
+
+run_cmake(ListFileCache-disabled)
@@ -0,0 +1,21 @@
+cmake_policy(SET CMP0053 NEW)
+
+# Arguments expanded again must see the current values.
+macro(show_macro)
+  message("macro: ${a${b}} $ENV{ExpandRepeat} $CACHE{ExpandRepeat}")
+endmacro()
+function(show_function)
+  message("function: ${a${b}} $ENV{ExpandRepeat} $CACHE{ExpandRepeat}")
+endfunction()
+
+set(a1 "nested1")
+set(a2 "nested2")
+set(a3 "nested3")
+foreach(i 1 2 3)
+  set(b "${i}")
+  set(ENV{ExpandRepeat} "env${i}")
+  set(ExpandRepeat "cache${i}" CACHE STRING "" FORCE)
+  message("loop: ${a${b}} $ENV{ExpandRepeat} $CACHE{ExpandRepeat} \${b} \;")
+  show_macro()
+  show_function()
+endforeach()
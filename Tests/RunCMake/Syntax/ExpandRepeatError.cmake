@@ -0,0 +1,11 @@
+cmake_policy(SET CMP0053 NEW)
+
+# The body argument of the macro is valid for the first two values but
+# not for the third.
+macro(show value)
+  message("macro: ${value}")
+endmacro()
+
+foreach(v "one" "two" "\${bad ref}")
+  show("${v}")
+endforeach()
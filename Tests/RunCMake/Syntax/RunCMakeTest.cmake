@@ -118,6 +118,10 @@ run_cmake(CMP0053-Dollar-NEW)
 # Variable special types
 run_cmake(QueryCache)
 
+# Arguments expanded repeatedly.
+run_cmake(ExpandRepeat)
+run_cmake(ExpandRepeatError)
+
 # Function and macro tests.
 run_cmake(FunctionUnmatched)
 run_cmake(FunctionUnmatchedForeach)
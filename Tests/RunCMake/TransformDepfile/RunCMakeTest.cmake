@@ -11,10 +11,19 @@ function(run_transform_depfile name)
     )
 endfunction()
 
+function(run_transform_depfile_batch name)
+  set(RunCMake-check-file batch.cmake)
+  run_cmake_command(batch-gcc
+    ${CMAKE_COMMAND} -E cmake_transform_depfile "${RunCMake_GENERATOR}" gccdepfile "${RunCMake_SOURCE_DIR}" "${RunCMake_SOURCE_DIR}/subdir" "${RunCMake_BINARY_DIR}" "${RunCMake_BINARY_DIR}/subdir" "${CMAKE_CURRENT_LIST_DIR}/${name}.d" out1.d "${CMAKE_CURRENT_LIST_DIR}/empty.d" out2.d "${CMAKE_CURRENT_LIST_DIR}/${name}.d" out3.d
+    )
+endfunction()
+
 if(WIN32)
   run_transform_depfile(deps-windows)
+  run_transform_depfile_batch(deps-windows)
 else()
   run_transform_depfile(deps-unix)
+  run_transform_depfile_batch(deps-unix)
 endif()
 run_transform_depfile(noexist)
 run_transform_depfile(empty)
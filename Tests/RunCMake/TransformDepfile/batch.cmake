@@ -0,0 +1,16 @@
+foreach(pair IN ITEMS "out1.d:${name}" "out2.d:empty" "out3.d:${name}")
+  string(REPLACE ":" ";" pair "${pair}")
+  list(GET pair 0 out)
+  list(GET pair 1 expected)
+  file(READ "${RunCMake_SOURCE_DIR}/${expected}.d.txt" expected_contents)
+  if(EXISTS "${RunCMake_TEST_BINARY_DIR}/${out}")
+    file(READ "${RunCMake_TEST_BINARY_DIR}/${out}" actual_contents)
+    if(NOT actual_contents STREQUAL expected_contents)
+      string(REPLACE "\n" "\n  " p_expected_contents "${expected_contents}")
+      string(REPLACE "\n" "\n  " p_actual_contents "${actual_contents}")
+      string(APPEND RunCMake_TEST_FAILED "Expected contents of ${RunCMake_TEST_BINARY_DIR}/${out}:\n  ${p_expected_contents}\nActual contents:\n  ${p_actual_contents}")
+    endif()
+  else()
+    string(APPEND RunCMake_TEST_FAILED "${RunCMake_TEST_BINARY_DIR}/${out} should exist\n")
+  endif()
+endforeach()
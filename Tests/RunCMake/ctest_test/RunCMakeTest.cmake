@@ -78,6 +78,28 @@ add_test(NAME FailingTest COMMAND ${CMAKE_COMMAND} -E no_such_command)
 endfunction()
 run_TestOutputSize()
 
+function(run_TestOutputSpill)
+  set(CASE_CTEST_TEST_ARGS EXCLUDE RunCMakeVersion)
+  set(CASE_TEST_PREFIX_CODE [[
+set(CTEST_CUSTOM_MAXIMUM_IN_MEMORY_TEST_OUTPUT_SIZE 100)
+set(CTEST_CUSTOM_MAXIMUM_PASSED_TEST_OUTPUT_SIZE 0)
+  ]])
+  string(CONCAT CASE_CMAKELISTS_SUFFIX_CODE [[
+add_test(NAME SpillPass COMMAND ${CMAKE_COMMAND} -P "]]
+    "${RunCMake_SOURCE_DIR}/TestOutputSpill.cmake" [[")
+set_property(TEST SpillPass PROPERTY PASS_REGULAR_EXPRESSION "SpillEnd")
+add_test(NAME SpillFail COMMAND ${CMAKE_COMMAND} -P "]]
+    "${RunCMake_SOURCE_DIR}/TestOutputSpill.cmake" [[")
+set_property(TEST SpillFail PROPERTY FAIL_REGULAR_EXPRESSION "SpillLine150")
+add_test(NAME SpillSpan COMMAND ${CMAKE_COMMAND} -P "]]
+    "${RunCMake_SOURCE_DIR}/TestOutputSpill.cmake" [[")
+set_property(TEST SpillSpan PROPERTY FAIL_REGULAR_EXPRESSION "^SpillLine1.*SpillEnd")
+  ]])
+
+  run_ctest(TestOutputSpill)
+endfunction()
+run_TestOutputSpill()
+
 run_ctest_test(TestRepeatBad1 REPEAT UNKNOWN:3)
 run_ctest_test(TestRepeatBad2 REPEAT UNTIL_FAIL:-1)
 
@@ -0,0 +1,35 @@
+file(GLOB test_log_file "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/LastTest_*.log")
+if(test_log_file)
+  file(READ "${test_log_file}" test_log)
+  foreach(line SpillLine1 SpillLine150 SpillEnd)
+    if(NOT "${test_log}" MATCHES "${line}\n")
+      set(RunCMake_TEST_FAILED "LastTest.log does not contain ${line}:\n ${test_log}")
+      return()
+    endif()
+  endforeach()
+else()
+  set(RunCMake_TEST_FAILED "LastTest.log not found")
+  return()
+endif()
+
+file(GLOB spill_files "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/TestOutput_*")
+if(spill_files)
+  set(RunCMake_TEST_FAILED "Spilled test output not removed:\n ${spill_files}")
+  return()
+endif()
+
+file(GLOB test_xml_file "${RunCMake_TEST_BINARY_DIR}/Testing/*/Test.xml")
+if(test_xml_file)
+  file(READ "${test_xml_file}" test_xml)
+  foreach(test IN ITEMS SpillPass:passed SpillFail:failed SpillSpan:failed)
+    string(REPLACE ":" ";" test "${test}")
+    list(GET test 0 name)
+    list(GET test 1 status)
+    if(NOT "${test_xml}" MATCHES "<Test Status=\"${status}\">[^<]*<Name>${name}</Name>")
+      set(RunCMake_TEST_FAILED "Test.xml does not report ${name} as ${status}")
+      return()
+    endif()
+  endforeach()
+else()
+  set(RunCMake_TEST_FAILED "Test.xml not found")
+endif()
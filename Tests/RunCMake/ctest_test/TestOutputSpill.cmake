@@ -0,0 +1,8 @@
+foreach(i RANGE 1 200)
+  message("SpillLine${i}")
+endforeach()
+string(REPEAT "." 80 pad)
+foreach(i RANGE 1 100)
+  message("${pad}")
+endforeach()
+message("SpillEnd")
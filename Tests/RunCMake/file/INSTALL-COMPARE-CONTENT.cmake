@@ -0,0 +1,35 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+file(REMOVE_RECURSE ${src} ${dst})
+file(WRITE ${src}/same.txt "same\n")
+file(WRITE ${src}/changed.txt "changed\n")
+file(WRITE ${src}/edited.txt "edited\n")
+file(WRITE ${src}/install.cmake "
+set(CMAKE_INSTALL_HASH_MANIFEST \"${CMAKE_CURRENT_BINARY_DIR}/hashes.txt\")
+file(INSTALL \"${src}/same.txt\" \"${src}/changed.txt\" \"${src}/edited.txt\"
+  DESTINATION \"${dst}\")
+")
+
+set(ENV{CMAKE_INSTALL_COMPARE} CONTENT)
+message(STATUS "First Install")
+execute_process(COMMAND ${CMAKE_COMMAND} -P ${src}/install.cmake)
+
+# Rewrite the sources a second later, but change only one of them.
+# Change one installed file instead.
+file(APPEND ${dst}/edited.txt "locally\n")
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.1)
+file(WRITE ${src}/same.txt "same\n")
+file(WRITE ${src}/changed.txt "changed again\n")
+file(WRITE ${src}/edited.txt "edited\n")
+message(STATUS "Second Install")
+execute_process(COMMAND ${CMAKE_COMMAND} -P ${src}/install.cmake)
+unset(ENV{CMAKE_INSTALL_COMPARE})
+
+file(READ ${dst}/changed.txt changed)
+if(NOT changed STREQUAL "changed again\n")
+  message(SEND_ERROR "changed.txt was not installed again:\n${changed}")
+endif()
+file(READ ${dst}/edited.txt edited)
+if(NOT edited STREQUAL "edited\n")
+  message(SEND_ERROR "edited.txt was not installed again:\n${edited}")
+endif()
@@ -0,0 +1,45 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+set(hashes ${CMAKE_CURRENT_BINARY_DIR}/hashes.txt)
+file(REMOVE_RECURSE ${src} ${dst} ${hashes})
+file(WRITE ${src}/kept.txt "kept\n")
+file(WRITE ${src}/dropped.txt "dropped\n")
+file(WRITE ${src}/install-kept-dropped.cmake "
+set(CMAKE_INSTALL_HASH_MANIFEST \"${hashes}\")
+file(INSTALL \"${src}/kept.txt\" \"${src}/dropped.txt\"
+  DESTINATION \"${dst}\")
+")
+file(WRITE ${src}/install-kept.cmake "
+set(CMAKE_INSTALL_HASH_MANIFEST \"${hashes}\")
+file(INSTALL \"${src}/kept.txt\" DESTINATION \"${dst}\")
+")
+
+function(check_manifest when expect)
+  file(READ ${hashes} content)
+  foreach(f IN ITEMS kept dropped)
+    if("${content}" MATCHES "/dst/${f}\\.txt\t")
+      set(has_${f} 1)
+    else()
+      set(has_${f} 0)
+    endif()
+  endforeach()
+  if(NOT "${has_kept}${has_dropped}" STREQUAL "${expect}")
+    message(SEND_ERROR "Manifest ${when} has wrong entries:\n${content}")
+  endif()
+endfunction()
+
+set(ENV{CMAKE_INSTALL_COMPARE} CONTENT)
+execute_process(COMMAND ${CMAKE_COMMAND} -P ${src}/install-kept-dropped.cmake
+  OUTPUT_QUIET)
+check_manifest("after installing both files" 11)
+
+# Installing one component keeps the entries of other files.
+execute_process(COMMAND ${CMAKE_COMMAND} -DCMAKE_INSTALL_COMPONENT=kept
+  -P ${src}/install-kept.cmake OUTPUT_QUIET)
+check_manifest("after installing one component" 11)
+
+# A full installation removes the entries of files it does not install.
+execute_process(COMMAND ${CMAKE_COMMAND} -P ${src}/install-kept.cmake
+  OUTPUT_QUIET)
+check_manifest("after a full installation" 10)
+unset(ENV{CMAKE_INSTALL_COMPARE})
@@ -0,0 +1,2 @@
+set(ENV{CMAKE_INSTALL_COMPARE} HASH)
+file(INSTALL DESTINATION dir)
@@ -0,0 +1,27 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+file(REMOVE_RECURSE ${src} ${dst})
+file(WRITE ${src}/linked.txt "linked\n")
+file(WRITE ${src}/copied.txt "copied\n")
+file(CHMOD ${src}/linked.txt ${src}/copied.txt
+  PERMISSIONS OWNER_READ OWNER_WRITE GROUP_READ WORLD_READ)
+
+set(ENV{CMAKE_INSTALL_MODE} HARDLINK_OR_COPY)
+message(STATUS "Before Installing")
+file(INSTALL ${src}/linked.txt DESTINATION ${dst})
+file(INSTALL ${src}/copied.txt DESTINATION ${dst}
+  PERMISSIONS OWNER_READ OWNER_WRITE)
+file(APPEND ${src}/linked.txt "changed\n")
+file(APPEND ${src}/copied.txt "changed\n")
+file(INSTALL ${src}/linked.txt DESTINATION ${dst})
+message(STATUS "After Installing")
+unset(ENV{CMAKE_INSTALL_MODE})
+
+file(READ ${dst}/linked.txt linked)
+if(NOT linked STREQUAL "linked\nchanged\n")
+  message(SEND_ERROR "linked.txt was not linked:\n${linked}")
+endif()
+file(READ ${dst}/copied.txt copied)
+if(NOT copied STREQUAL "copied\n")
+  message(SEND_ERROR "copied.txt was not copied:\n${copied}")
+endif()
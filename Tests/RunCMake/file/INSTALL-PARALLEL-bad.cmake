@@ -0,0 +1,12 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+file(REMOVE_RECURSE ${src} ${dst})
+file(WRITE ${src}/a.txt "a\n")
+file(WRITE ${src}/b.txt "b\n")
+file(WRITE ${src}/c.txt "c\n")
+# A directory in place of b.txt makes its copy fail.
+file(MAKE_DIRECTORY ${dst}/b.txt/keep)
+
+set(ENV{CMAKE_INSTALL_ALWAYS} 1)
+set(CMAKE_INSTALL_PARALLEL_LEVEL 4)
+file(INSTALL ${src}/a.txt ${src}/b.txt ${src}/c.txt DESTINATION ${dst})
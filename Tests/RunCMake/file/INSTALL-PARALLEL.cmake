@@ -0,0 +1,23 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+file(REMOVE_RECURSE ${src} ${dst})
+foreach(i RANGE 1 9)
+  file(WRITE ${src}/dir/file${i}.txt "file ${i}\n")
+endforeach()
+file(WRITE ${src}/single.txt "single\n")
+
+set(CMAKE_INSTALL_PARALLEL_LEVEL 4)
+message(STATUS "Before Installing")
+file(INSTALL ${src}/single.txt DESTINATION ${dst})
+file(INSTALL ${src}/dir DESTINATION ${dst}
+  DIRECTORY_PERMISSIONS OWNER_READ OWNER_EXECUTE)
+message(STATUS "After Installing")
+unset(CMAKE_INSTALL_PARALLEL_LEVEL)
+
+foreach(i RANGE 1 9)
+  file(READ ${dst}/dir/file${i}.txt content)
+  if(NOT content STREQUAL "file ${i}\n")
+    message(SEND_ERROR "file${i}.txt was not installed:\n${content}")
+  endif()
+endforeach()
+file(CHMOD ${dst}/dir DIRECTORY_PERMISSIONS OWNER_READ OWNER_WRITE OWNER_EXECUTE)
@@ -21,10 +21,16 @@ run_cmake(UPLOAD-netrc-bad)
 run_cmake(UPLOAD-tls-cainfo-not-set)
 run_cmake(UPLOAD-tls-verify-not-set)
 run_cmake(UPLOAD-pass-not-set)
+run_cmake(INSTALL-COMPARE-CONTENT)
+run_cmake(INSTALL-COMPARE-PRUNE)
+run_cmake(INSTALL-COMPARE-bad)
 run_cmake(INSTALL-DIRECTORY)
 run_cmake(INSTALL-FILES_FROM_DIR)
 run_cmake(INSTALL-FILES_FROM_DIR-bad)
 run_cmake(INSTALL-MESSAGE-bad)
+run_cmake(INSTALL-MODE-bad)
+run_cmake(INSTALL-PARALLEL)
+run_cmake(INSTALL-PARALLEL-bad)
 run_cmake(FileOpenFailRead)
 run_cmake(LOCK)
 run_cmake(LOCK-error-file-create-fail)
@@ -96,6 +102,7 @@ if(NOT WIN32 OR CYGWIN)
   run_cmake(READ_SYMLINK-noexist)
   run_cmake(READ_SYMLINK-notsymlink)
   run_cmake(INSTALL-FOLLOW_SYMLINK_CHAIN)
+  run_cmake(INSTALL-HARDLINK)
   run_cmake(REAL_PATH-unexpected-arg)
   run_cmake(REAL_PATH-no-base-dir)
   run_cmake(REAL_PATH)
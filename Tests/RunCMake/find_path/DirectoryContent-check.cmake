@@ -0,0 +1,9 @@
+set(content_file "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/CMakeDirectoryContent.txt")
+if(NOT EXISTS "${content_file}")
+  set(RunCMake_TEST_FAILED "Directory content not stored in\n  ${content_file}")
+  return()
+endif()
+file(READ "${content_file}" content)
+if(NOT content MATCHES "[0-9]+ [^\n]*/DirectoryContent-build/include\n")
+  set(RunCMake_TEST_FAILED "Searched directory not stored:\n${content}")
+endif()
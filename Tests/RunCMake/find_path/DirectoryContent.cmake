@@ -0,0 +1,6 @@
+find_path(DirectoryContent_PATH
+  NAMES DirectoryContent.h
+  PATHS ${CMAKE_BINARY_DIR}/include
+  NO_DEFAULT_PATH
+  )
+message(STATUS "DirectoryContent_PATH='${DirectoryContent_PATH}'")
@@ -0,0 +1 @@
+include(DirectoryContent.cmake)
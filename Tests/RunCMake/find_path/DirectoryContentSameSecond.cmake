@@ -0,0 +1,14 @@
+# A file created in the same second as the directory listing was taken
+# does not change the directory time stamp, but must still be found.
+set(dir "${CMAKE_CURRENT_BINARY_DIR}/same-second")
+file(WRITE "${dir}/a.h" "")
+find_path(SameSecond_A NAMES a.h PATHS "${dir}" NO_DEFAULT_PATH)
+file(WRITE "${dir}/b.h" "")
+find_path(SameSecond_B NAMES b.h PATHS "${dir}" NO_DEFAULT_PATH)
+foreach(v SameSecond_A SameSecond_B)
+  if("${${v}}" STREQUAL "${dir}")
+    message(STATUS "${v}=found")
+  else()
+    message(STATUS "${v}='${${v}}'")
+  endif()
+endforeach()
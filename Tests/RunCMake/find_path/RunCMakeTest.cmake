@@ -4,7 +4,23 @@ run_cmake(EmptyOldStyle)
 run_cmake(FromPATHEnv)
 run_cmake(PrefixInPATH)
 run_cmake(Required)
+run_cmake(DirectoryContentSameSecond)
 
 if(APPLE)
   run_cmake(FrameworksWithSubdirs)
 endif()
+
+if(CMAKE_HOST_UNIX AND NOT CMAKE_HOST_APPLE AND NOT CYGWIN)
+  function(run_DirectoryContent)
+    set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DirectoryContent-build)
+    set(RunCMake_TEST_NO_CLEAN 1)
+    file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+    file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}/include")
+    # Listings are kept only for directories not modified very recently.
+    execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 2)
+    run_cmake(DirectoryContent)
+    file(WRITE "${RunCMake_TEST_BINARY_DIR}/include/DirectoryContent.h" "")
+    run_cmake(DirectoryContentRerun)
+  endfunction()
+  run_DirectoryContent()
+endif()
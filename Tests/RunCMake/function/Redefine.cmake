@@ -0,0 +1,39 @@
+# A function or macro that redefines itself finishes its running body,
+# and later calls run the new definition.  The arguments of the outer
+# macro are substituted into the body of the inner one.
+function(redefine_function)
+  function(redefine_function)
+    set(calls "${calls};second" PARENT_SCOPE)
+  endfunction()
+  set(calls "${calls};first" PARENT_SCOPE)
+endfunction()
+
+macro(redefine_macro value)
+  macro(redefine_macro value)
+    list(APPEND calls "second_macro_${value}")
+  endmacro()
+  list(APPEND calls "first_macro_${value}")
+endmacro()
+
+set(calls)
+redefine_function()
+redefine_function()
+redefine_macro(a)
+redefine_macro(b)
+if(NOT calls STREQUAL ";first;second;first_macro_a;second_macro_a")
+  message(SEND_ERROR "Unexpected calls: ${calls}")
+endif()
+
+# A function records where it was defined, also when called from
+# another file.
+set(before_where ${CMAKE_CURRENT_LIST_LINE})
+function(where)
+  set(dir "${CMAKE_CURRENT_FUNCTION_LIST_DIR}" PARENT_SCOPE)
+  set(line "${CMAKE_CURRENT_FUNCTION_LIST_LINE}" PARENT_SCOPE)
+endfunction()
+math(EXPR line_of_where "${before_where} + 1")
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/call/where.cmake" "where()\n")
+include("${CMAKE_CURRENT_BINARY_DIR}/call/where.cmake")
+if(NOT dir STREQUAL CMAKE_CURRENT_LIST_DIR OR NOT line EQUAL line_of_where)
+  message(SEND_ERROR "where() reports ${dir}:${line}")
+endif()
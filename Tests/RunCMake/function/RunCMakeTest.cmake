@@ -1,3 +1,4 @@
 include(RunCMake)
 
 run_cmake(CMAKE_CURRENT_FUNCTION)
+run_cmake(Redefine)
@@ -0,0 +1,54 @@
+cmake_policy(SET CMP0054 NEW)
+
+# Numeric comparisons accept what sscanf("%lg") accepts: a leading
+# number, possibly followed by other text.  Runtime libraries differ on
+# hexadecimal, so "0x10" is only checked to be less than 17.
+foreach(case IN ITEMS
+    "1 EQUAL 1.0 TRUE"
+    "10 GREATER 9 TRUE"
+    "-2 LESS -1 TRUE"
+    "1e3 EQUAL 1000 TRUE"
+    "1.5E-1 EQUAL 0.15 TRUE"
+    "+7 EQUAL 7 TRUE"
+    "0x10 LESS 17 TRUE"
+    ".5 EQUAL 0.5 TRUE"
+    "2. EQUAL 2 TRUE"
+    "12abc EQUAL 12 TRUE"
+    "3.5.1 EQUAL 3.5 TRUE"
+    "abc EQUAL 0 FALSE"
+    "abc LESS 1 FALSE"
+    "1 LESS_EQUAL 1 TRUE"
+    "2 GREATER_EQUAL 3 FALSE"
+    )
+  string(REPLACE " " ";" case "${case}")
+  list(GET case 0 lhs)
+  list(GET case 1 op)
+  list(GET case 2 rhs)
+  list(GET case 3 expected)
+  if("${lhs}" ${op} "${rhs}")
+    set(actual TRUE)
+  else()
+    set(actual FALSE)
+  endif()
+  if(NOT actual STREQUAL expected)
+    message(SEND_ERROR "\"${lhs}\" ${op} \"${rhs}\" is ${actual}")
+  endif()
+endforeach()
+
+# Leading white space is skipped and an empty operand is not a number.
+if(NOT " 5" EQUAL 5)
+  message(SEND_ERROR "\" 5\" EQUAL 5 is FALSE")
+endif()
+if("" EQUAL 0)
+  message(SEND_ERROR "\"\" EQUAL 0 is TRUE")
+endif()
+
+# Compound conditions.
+set(seven 7)
+if(NOT (seven GREATER 5 AND seven LESS 10 AND NOT seven EQUAL 8))
+  message(SEND_ERROR "Compound condition on 7 is FALSE")
+endif()
+if((seven LESS 5 OR seven GREATER 6) AND (NOT seven STREQUAL "x"))
+else()
+  message(SEND_ERROR "Grouped condition on 7 is FALSE")
+endif()
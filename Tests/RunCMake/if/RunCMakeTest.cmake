@@ -13,3 +13,5 @@ run_cmake(MatchesSelf)
 
 run_cmake(TestNameThatExists)
 run_cmake(TestNameThatDoesNotExist)
+
+run_cmake(NumericOperands)
@@ -0,0 +1,108 @@
+cmake_policy(SET CMP0054 NEW)
+
+function(assert_list list_var expected)
+  if(NOT "${${list_var}}" STREQUAL "${expected}")
+    message(FATAL_ERROR "${list_var} is `${${list_var}}`, expected `${expected}`")
+  endif()
+endfunction()
+
+function(assert_length list_var expected)
+  list(LENGTH ${list_var} length)
+  if(NOT length EQUAL expected)
+    message(FATAL_ERROR "${list_var} has ${length} elements, expected ${expected}")
+  endif()
+endfunction()
+
+# Build a list and query it between appends.
+set(list)
+foreach(i RANGE 99)
+  list(APPEND list "item_${i}")
+  list(LENGTH list length)
+  math(EXPR expected "${i} + 1")
+  if(NOT length EQUAL expected)
+    message(FATAL_ERROR "list has ${length} elements after ${expected} appends")
+  endif()
+  list(GET list ${i} item)
+  if(NOT item STREQUAL "item_${i}")
+    message(FATAL_ERROR "list element ${i} is `${item}`")
+  endif()
+endforeach()
+list(GET list 0 50 -1 items)
+assert_list(items "item_0;item_50;item_99")
+list(FIND list "item_99" index)
+if(NOT index EQUAL 99)
+  message(FATAL_ERROR "list(FIND) returned ${index} instead of 99")
+endif()
+set(count 0)
+foreach(item IN LISTS list)
+  math(EXPR count "${count} + 1")
+endforeach()
+if(NOT count EQUAL 100)
+  message(FATAL_ERROR "foreach(IN LISTS) visited ${count} elements")
+endif()
+
+# A copy of the value does not change when the list is appended to.
+set(list a b)
+list(LENGTH list length)
+set(copy "${list}")
+list(APPEND list c)
+assert_list(copy "a;b")
+assert_list(list "a;b;c")
+assert_length(copy 2)
+assert_length(list 3)
+
+# Appending in a function does not change the list of the caller.
+function(append_in_function)
+  list(APPEND list d)
+  assert_list(list "a;b;c;d")
+  assert_length(list 4)
+  list(GET list -1 last)
+  assert_list(last "d")
+  set(list "${list}" PARENT_SCOPE)
+endfunction()
+append_in_function()
+assert_list(list "a;b;c;d")
+assert_length(list 4)
+set(list a b c)
+list(LENGTH list length)
+function(append_only_in_function)
+  list(APPEND list d)
+  assert_length(list 4)
+endfunction()
+append_only_in_function()
+assert_list(list "a;b;c")
+assert_length(list 3)
+
+# Empty elements.
+set(list a)
+list(LENGTH list length)
+list(APPEND list "")
+assert_list(list "a;")
+assert_length(list 2)
+list(APPEND list "" b)
+assert_list(list "a;;;b")
+assert_length(list 4)
+list(GET list 3 item)
+assert_list(item "b")
+
+# Values whose elements need unescaping.
+set(list "a;[b;c];d")
+assert_length(list 3)
+list(APPEND list e)
+assert_length(list 4)
+list(GET list 1 item)
+assert_list(item "[b;c]")
+set(list "a\;b")
+assert_length(list 1)
+list(APPEND list c)
+assert_length(list 2)
+list(GET list 0 item)
+assert_list(item "a;b")
+
+# A cache entry is the initial value of the normal variable.
+set(cached "x;y" CACHE STRING "")
+list(APPEND cached z)
+assert_list(cached "x;y;z")
+assert_length(cached 3)
+unset(cached)
+assert_list(cached "x;y")
@@ -0,0 +1,87 @@
+cmake_policy(SET CMP0054 NEW)
+cmake_policy(SET CMP0057 NEW)
+
+# Look up variables defined several scopes away, or not at all, while
+# the scopes in between change them.
+
+function(check var expected)
+  if(NOT DEFINED ${var})
+    set(actual "<undefined>")
+  else()
+    set(actual "${${var}}")
+  endif()
+  if(NOT actual STREQUAL expected)
+    message(SEND_ERROR "${where}: ${var} is `${actual}`, expected `${expected}`")
+  endif()
+endfunction()
+
+function(nested level last)
+  if(level LESS last)
+    math(EXPR next "${level} + 1")
+    nested(${next} ${last} ${ARGN})
+  else()
+    cmake_language(CALL ${ARGN})
+  endif()
+endfunction()
+
+set(far "top")
+set(gone "top")
+
+# Read a far variable, then raise a new value to the parent scope.
+function(raise)
+  set(where raise)
+  check(far "top")
+  check(missing "<undefined>")
+  set(far "raised" PARENT_SCOPE)
+  set(missing "raised" PARENT_SCOPE)
+  check(far "top")
+  check(missing "<undefined>")
+  set(missing "local")
+  check(missing "local")
+  unset(missing)
+  check(missing "<undefined>")
+  unset(far)
+  check(far "<undefined>")
+endfunction()
+
+function(outer)
+  set(where outer)
+  nested(1 5 raise)
+  check(far "top")
+  check(missing "<undefined>")
+  nested(1 4 raise)
+  check(far "top")
+
+  # A new inner scope sees the definitions of its parents now.
+  set(far "outer")
+  unset(gone)
+  set(missing "outer")
+  nested(1 5 read)
+endfunction()
+
+function(read)
+  set(where read)
+  check(far "outer")
+  check(gone "<undefined>")
+  check(missing "outer")
+  get_cmake_property(vars VARIABLES)
+  if(NOT "far" IN_LIST vars OR "gone" IN_LIST vars)
+    message(SEND_ERROR "read: VARIABLES lists wrong variables")
+  endif()
+endfunction()
+
+outer()
+set(where top)
+check(far "top")
+check(gone "top")
+check(missing "<undefined>")
+
+# Lookups from the same deep scope before and after a cache entry is
+# created.
+function(cached)
+  set(where cached)
+  check(from_cache "<undefined>")
+  set(from_cache "cache" CACHE STRING "")
+  check(from_cache "cache")
+endfunction()
+nested(1 5 cached)
@@ -3,5 +3,6 @@ include(RunCMake)
 run_cmake(ParentScope)
 run_cmake(ParentPulling)
 run_cmake(ParentPullingRecursive)
+run_cmake(NestedScopeLookup)
 run_cmake(UnknownCacheType)
 run_cmake(ExtraEnvValue)
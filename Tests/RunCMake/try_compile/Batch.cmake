@@ -0,0 +1,42 @@
+enable_language(C)
+
+try_compile_batch(BEGIN)
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  COPY_FILE_ERROR copy_err
+  )
+# Check modules reuse one source file in the shared directory.
+set(tmp "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp")
+file(WRITE "${tmp}/src.c" "int main(void) { return 0; }\n")
+try_compile(SHARED_RESULT ${CMAKE_CURRENT_BINARY_DIR} ${tmp}/src.c)
+file(WRITE "${tmp}/src.c" "does-not-compile\n")
+try_compile(FAIL_RESULT ${CMAKE_CURRENT_BINARY_DIR} ${tmp}/src.c
+  OUTPUT_VARIABLE fail_out
+  )
+foreach(v IN ITEMS RESULT SHARED_RESULT FAIL_RESULT out fail_out copy_err)
+  if(DEFINED ${v})
+    message(SEND_ERROR "${v} defined before the end of the batch")
+  endif()
+endforeach()
+try_compile_batch(END PARALLEL_LEVEL 2)
+
+message(STATUS "RESULT=${RESULT}")
+message(STATUS "SHARED_RESULT=${SHARED_RESULT}")
+message(STATUS "FAIL_RESULT=${FAIL_RESULT}")
+if(NOT EXISTS "${CMAKE_CURRENT_BINARY_DIR}/copy")
+  message(SEND_ERROR "COPY_FILE not created")
+endif()
+if(NOT copy_err STREQUAL "")
+  message(SEND_ERROR "COPY_FILE_ERROR not empty:\n${copy_err}")
+endif()
+if(NOT out MATCHES "Change Dir: ")
+  message(SEND_ERROR "OUTPUT_VARIABLE not set:\n${out}")
+endif()
+if(NOT fail_out MATCHES "does-not-compile")
+  message(SEND_ERROR "OUTPUT_VARIABLE of failure not set:\n${fail_out}")
+endif()
+file(GLOB batch_dirs "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmpBatch*")
+if(batch_dirs)
+  message(SEND_ERROR "Batch directories not removed:\n ${batch_dirs}")
+endif()
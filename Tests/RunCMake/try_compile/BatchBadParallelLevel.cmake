@@ -0,0 +1,2 @@
+try_compile_batch(BEGIN)
+try_compile_batch(END PARALLEL_LEVEL 0)
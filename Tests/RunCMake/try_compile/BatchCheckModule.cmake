@@ -0,0 +1,59 @@
+enable_language(C)
+include(CheckCSourceCompiles)
+include(CheckIncludeFile)
+include(CheckSymbolExists)
+set(CMAKE_MODULE_PATH ${CMAKE_CURRENT_SOURCE_DIR})
+
+function(check_in_function)
+  try_compile(FUNCTION_RESULT ${CMAKE_CURRENT_BINARY_DIR}
+    ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    )
+  if(NOT FUNCTION_RESULT)
+    message(SEND_ERROR "try_compile in a function was deferred")
+  endif()
+endfunction()
+
+function(check_deferred_in_function)
+  set(CMAKE_TRY_COMPILE_BATCH_DEFER 1)
+  try_compile(DEFERRED_RESULT ${CMAKE_CURRENT_BINARY_DIR}
+    ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    )
+  if(DEFINED DEFERRED_RESULT)
+    message(SEND_ERROR "try_compile with CMAKE_TRY_COMPILE_BATCH_DEFER "
+      "was not deferred")
+  endif()
+endfunction()
+
+# Check modules report their results at the end of the batch.
+try_compile_batch(BEGIN)
+check_include_file(stdio.h HAVE_STDIO_H)
+check_include_file(does_not_exist.h HAVE_DOES_NOT_EXIST_H)
+check_symbol_exists(printf stdio.h HAVE_PRINTF)
+check_c_source_compiles("int main(void) { return 0; }" HAVE_SOURCE)
+set(CMAKE_REQUIRED_QUIET 1)
+check_include_file(stddef.h HAVE_STDDEF_H)
+unset(CMAKE_REQUIRED_QUIET)
+foreach(v IN ITEMS HAVE_STDIO_H HAVE_DOES_NOT_EXIST_H HAVE_PRINTF
+    HAVE_SOURCE HAVE_STDDEF_H)
+  if(DEFINED ${v})
+    message(SEND_ERROR "${v} defined before the end of the batch")
+  endif()
+endforeach()
+check_in_function()
+check_deferred_in_function()
+# Find modules use their results right away.
+find_package(BatchCheck REQUIRED)
+message(STATUS "End of batch")
+try_compile_batch(END)
+
+foreach(v IN ITEMS HAVE_STDIO_H HAVE_PRINTF HAVE_SOURCE HAVE_STDDEF_H)
+  if(NOT "${${v}}" STREQUAL "1" OR NOT "$CACHE{${v}}" STREQUAL "1")
+    message(SEND_ERROR "${v} is '${${v}}', not 1")
+  endif()
+endforeach()
+if(NOT "${HAVE_DOES_NOT_EXIST_H}" STREQUAL "")
+  message(SEND_ERROR "HAVE_DOES_NOT_EXIST_H is '${HAVE_DOES_NOT_EXIST_H}'")
+endif()
+if(NOT DEFERRED_RESULT)
+  message(SEND_ERROR "DEFERRED_RESULT not set at the end of the batch")
+endif()
@@ -0,0 +1,21 @@
+enable_language(C)
+
+function(report value)
+  if(NOT ARGC EQUAL 1)
+    message(SEND_ERROR "deferred call given ${ARGC} arguments")
+  endif()
+  message(STATUS "report ${value} RESULT=${RESULT}")
+  message(CHECK_PASS "done")
+endfunction()
+
+# A deferred call is made right away outside of a batch.
+message(CHECK_START "Checking outside of a batch")
+try_compile_batch(DEFER CALL report "now")
+
+# The arguments of a deferred call are not evaluated again.
+try_compile_batch(BEGIN)
+message(CHECK_START "Checking in a batch")
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c)
+try_compile_batch(DEFER MOVE_CHECK CALL report "\${RESULT};later")
+message(STATUS "End of batch")
+try_compile_batch(END)
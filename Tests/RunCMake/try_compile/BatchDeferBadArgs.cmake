@@ -0,0 +1,4 @@
+try_compile_batch(DEFER)
+try_compile_batch(DEFER MOVE_CHECK message)
+try_compile_batch(DEFER CALL)
+try_compile_batch(DEFER CALL endif)
@@ -0,0 +1,22 @@
+enable_language(C)
+
+try_compile_batch(BEGIN)
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  )
+# Results reused from the cache are set at the end of the batch too.
+foreach(v IN ITEMS RESULT out)
+  if(DEFINED ${v})
+    message(SEND_ERROR "${v} defined before the end of the batch")
+  endif()
+endforeach()
+try_compile_batch(END)
+
+message(STATUS "RESULT=${RESULT}")
+if(out MATCHES "ResultCacheMarker")
+  message(STATUS "out restored from cache")
+endif()
+if(NOT EXISTS "${CMAKE_CURRENT_BINARY_DIR}/copy")
+  message(SEND_ERROR "COPY_FILE not created")
+endif()
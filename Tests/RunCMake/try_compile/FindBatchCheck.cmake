@@ -0,0 +1,6 @@
+include(CheckIncludeFile)
+check_include_file(stdlib.h BATCH_CHECK_STDLIB_H)
+if(NOT BATCH_CHECK_STDLIB_H)
+  message(SEND_ERROR "check_include_file was deferred in a find module")
+endif()
+set(BatchCheck_FOUND 1)
@@ -0,0 +1,26 @@
+enable_language(C)
+
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  )
+# Use the location of check module sources, shared by all build trees.
+set(tmp "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp")
+file(WRITE "${tmp}/fail.c" "does-not-compile\n")
+try_compile(FAIL_RESULT ${CMAKE_CURRENT_BINARY_DIR} ${tmp}/fail.c
+  OUTPUT_VARIABLE fail_out
+  )
+
+message(STATUS "RESULT=${RESULT}")
+message(STATUS "FAIL_RESULT=${FAIL_RESULT}")
+if(NOT EXISTS "${CMAKE_CURRENT_BINARY_DIR}/copy")
+  message(SEND_ERROR "COPY_FILE not created")
+endif()
+foreach(v IN ITEMS out fail_out)
+  if(${v} MATCHES "ResultCacheMarker")
+    message(STATUS "${v} restored from cache")
+  endif()
+  if(${v} MATCHES "<BINARY_DIR>|<TARGET_NAME>")
+    message(SEND_ERROR "${v} has placeholders:\n${${v}}")
+  endif()
+endforeach()
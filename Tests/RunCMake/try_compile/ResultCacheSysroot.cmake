@@ -0,0 +1,4 @@
+# A different sysroot must not reuse the cached results.
+set(CMAKE_SYSROOT_COMPILE ${CMAKE_CURRENT_BINARY_DIR}/sysroot)
+file(MAKE_DIRECTORY ${CMAKE_SYSROOT_COMPILE})
+include(${CMAKE_CURRENT_LIST_DIR}/ResultCache.cmake)
@@ -112,6 +112,39 @@ if(RunCMake_GENERATOR MATCHES "Make|Ninja")
   unset(RunCMake_TEST_NO_CLEAN)
 endif()
 
+function(run_ResultCache)
+  set(cache_dir ${RunCMake_BINARY_DIR}/ResultCache-cache)
+  file(REMOVE_RECURSE "${cache_dir}")
+  set(RunCMake_TEST_OPTIONS -DCMAKE_TRY_COMPILE_CACHE_DIR=${cache_dir})
+  run_cmake(ResultCache)
+  # Only successful results are stored.
+  file(GLOB results "${cache_dir}/*/result.txt")
+  foreach(result IN LISTS results)
+    file(READ "${result}" value)
+    if(NOT value STREQUAL "0")
+      message(SEND_ERROR "Failed result cached in:\n ${result}")
+    endif()
+  endforeach()
+  # Mark the cached results to recognize them in another build tree.
+  file(GLOB outputs "${cache_dir}/*/output.txt")
+  foreach(output IN LISTS outputs)
+    file(APPEND "${output}" "ResultCacheMarker\n")
+  endforeach()
+  run_cmake(ResultCacheReuse)
+  run_cmake(ResultCacheSysroot)
+  run_cmake(BatchResultCache)
+endfunction()
+run_ResultCache()
+
+run_cmake(Batch)
+run_cmake(BatchCheckModule)
+run_cmake(BatchDefer)
+run_cmake(BatchDeferBadArgs)
+run_cmake(BatchNoEnd)
+run_cmake(BatchNested)
+run_cmake(BatchEndNoBegin)
+run_cmake(BatchBadParallelLevel)
+
 if(UNIX)
   run_cmake(CleanupNoFollowSymlink)
 endif()
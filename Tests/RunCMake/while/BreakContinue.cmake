@@ -0,0 +1,31 @@
+cmake_policy(SET CMP0054 NEW)
+
+# Skip odd numbers and stop after 10 in nested loops.
+set(seen)
+set(i 0)
+while(i LESS 100)
+  math(EXPR i "${i} + 1")
+  if(i GREATER 10)
+    break()
+  endif()
+  math(EXPR odd "${i} % 2")
+  if(odd)
+    continue()
+  endif()
+  set(j 0)
+  while(TRUE)
+    math(EXPR j "${j} + 1")
+    if(j EQUAL 2)
+      continue()
+    elseif(j GREATER 3)
+      break()
+    endif()
+    list(APPEND seen "${i}.${j}")
+  endwhile()
+endwhile()
+if(NOT seen STREQUAL "2.1;2.3;4.1;4.3;6.1;6.3;8.1;8.3;10.1;10.3")
+  message(SEND_ERROR "Unexpected iterations: ${seen}")
+endif()
+if(NOT i EQUAL 11)
+  message(SEND_ERROR "Loop stopped at ${i}")
+endif()
@@ -5,3 +5,4 @@ run_cmake(EndMissing)
 run_cmake(EndMismatch)
 run_cmake(EndAlone)
 run_cmake(EndAloneArgs)
+run_cmake(BreakContinue)